@@ -0,0 +1,29 @@
+// EyeTrackingCore.Build.cs
+
+using UnrealBuildTool;
+
+public class EyeTrackingCore : ModuleRules
+{
+	public EyeTrackingCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core",
+                "CoreUObject",
+                "Engine"
+            }
+        );
+
+        // The PICO runtime only ships for Win64 and Android. Everywhere else (headless Linux builds included)
+        // the service is driven by the synthetic or file-backed sources instead.
+        bool bWithPicoXR = Target.Platform == UnrealTargetPlatform.Win64 || Target.Platform == UnrealTargetPlatform.Android;
+        if (bWithPicoXR)
+        {
+            PrivateDependencyModuleNames.Add("PICOXRMotionTracking");
+        }
+        PublicDefinitions.Add("WITH_PICOXR=" + (bWithPicoXR ? "1" : "0"));
+    }
+}
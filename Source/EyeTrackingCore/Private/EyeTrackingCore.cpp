@@ -0,0 +1,19 @@
+// Copyright University of Nevada, Reno. All rights reserved.
+
+#include "EyeTrackingCore.h"
+
+#define LOCTEXT_NAMESPACE "FEyeTrackingCoreModule"
+
+void FEyeTrackingCoreModule::StartupModule()
+{
+
+}
+
+void FEyeTrackingCoreModule::ShutdownModule()
+{
+
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE( FEyeTrackingCoreModule, EyeTrackingCore );
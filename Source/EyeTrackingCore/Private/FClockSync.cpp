@@ -0,0 +1,166 @@
+// FClockSync.cpp
+
+#include "FClockSync.h"
+
+FClockSync::FClockSync(const FClockSyncSettings& InSettings)
+    : Settings(InSettings)
+{
+    Settings.MaxWindows = FMath::Max(Settings.MaxWindows, 2);
+    Settings.MinWindowsForFit = FMath::Clamp(Settings.MinWindowsForFit, 2, Settings.MaxWindows);
+    Windows.Reserve(Settings.MaxWindows);
+}
+
+void FClockSync::Reset()
+{
+    bHasOrigin = false;
+    Windows.Reset();
+    NextWindow = 0;
+    bHasFit = false;
+}
+
+void FClockSync::AddObservation(int64 DeviceNanoseconds, double HostSeconds)
+{
+    if (!bHasOrigin)
+    {
+        bHasOrigin = true;
+        DeviceOrigin = DeviceNanoseconds;
+        WindowStartSeconds = 0.0;
+        WindowMinimum = {0.0, HostSeconds};
+        MinOffsetSeconds = MaxOffsetSeconds = HostSeconds;
+        return;
+    }
+
+    const double DeviceSeconds = ToDeviceSeconds(DeviceNanoseconds);
+    const double OffsetSeconds = HostSeconds - DeviceSeconds;
+
+    // Arriving before the device says it was taken is impossible unless the device clock jumped
+    if (bHasFit && OffsetSeconds < PredictOffset(DeviceSeconds) - Settings.ResetThresholdSeconds)
+    {
+        Reset();
+        AddObservation(DeviceNanoseconds, HostSeconds);
+        return;
+    }
+
+    if (DeviceSeconds - WindowStartSeconds >= Settings.WindowSeconds)
+    {
+        CloseWindow();
+        if (!bHasOrigin)
+        {
+            // The closed window showed a jump and the estimate restarted
+            AddObservation(DeviceNanoseconds, HostSeconds);
+            return;
+        }
+        WindowStartSeconds = DeviceSeconds;
+        WindowMinimum = {DeviceSeconds, OffsetSeconds};
+    }
+    else if (OffsetSeconds < WindowMinimum.OffsetSeconds)
+    {
+        WindowMinimum = {DeviceSeconds, OffsetSeconds};
+    }
+
+    MinOffsetSeconds = FMath::Min(MinOffsetSeconds, OffsetSeconds);
+    MaxOffsetSeconds = FMath::Max(MaxOffsetSeconds, OffsetSeconds);
+}
+
+double FClockSync::DeviceToHost(int64 DeviceNanoseconds) const
+{
+    const double DeviceSeconds = ToDeviceSeconds(DeviceNanoseconds);
+    if (bHasFit)
+    {
+        return DeviceSeconds + PredictOffset(DeviceSeconds);
+    }
+
+    // Before the fit, the least-delayed observation so far is the best offset there is
+    return DeviceSeconds + MinOffsetSeconds;
+}
+
+double FClockSync::GetErrorSeconds() const
+{
+    return bHasFit ? FitResidualSeconds : MaxOffsetSeconds - MinOffsetSeconds;
+}
+
+FClockSyncEstimate FClockSync::GetEstimate() const
+{
+    FClockSyncEstimate Estimate;
+    if (!bHasOrigin)
+    {
+        return Estimate;
+    }
+
+    // Offsets are kept against device time relative to the origin; report them against the raw device clock
+    const double OriginSeconds = static_cast<double>(DeviceOrigin) * 1.0e-9;
+    Estimate.OffsetSeconds = (bHasFit ? PredictOffset(WindowMinimum.DeviceSeconds) : MinOffsetSeconds) - OriginSeconds;
+    Estimate.DriftPpm = bHasFit ? FitSlope * 1.0e6 : 0.0;
+    Estimate.ErrorSeconds = GetErrorSeconds();
+    Estimate.NumWindows = Windows.Num() + 1;
+    return Estimate;
+}
+
+double FClockSync::PredictOffset(double DeviceSeconds) const
+{
+    return FitIntercept + FitSlope * (DeviceSeconds - FitMeanDevice);
+}
+
+void FClockSync::CloseWindow()
+{
+    // A window whose best sample is still far behind the fit means the device clock jumped backwards
+    if (bHasFit && WindowMinimum.OffsetSeconds > PredictOffset(WindowMinimum.DeviceSeconds) + Settings.ResetThresholdSeconds)
+    {
+        Reset();
+        return;
+    }
+
+    if (Windows.Num() < Settings.MaxWindows)
+    {
+        Windows.Add(WindowMinimum);
+    }
+    else
+    {
+        Windows[NextWindow] = WindowMinimum;
+    }
+    NextWindow = (NextWindow + 1) % Settings.MaxWindows;
+
+    if (Windows.Num() >= Settings.MinWindowsForFit)
+    {
+        Fit();
+    }
+}
+
+void FClockSync::Fit()
+{
+    // Least squares about the means, so the large absolute offsets do not cost precision
+    const int32 Count = Windows.Num();
+    double SumDevice = 0.0;
+    double SumOffset = 0.0;
+    for (const FWindowPoint& Point : Windows)
+    {
+        SumDevice += Point.DeviceSeconds;
+        SumOffset += Point.OffsetSeconds;
+    }
+    const double MeanDevice = SumDevice / Count;
+    const double MeanOffset = SumOffset / Count;
+
+    double Sxx = 0.0;
+    double Sxy = 0.0;
+    for (const FWindowPoint& Point : Windows)
+    {
+        const double Dx = Point.DeviceSeconds - MeanDevice;
+        Sxx += Dx * Dx;
+        Sxy += Dx * (Point.OffsetSeconds - MeanOffset);
+    }
+
+    FitMeanDevice = MeanDevice;
+    FitIntercept = MeanOffset;
+    FitSlope = Sxx > 0.0 ? Sxy / Sxx : 0.0;
+
+    double SumSquares = 0.0;
+    for (const FWindowPoint& Point : Windows)
+    {
+        const double Residual = Point.OffsetSeconds - PredictOffset(Point.DeviceSeconds);
+        SumSquares += Residual * Residual;
+    }
+
+    // Two parameters come from the points, so the scatter is over Count - 2 degrees of freedom
+    FitResidualSeconds = Count > 2 ? FMath::Sqrt(SumSquares / (Count - 2)) : 0.0;
+    bHasFit = true;
+}
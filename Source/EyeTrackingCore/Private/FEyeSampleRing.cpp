@@ -0,0 +1,96 @@
+// FEyeSampleRing.cpp
+
+#include "FEyeSampleRing.h"
+
+FEyeSampleRing::FEyeSampleRing(int32 InCapacity)
+{
+    const uint32 Capacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InCapacity, 2)));
+    Slots = MakeUnique<FSlot[]>(Capacity);
+    Mask = Capacity - 1;
+}
+
+void FEyeSampleRing::Publish(const FEyeTrackingSample& Sample)
+{
+    const uint64 SequenceNumber = PublishedCount.load(std::memory_order_relaxed);
+    FSlot& Slot = Slots[SequenceNumber & Mask];
+
+    // Mark the slot as being written before touching the sample, so a concurrent reader discards its copy
+    Slot.Version.store(2 * SequenceNumber + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Slot.Sample = Sample;
+    Slot.Sample.SequenceNumber = SequenceNumber;
+
+    Slot.Version.store(2 * SequenceNumber + 2, std::memory_order_release);
+    PublishedCount.store(SequenceNumber + 1, std::memory_order_release);
+}
+
+bool FEyeSampleRing::TryRead(uint64 SequenceNumber, FEyeTrackingSample& OutSample) const
+{
+    const FSlot& Slot = Slots[SequenceNumber & Mask];
+    const uint64 Expected = 2 * SequenceNumber + 2;
+
+    if (Slot.Version.load(std::memory_order_acquire) != Expected)
+    {
+        return false;
+    }
+
+    OutSample = Slot.Sample;
+
+    // The copy is only good if the writer did not start on the slot while it was being made
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return Slot.Version.load(std::memory_order_relaxed) == Expected;
+}
+
+FEyeTrackingReader::FEyeTrackingReader(TSharedRef<const FEyeSampleRing> InRing)
+    : Ring(InRing)
+    , Cursor(InRing->GetPublishedCount())
+{
+}
+
+int32 FEyeTrackingReader::ReadNew(TArray<FEyeTrackingSample>& OutSamples)
+{
+    if (!Ring.IsValid())
+    {
+        return 0;
+    }
+
+    const uint64 End = Ring->GetPublishedCount();
+    const uint64 Capacity = static_cast<uint64>(Ring->GetCapacity());
+
+    // Anything more than a ring behind has been overwritten already
+    if (End - Cursor > Capacity)
+    {
+        SkippedCount += End - Capacity - Cursor;
+        Cursor = End - Capacity;
+    }
+
+    const int32 FirstNew = OutSamples.Num();
+    OutSamples.Reserve(FirstNew + static_cast<int32>(End - Cursor));
+
+    FEyeTrackingSample Sample;
+    for (; Cursor < End; ++Cursor)
+    {
+        if (Ring->TryRead(Cursor, Sample))
+        {
+            OutSamples.Add(Sample);
+        }
+        else
+        {
+            ++SkippedCount;
+        }
+    }
+
+    return OutSamples.Num() - FirstNew;
+}
+
+bool FEyeTrackingReader::PeekLatest(FEyeTrackingSample& OutSample) const
+{
+    if (!Ring.IsValid())
+    {
+        return false;
+    }
+
+    const uint64 End = Ring->GetPublishedCount();
+    return End > 0 && Ring->TryRead(End - 1, OutSample);
+}
@@ -0,0 +1,129 @@
+// FEyeTrackingService.cpp
+
+#include "FEyeTrackingService.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+FEyeTrackingService::FEyeTrackingService(TUniquePtr<IEyeTrackingSource> InSource, TSharedRef<FEyeSampleRing> InRing)
+    : Source(MoveTemp(InSource))
+    , Ring(InRing)
+{
+    check(Source.IsValid());
+}
+
+FEyeTrackingService::~FEyeTrackingService()
+{
+    Shutdown();
+}
+
+bool FEyeTrackingService::Start()
+{
+    if (Thread)
+    {
+        return IsRunning();
+    }
+
+    if (!Source->Start())
+    {
+        return false;
+    }
+
+    bStopRequested.store(false, std::memory_order_relaxed);
+    bRunning.store(true, std::memory_order_release);
+    Thread = FRunnableThread::Create(this, TEXT("EyeTrackingService"), 0, TPri_AboveNormal);
+    if (!Thread)
+    {
+        bRunning.store(false, std::memory_order_release);
+        Source->Stop();
+        return false;
+    }
+    return true;
+}
+
+void FEyeTrackingService::Shutdown()
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    Stop();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+
+    Source->Stop();
+}
+
+uint32 FEyeTrackingService::Run()
+{
+    const float RateHz = Source->GetNativeRateHz();
+    const double Period = RateHz > 0.0f ? 1.0 / RateHz : 0.0;
+    double NextPollTime = FPlatformTime::Seconds();
+
+    FEyeTrackingSample Sample;
+    while (!bStopRequested.load(std::memory_order_relaxed))
+    {
+        if (Period > 0.0)
+        {
+            // Poll on a fixed schedule; after a stall, start again from now rather than bursting to catch up
+            const double Now = FPlatformTime::Seconds();
+            if (NextPollTime > Now)
+            {
+                FPlatformProcess::SleepNoStats(static_cast<float>(NextPollTime - Now));
+            }
+            NextPollTime = FMath::Max(NextPollTime + Period, Now);
+        }
+
+        const EEyeSourcePollResult Result = Source->Poll(Sample);
+        if (Result == EEyeSourcePollResult::Finished)
+        {
+            break;
+        }
+        if (Result == EEyeSourcePollResult::Sample)
+        {
+            StampSample(Sample, Period);
+            Ring->Publish(Sample);
+        }
+    }
+
+    bRunning.store(false, std::memory_order_release);
+    return 0;
+}
+
+FClockSyncEstimate FEyeTrackingService::GetClockEstimate() const
+{
+    FScopeLock Lock(&ClockEstimateLock);
+    return ClockEstimate;
+}
+
+void FEyeTrackingService::StampSample(FEyeTrackingSample& Sample, double Period)
+{
+    Sample.ReceivedTimeSeconds = FPlatformTime::Seconds();
+
+    // A free-running source is replaying faster than real time, so its device clock says nothing about the host's;
+    // a timestamp that does not advance is a repeated frame or a per-event stamp, not a per-sample clock
+    const bool bHasDeviceClock = Sample.DeviceTimestampNanoseconds > LastDeviceTimestamp && Period > 0.0;
+    LastDeviceTimestamp = FMath::Max(LastDeviceTimestamp, Sample.DeviceTimestampNanoseconds);
+    if (!bHasDeviceClock)
+    {
+        // Taken at most one polling period before it was read
+        Sample.HostTimeSeconds = Sample.ReceivedTimeSeconds;
+        Sample.TimeErrorSeconds = static_cast<float>(Period);
+        return;
+    }
+
+    ClockSync.AddObservation(Sample.DeviceTimestampNanoseconds, Sample.ReceivedTimeSeconds);
+    Sample.HostTimeSeconds = FMath::Min(ClockSync.DeviceToHost(Sample.DeviceTimestampNanoseconds), Sample.ReceivedTimeSeconds);
+    Sample.TimeErrorSeconds = static_cast<float>(ClockSync.GetErrorSeconds());
+
+    FScopeLock Lock(&ClockEstimateLock);
+    ClockEstimate = ClockSync.GetEstimate();
+}
+
+void FEyeTrackingService::Stop()
+{
+    bStopRequested.store(true, std::memory_order_relaxed);
+}
@@ -0,0 +1,111 @@
+// FFileEyeTrackingSource.cpp
+
+#include "FFileEyeTrackingSource.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+    // Column layout of the RAPD recordings
+    enum EColumn : int32
+    {
+        TimeStamp = 0,
+        PupilLeft = 2,
+        PupilRight = 4,
+        OriginX = 5,
+        DirectionX = 8,
+        OpennessLeft = 11,
+        OpennessRight = 12,
+        BlinkLeft = 13,
+        BlinkRight = 14,
+        MinColumns = 11
+    };
+}
+
+FFileEyeTrackingSource::FFileEyeTrackingSource(const FString& InFilePath, bool bInRealTime)
+    : FilePath(InFilePath)
+    , bRealTime(bInRealTime)
+{
+}
+
+bool FFileEyeTrackingSource::Start()
+{
+    Rows.Reset();
+    if (!FFileHelper::LoadFileToStringArray(Rows, *FilePath) || Rows.Num() < 2 || !Rows[0].StartsWith(TEXT("TimeStamp")))
+    {
+        Rows.Reset();
+        return false;
+    }
+
+    // Skip the header; the average spacing of the recorded times gives the real-time replay rate
+    NextRow = 1;
+    FEyeTrackingSample First, Last;
+    if (Rows.Num() > 2 && ParseRow(Rows[1], First) && ParseRow(Rows.Last(), Last) && Last.DeviceTimestampNanoseconds > First.DeviceTimestampNanoseconds)
+    {
+        RecordedRateHz = static_cast<float>((Rows.Num() - 2) * 1.0e9 / (Last.DeviceTimestampNanoseconds - First.DeviceTimestampNanoseconds));
+    }
+    else
+    {
+        RecordedRateHz = 0.0f;
+    }
+    return true;
+}
+
+void FFileEyeTrackingSource::Stop()
+{
+    Rows.Empty();
+}
+
+EEyeSourcePollResult FFileEyeTrackingSource::Poll(FEyeTrackingSample& OutSample)
+{
+    // Malformed rows (pauses without eye data, truncated lines) are skipped
+    while (NextRow < Rows.Num())
+    {
+        if (ParseRow(Rows[NextRow++], OutSample))
+        {
+            return EEyeSourcePollResult::Sample;
+        }
+    }
+    return EEyeSourcePollResult::Finished;
+}
+
+bool FFileEyeTrackingSource::ParseRow(const FString& Row, FEyeTrackingSample& OutSample)
+{
+    TArray<FString> Columns;
+    Row.ParseIntoArray(Columns, TEXT(","), false);
+    if (Columns.Num() < MinColumns || Columns[DirectionX].IsEmpty())
+    {
+        return false;
+    }
+
+    const FVector Origin(FCString::Atod(*Columns[OriginX]), FCString::Atod(*Columns[OriginX + 1]), FCString::Atod(*Columns[OriginX + 2]));
+    const FVector Direction = FVector(FCString::Atod(*Columns[DirectionX]), FCString::Atod(*Columns[DirectionX + 1]), FCString::Atod(*Columns[DirectionX + 2])).GetSafeNormal();
+
+    FEyeSampleEye& Combined = OutSample.GetEye(EEyeSampleEye::Combined);
+    Combined.Position = Origin;
+    Combined.Orientation = Direction.IsZero() ? FQuat::Identity : Direction.ToOrientationQuat();
+    Combined.bPoseValid = !Direction.IsZero();
+    Combined.PupilDiameter = 0.0f;
+
+    FEyeSampleEye& LeftEye = OutSample.GetEye(EEyeSampleEye::Left);
+    FEyeSampleEye& RightEye = OutSample.GetEye(EEyeSampleEye::Right);
+    LeftEye = Combined;
+    RightEye = Combined;
+    LeftEye.PupilDiameter = FCString::Atof(*Columns[PupilLeft]);
+    RightEye.PupilDiameter = FCString::Atof(*Columns[PupilRight]);
+
+    if (Columns.Num() > BlinkRight)
+    {
+        LeftEye.Openness = FCString::Atof(*Columns[OpennessLeft]);
+        RightEye.Openness = FCString::Atof(*Columns[OpennessRight]);
+        LeftEye.bBlink = Columns[BlinkLeft] == TEXT("Yes");
+        RightEye.bBlink = Columns[BlinkRight] == TEXT("Yes");
+    }
+    else
+    {
+        LeftEye.Openness = RightEye.Openness = 1.0f;
+        LeftEye.bBlink = RightEye.bBlink = false;
+    }
+
+    OutSample.DeviceTimestampNanoseconds = static_cast<int64>(FCString::Atod(*Columns[TimeStamp]) * 1.0e9);
+    return true;
+}
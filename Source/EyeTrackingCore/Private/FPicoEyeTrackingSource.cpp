@@ -0,0 +1,112 @@
+// FPicoEyeTrackingSource.cpp
+
+#include "FPicoEyeTrackingSource.h"
+
+#if WITH_PICOXR
+#include "PXR_MotionTracking.h"
+#include "PXR_MotionTrackingTypes.h"
+#endif
+
+#if WITH_PICOXR
+namespace
+{
+    void CopyPose(const FPXRPerEyeData& EyeData, FEyeSampleEye& OutEye)
+    {
+        OutEye.Position = EyeData.Position;
+        OutEye.Orientation = FQuat(EyeData.Orientation);
+        OutEye.bPoseValid = EyeData.bIsPoseValid;
+    }
+}
+#endif
+
+FPicoEyeTrackingSource::FPicoEyeTrackingSource(float InRateHz, bool bInNeedCalibration)
+    : RateHz(InRateHz)
+    , bNeedCalibration(bInNeedCalibration)
+{
+}
+
+bool FPicoEyeTrackingSource::Start()
+{
+#if WITH_PICOXR
+    bool bIsSupported = false;
+    TArray<EPXREyeTrackingMode> SupportedModes;
+    if (!PICOXRMotionTracking::GetEyeTrackingSupported(bIsSupported, SupportedModes) || !bIsSupported)
+    {
+        return false;
+    }
+
+    // The tests need both eyes
+    if (!SupportedModes.Contains(EPXREyeTrackingMode::PXR_ETM_BOTH))
+    {
+        return false;
+    }
+
+    FPXREyeTrackingStartInfo StartInfo;
+    StartInfo.StartMode = EPXREyeTrackingMode::PXR_ETM_BOTH;
+    StartInfo.NeedCalibration = bNeedCalibration;
+    return PICOXRMotionTracking::StartEyeTracking(StartInfo);
+#else
+    return false;
+#endif
+}
+
+void FPicoEyeTrackingSource::Stop()
+{
+    // The tracker is left running for the next source that needs it; the runtime stops it with the application
+}
+
+EEyeSourcePollResult FPicoEyeTrackingSource::Poll(FEyeTrackingSample& OutSample)
+{
+#if WITH_PICOXR
+    bool bIsTracking = false;
+    FPXREyeTrackingState TrackingState;
+    if (!PICOXRMotionTracking::GetEyeTrackingState(bIsTracking, TrackingState) || !bIsTracking)
+    {
+        return EEyeSourcePollResult::NoSample;
+    }
+
+    // Positions in metres, as the RAPD recordings have always stored them
+    FPXREyeTrackingDataGetInfo GetInfo;
+    GetInfo.DisplayTime = 0;
+    GetInfo.QueryPosition = true;
+    GetInfo.QueryOrientation = true;
+
+    FPXREyeTrackingData EyeTrackingData;
+    if (!PICOXRMotionTracking::GetEyeTrackingData(1.0f, GetInfo, EyeTrackingData))
+    {
+        return EEyeSourcePollResult::NoSample;
+    }
+
+    FEyeSampleEye& LeftEye = OutSample.GetEye(EEyeSampleEye::Left);
+    FEyeSampleEye& RightEye = OutSample.GetEye(EEyeSampleEye::Right);
+    CopyPose(EyeTrackingData.PerEyeDatas[0], LeftEye);
+    CopyPose(EyeTrackingData.PerEyeDatas[1], RightEye);
+    CopyPose(EyeTrackingData.PerEyeDatas[PxrPerEyeUsage::combined], OutSample.GetEye(EEyeSampleEye::Combined));
+
+    FPXREyePupilInfo PupilInfo;
+    if (PICOXRMotionTracking::GetEyePupilInfo(PupilInfo))
+    {
+        LeftEye.PupilDiameter = PupilInfo.LeftEyePupilDiameter;
+        RightEye.PupilDiameter = PupilInfo.RightEyePupilDiameter;
+    }
+    else
+    {
+        LeftEye.PupilDiameter = 0.0f;
+        RightEye.PupilDiameter = 0.0f;
+    }
+
+    LeftEye.Openness = 1.0f;
+    RightEye.Openness = 1.0f;
+    PICOXRMotionTracking::GetEyeOpenness(LeftEye.Openness, RightEye.Openness);
+
+    int64 DeviceTimestamp = 0;
+    LeftEye.bBlink = false;
+    RightEye.bBlink = false;
+    PICOXRMotionTracking::GetEyeBlink(DeviceTimestamp, LeftEye.bBlink, RightEye.bBlink);
+    OutSample.DeviceTimestampNanoseconds = DeviceTimestamp;
+
+    return EEyeSourcePollResult::Sample;
+#else
+    return EEyeSourcePollResult::Finished;
+#endif
+}
@@ -0,0 +1,42 @@
+// FReplayEyeTrackingSource.cpp
+
+#include "FReplayEyeTrackingSource.h"
+#include "HAL/PlatformTime.h"
+
+FReplayEyeTrackingSource::FReplayEyeTrackingSource(TSharedRef<FSessionReplay> InReplay)
+    : Replay(InReplay)
+{
+}
+
+bool FReplayEyeTrackingSource::Start()
+{
+    if (Replay->GetEyeSamples().Num() == 0)
+    {
+        return false;
+    }
+
+    NextSample = 0;
+    Replay->BeginPlayback(FPlatformTime::Seconds());
+    return true;
+}
+
+void FReplayEyeTrackingSource::Stop()
+{
+}
+
+EEyeSourcePollResult FReplayEyeTrackingSource::Poll(FEyeTrackingSample& OutSample)
+{
+    const TArray<FEyeTrackingSample>& Samples = Replay->GetEyeSamples();
+    if (NextSample >= Samples.Num())
+    {
+        return EEyeSourcePollResult::Finished;
+    }
+
+    if (Samples[NextSample].HostTimeSeconds > Replay->ToRecordedTime(FPlatformTime::Seconds()))
+    {
+        return EEyeSourcePollResult::NoSample;
+    }
+
+    OutSample = Samples[NextSample++];
+    return EEyeSourcePollResult::Sample;
+}
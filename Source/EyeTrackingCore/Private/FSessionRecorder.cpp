@@ -0,0 +1,172 @@
+// FSessionRecorder.cpp
+
+#include "FSessionRecorder.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+FSessionRecorder::FSessionRecorder(const FString& InFilePath, FEyeTrackingReader InEyeReader, float InFlushIntervalSeconds)
+    : FilePath(InFilePath)
+    , EyeReader(MoveTemp(InEyeReader))
+    , FlushIntervalSeconds(FMath::Max(InFlushIntervalSeconds, 0.001f))
+{
+}
+
+FSessionRecorder::~FSessionRecorder()
+{
+    Shutdown();
+}
+
+bool FSessionRecorder::Start()
+{
+    if (Thread)
+    {
+        return IsRecording();
+    }
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+    File.Reset(PlatformFile.OpenWrite(*FilePath));
+    if (!File.IsValid())
+    {
+        return false;
+    }
+
+    uint32 Magic = FSessionRecording::Magic;
+    uint32 Version = FSessionRecording::Version;
+    double StartSeconds = FPlatformTime::Seconds();
+    int64 StartTicks = FDateTime::UtcNow().GetTicks();
+    TArray<uint8> Header;
+    FMemoryWriter Writer(Header);
+    FSessionRecording::SerializeHeader(Writer, Magic, Version, StartSeconds, StartTicks);
+    File->Write(Header.GetData(), Header.Num());
+    BytesWritten.store(Header.Num(), std::memory_order_relaxed);
+
+    bStopRequested.store(false, std::memory_order_relaxed);
+    bRecording.store(true, std::memory_order_release);
+    Thread = FRunnableThread::Create(this, TEXT("SessionRecorder"), 0, TPri_BelowNormal);
+    if (!Thread)
+    {
+        bRecording.store(false, std::memory_order_release);
+        File.Reset();
+        return false;
+    }
+    return true;
+}
+
+void FSessionRecorder::Shutdown()
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    Stop();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+
+    // The writer thread has exited, so the last records can be written from here
+    bRecording.store(false, std::memory_order_release);
+    Drain();
+    File.Reset();
+}
+
+void FSessionRecorder::RecordHeadPose(const FHeadPoseSample& Pose)
+{
+    Enqueue(ESessionRecordType::HeadPose, Pose);
+}
+
+void FSessionRecorder::RecordInput(ESessionInput Input, bool bPressed, double HostTimeSeconds)
+{
+    FSessionInputRecord Record;
+    Record.HostTimeSeconds = HostTimeSeconds;
+    Record.Code = static_cast<int32>(Input);
+    Record.bPressed = bPressed;
+    Enqueue(ESessionRecordType::Input, Record);
+}
+
+void FSessionRecorder::RecordSeed(ESessionSeedStream Stream, int32 Seed, double HostTimeSeconds)
+{
+    FSessionSeedRecord Record;
+    Record.HostTimeSeconds = HostTimeSeconds;
+    Record.Stream = static_cast<int32>(Stream);
+    Record.Seed = Seed;
+    Enqueue(ESessionRecordType::Seed, Record);
+}
+
+void FSessionRecorder::RecordFrame(uint64 FrameNumber, float DeltaSeconds, double HostTimeSeconds)
+{
+    FSessionFrameRecord Record;
+    Record.HostTimeSeconds = HostTimeSeconds;
+    Record.FrameNumber = FrameNumber;
+    Record.DeltaSeconds = DeltaSeconds;
+    Enqueue(ESessionRecordType::Frame, Record);
+}
+
+void FSessionRecorder::RecordEvent(int32 Code, int32 IntValue, float FloatValue, double HostTimeSeconds)
+{
+    FSessionEventRecord Record;
+    Record.HostTimeSeconds = HostTimeSeconds;
+    Record.Code = Code;
+    Record.IntValue = IntValue;
+    Record.FloatValue = FloatValue;
+    Enqueue(ESessionRecordType::Event, Record);
+}
+
+template <typename RecordType>
+void FSessionRecorder::Enqueue(ESessionRecordType Type, const RecordType& Record)
+{
+    if (!IsRecording())
+    {
+        return;
+    }
+
+    TArray<uint8> Bytes;
+    FSessionRecording::AppendRecord(Bytes, Type, Record);
+    PendingRecords.Enqueue(MoveTemp(Bytes));
+}
+
+uint32 FSessionRecorder::Run()
+{
+    while (!bStopRequested.load(std::memory_order_relaxed))
+    {
+        FPlatformProcess::SleepNoStats(FlushIntervalSeconds);
+        Drain();
+    }
+    return 0;
+}
+
+void FSessionRecorder::Stop()
+{
+    bStopRequested.store(true, std::memory_order_relaxed);
+}
+
+void FSessionRecorder::Drain()
+{
+    Batch.Reset();
+
+    if (EyeReader.IsValid())
+    {
+        EyeSamples.Reset();
+        EyeReader.ReadNew(EyeSamples);
+        for (const FEyeTrackingSample& Sample : EyeSamples)
+        {
+            FSessionRecording::AppendRecord(Batch, ESessionRecordType::EyeSample, Sample);
+        }
+    }
+
+    TArray<uint8> Bytes;
+    while (PendingRecords.Dequeue(Bytes))
+    {
+        Batch.Append(Bytes);
+    }
+
+    if (Batch.Num() > 0 && File.IsValid())
+    {
+        File->Write(Batch.GetData(), Batch.Num());
+        BytesWritten.fetch_add(Batch.Num(), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,87 @@
+// FSessionRecording.cpp
+
+#include "FSessionRecording.h"
+
+namespace
+{
+    // Vectors and rotations are stored as floats; double precision buys nothing at tracker resolution
+    void SerializeVector(FArchive& Ar, FVector& Vector)
+    {
+        FVector3f Value(Vector);
+        Ar << Value.X << Value.Y << Value.Z;
+        if (Ar.IsLoading())
+        {
+            Vector = FVector(Value);
+        }
+    }
+
+    void SerializeQuat(FArchive& Ar, FQuat& Quat)
+    {
+        FQuat4f Value(Quat);
+        Ar << Value.X << Value.Y << Value.Z << Value.W;
+        if (Ar.IsLoading())
+        {
+            Quat = FQuat(Value);
+        }
+    }
+
+    // Eye flags packed into one byte
+    enum EEyeFlags : uint8
+    {
+        PoseValid = 1 << 0,
+        Blink = 1 << 1
+    };
+}
+
+void FSessionRecording::SerializeHeader(FArchive& Ar, uint32& InOutMagic, uint32& InOutVersion, double& InOutStartSeconds, int64& InOutStartTicks)
+{
+    Ar << InOutMagic << InOutVersion << InOutStartSeconds << InOutStartTicks;
+}
+
+void FSessionRecording::Serialize(FArchive& Ar, FEyeTrackingSample& Sample)
+{
+    Ar << Sample.HostTimeSeconds << Sample.DeviceTimestampNanoseconds;
+    for (int32 EyeIndex = 0; EyeIndex < static_cast<int32>(EEyeSampleEye::Count); ++EyeIndex)
+    {
+        FEyeSampleEye& Eye = Sample.Eyes[EyeIndex];
+        SerializeVector(Ar, Eye.Position);
+        SerializeQuat(Ar, Eye.Orientation);
+        Ar << Eye.PupilDiameter << Eye.Openness;
+
+        uint8 Flags = (Eye.bPoseValid ? PoseValid : 0) | (Eye.bBlink ? Blink : 0);
+        Ar << Flags;
+        Eye.bPoseValid = (Flags & PoseValid) != 0;
+        Eye.bBlink = (Flags & Blink) != 0;
+    }
+}
+
+void FSessionRecording::Serialize(FArchive& Ar, FHeadPoseSample& Pose)
+{
+    Ar << Pose.HostTimeSeconds;
+    SerializeQuat(Ar, Pose.Orientation);
+    SerializeVector(Ar, Pose.Position);
+    SerializeVector(Ar, Pose.AngularVelocity);
+}
+
+void FSessionRecording::Serialize(FArchive& Ar, FSessionInputRecord& Record)
+{
+    // FArchive stores bools as four bytes
+    uint8 Pressed = Record.bPressed ? 1 : 0;
+    Ar << Record.HostTimeSeconds << Record.Code << Pressed;
+    Record.bPressed = Pressed != 0;
+}
+
+void FSessionRecording::Serialize(FArchive& Ar, FSessionSeedRecord& Record)
+{
+    Ar << Record.HostTimeSeconds << Record.Stream << Record.Seed;
+}
+
+void FSessionRecording::Serialize(FArchive& Ar, FSessionFrameRecord& Record)
+{
+    Ar << Record.HostTimeSeconds << Record.FrameNumber << Record.DeltaSeconds;
+}
+
+void FSessionRecording::Serialize(FArchive& Ar, FSessionEventRecord& Record)
+{
+    Ar << Record.HostTimeSeconds << Record.Code << Record.IntValue << Record.FloatValue;
+}
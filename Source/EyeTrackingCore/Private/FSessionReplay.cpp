@@ -0,0 +1,129 @@
+// FSessionReplay.cpp
+
+#include "FSessionReplay.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Algo/StableSort.h"
+#include "Algo/UpperBound.h"
+
+namespace
+{
+    // Reads one payload into the end of a stream
+    template <typename RecordType>
+    void ReadRecord(FArchive& Ar, TArray<RecordType>& OutRecords)
+    {
+        FSessionRecording::Serialize(Ar, OutRecords.AddDefaulted_GetRef());
+    }
+
+    // Records of one type are written in order, but keep the streams sorted in case a file was concatenated
+    template <typename RecordType>
+    void SortByTime(TArray<RecordType>& Records)
+    {
+        Algo::StableSortBy(Records, &RecordType::HostTimeSeconds);
+    }
+
+    // Time of the first record in a sorted stream, or the fallback if the stream is empty
+    template <typename RecordType>
+    double FirstTime(const TArray<RecordType>& Records, double Fallback)
+    {
+        return Records.Num() > 0 ? Records[0].HostTimeSeconds : Fallback;
+    }
+}
+
+bool FSessionReplay::Load(const FString& InFilePath)
+{
+    FilePath = InFilePath;
+    EyeSamples.Reset();
+    HeadPoses.Reset();
+    Inputs.Reset();
+    Seeds.Reset();
+    Frames.Reset();
+    Events.Reset();
+    PlaybackStartSeconds = -1.0;
+    PlaybackAnchorSeconds = 0.0;
+
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    int64 StartTicks = 0;
+    FSessionRecording::SerializeHeader(Reader, Magic, Version, RecordingStartSeconds, StartTicks);
+    if (Reader.IsError() || Magic != FSessionRecording::Magic || Version > FSessionRecording::Version)
+    {
+        return false;
+    }
+
+    // A recording cut short (a crash, a pulled cable) ends in a partial record, which is dropped
+    while (Reader.Tell() + FSessionRecording::RecordPrefixSize <= Reader.TotalSize())
+    {
+        uint8 Type = 0;
+        uint16 PayloadSize = 0;
+        Reader << Type << PayloadSize;
+        const int64 PayloadEnd = Reader.Tell() + PayloadSize;
+        if (PayloadEnd > Reader.TotalSize())
+        {
+            break;
+        }
+
+        switch (static_cast<ESessionRecordType>(Type))
+        {
+        case ESessionRecordType::EyeSample: ReadRecord(Reader, EyeSamples); break;
+        case ESessionRecordType::HeadPose:  ReadRecord(Reader, HeadPoses); break;
+        case ESessionRecordType::Input:     ReadRecord(Reader, Inputs); break;
+        case ESessionRecordType::Seed:      ReadRecord(Reader, Seeds); break;
+        case ESessionRecordType::Frame:     ReadRecord(Reader, Frames); break;
+        case ESessionRecordType::Event:     ReadRecord(Reader, Events); break;
+        default: break;
+        }
+
+        // Skipping to the declared end keeps newer payloads with extra fields readable
+        Reader.Seek(PayloadEnd);
+    }
+
+    SortByTime(EyeSamples);
+    SortByTime(HeadPoses);
+    SortByTime(Inputs);
+    SortByTime(Seeds);
+    SortByTime(Frames);
+    SortByTime(Events);
+
+    // Recording starts when the subsystem does, which is earlier than the test starts tracking; anchoring
+    // playback there would shift every replayed stream by the time the level took to load
+    const FSessionEventRecord* AcquisitionStart = Events.FindByPredicate([](const FSessionEventRecord& Record)
+    {
+        return Record.Code == static_cast<int32>(ESessionEvent::AcquisitionStarted);
+    });
+    PlaybackAnchorSeconds = AcquisitionStart
+        ? AcquisitionStart->HostTimeSeconds
+        : FMath::Min(FirstTime(Seeds, RecordingStartSeconds), FirstTime(Frames, RecordingStartSeconds));
+    return true;
+}
+
+bool FSessionReplay::GetHeadPoseAt(double RecordedSeconds, FHeadPoseSample& OutPose) const
+{
+    const int32 NextIndex = Algo::UpperBoundBy(HeadPoses, RecordedSeconds, &FHeadPoseSample::HostTimeSeconds);
+    if (NextIndex == 0)
+    {
+        return false;
+    }
+    OutPose = HeadPoses[NextIndex - 1];
+    return true;
+}
+
+bool FSessionReplay::GetSeed(ESessionSeedStream Stream, int32 Index, int32& OutSeed) const
+{
+    for (const FSessionSeedRecord& Record : Seeds)
+    {
+        if (Record.Stream == static_cast<int32>(Stream) && Index-- == 0)
+        {
+            OutSeed = Record.Seed;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,100 @@
+// FSyntheticEyeTrackingSource.cpp
+
+#include "FSyntheticEyeTrackingSource.h"
+
+FSyntheticEyeTrackingSource::FSyntheticEyeTrackingSource(const FSyntheticEyeTrackingSettings& InSettings)
+    : Settings(InSettings)
+{
+}
+
+bool FSyntheticEyeTrackingSource::Start()
+{
+    if (Settings.RateHz <= 0.0f)
+    {
+        return false;
+    }
+
+    Random.Initialize(Settings.Seed);
+    SampleIndex = 0;
+    SaccadeFrom = FVector2D::ZeroVector;
+    SaccadeTo = FVector2D::ZeroVector;
+    SaccadeStartTime = -Settings.SaccadeDurationSeconds;
+    BlinkEndTime = 0.0;
+    NextSaccadeTime = NextEventTime(0.0, Settings.SaccadeIntervalSeconds);
+    NextBlinkTime = NextEventTime(0.0, Settings.BlinkIntervalSeconds);
+    return true;
+}
+
+double FSyntheticEyeTrackingSource::NextEventTime(double Now, float AverageIntervalSeconds)
+{
+    if (AverageIntervalSeconds <= 0.0f)
+    {
+        return TNumericLimits<double>::Max();
+    }
+
+    // Uniform between half and one and a half times the average keeps events spread out but never bunched
+    return Now + AverageIntervalSeconds * Random.FRandRange(0.5f, 1.5f);
+}
+
+float FSyntheticEyeTrackingSource::Gaussian()
+{
+    // Box-Muller transform
+    const float Radius = FMath::Sqrt(-2.0f * FMath::Loge(FMath::Max(Random.GetFraction(), SMALL_NUMBER)));
+    return Radius * FMath::Cos(2.0f * PI * Random.GetFraction());
+}
+
+EEyeSourcePollResult FSyntheticEyeTrackingSource::Poll(FEyeTrackingSample& OutSample)
+{
+    if (Settings.MaxSamples > 0 && SampleIndex >= Settings.MaxSamples)
+    {
+        return EEyeSourcePollResult::Finished;
+    }
+
+    const double Time = SampleIndex / static_cast<double>(Settings.RateHz);
+    ++SampleIndex;
+
+    // Start the next saccade: away from fixation in a random direction, or back to it
+    if (Time >= NextSaccadeTime)
+    {
+        SaccadeFrom = SaccadeTo;
+        if (SaccadeFrom.IsNearlyZero())
+        {
+            const float Direction = Random.FRandRange(0.0f, 2.0f * PI);
+            SaccadeTo = FVector2D(FMath::Cos(Direction), FMath::Sin(Direction)) * Settings.SaccadeAmplitudeDegrees;
+        }
+        else
+        {
+            SaccadeTo = FVector2D::ZeroVector;
+        }
+        SaccadeStartTime = Time;
+        NextSaccadeTime = NextEventTime(Time, Settings.SaccadeIntervalSeconds);
+    }
+
+    if (Time >= NextBlinkTime)
+    {
+        BlinkEndTime = Time + Settings.BlinkDurationSeconds;
+        NextBlinkTime = NextEventTime(BlinkEndTime, Settings.BlinkIntervalSeconds);
+    }
+    const bool bBlinking = Time < BlinkEndTime;
+
+    // Constant-velocity saccade, then fixational jitter around the target
+    const float SaccadeProgress = Settings.SaccadeDurationSeconds > 0.0f ? FMath::Clamp(static_cast<float>((Time - SaccadeStartTime) / Settings.SaccadeDurationSeconds), 0.0f, 1.0f) : 1.0f;
+    FVector2D Gaze = FMath::Lerp(SaccadeFrom, SaccadeTo, SaccadeProgress);
+    Gaze.X += Settings.NoiseDegrees * Gaussian();
+    Gaze.Y += Settings.NoiseDegrees * Gaussian();
+
+    const FQuat Orientation = FRotator(Gaze.Y, Gaze.X, 0.0f).Quaternion();
+    for (FEyeSampleEye& Eye : OutSample.Eyes)
+    {
+        Eye.Position = FVector::ZeroVector;
+        Eye.Orientation = Orientation;
+        Eye.PupilDiameter = Settings.PupilDiameter;
+        Eye.Openness = bBlinking ? 0.0f : 1.0f;
+        Eye.bBlink = bBlinking;
+        Eye.bPoseValid = !bBlinking;
+    }
+    OutSample.GetEye(EEyeSampleEye::Combined).PupilDiameter = 0.0f;
+
+    OutSample.DeviceTimestampNanoseconds = static_cast<int64>(Time * 1.0e9);
+    return EEyeSourcePollResult::Sample;
+}
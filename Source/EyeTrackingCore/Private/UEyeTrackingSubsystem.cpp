@@ -0,0 +1,165 @@
+// UEyeTrackingSubsystem.cpp
+
+#include "UEyeTrackingSubsystem.h"
+#include "FPicoEyeTrackingSource.h"
+#include "FSyntheticEyeTrackingSource.h"
+#include "FFileEyeTrackingSource.h"
+#include "FReplayEyeTrackingSource.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+
+UEyeTrackingSubsystem* UEyeTrackingSubsystem::Instance = nullptr;
+
+void UEyeTrackingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    Ring = MakeShared<FEyeSampleRing>(RingCapacity);
+
+    FString ReplayFile;
+    if (FParse::Value(FCommandLine::Get(), TEXT("ReplaySession="), ReplayFile))
+    {
+        LoadReplay(ReplayFile);
+    }
+
+    FString RecordFile;
+    if (FParse::Value(FCommandLine::Get(), TEXT("RecordSession="), RecordFile) || bRecordSessions)
+    {
+        if (RecordFile.IsEmpty())
+        {
+            RecordFile = FPaths::Combine(FPaths::ProjectSavedDir(), SessionDirectory, FString::Printf(TEXT("Session_%s.vsps"), *FDateTime::Now().ToString()));
+        }
+        StartRecording(RecordFile);
+    }
+
+    Instance = this;
+}
+
+void UEyeTrackingSubsystem::Deinitialize()
+{
+    Instance = nullptr;
+
+    StopAcquisition();
+    StopRecording();
+
+    Super::Deinitialize();
+}
+
+bool UEyeTrackingSubsystem::StartAcquisition(bool bNeedCalibration)
+{
+    if (IsAcquiring())
+    {
+        return true;
+    }
+    return StartAcquisition(CreateConfiguredSource(bNeedCalibration));
+}
+
+bool UEyeTrackingSubsystem::StartAcquisition(TUniquePtr<IEyeTrackingSource> Source)
+{
+    StopAcquisition();
+    if (!Source.IsValid())
+    {
+        return false;
+    }
+
+    Service = MakeUnique<FEyeTrackingService>(MoveTemp(Source), Ring.ToSharedRef());
+    const double StartSeconds = FPlatformTime::Seconds();
+    if (!Service->Start())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Eye tracking source %s failed to start."), *Service->GetSource().GetName());
+        Service.Reset();
+        return false;
+    }
+
+    // Replay lines its clock up with this marker
+    if (Recorder.IsValid())
+    {
+        Recorder->RecordEvent(static_cast<int32>(ESessionEvent::AcquisitionStarted), 0, 0.0f, StartSeconds);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Eye tracking service started from %s at %.0f Hz."), *Service->GetSource().GetName(), Service->GetSource().GetNativeRateHz());
+    return true;
+}
+
+void UEyeTrackingSubsystem::StopAcquisition()
+{
+    // Destroying the service joins the acquisition thread and stops the source
+    Service.Reset();
+}
+
+bool UEyeTrackingSubsystem::StartRecording(const FString& FilePath)
+{
+    StopRecording();
+
+    // The recorder reads the ring from now on, so it also captures sources started later
+    Recorder = MakeUnique<FSessionRecorder>(FilePath, CreateReader());
+    if (!Recorder->Start())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Could not record the session to %s."), *FilePath);
+        Recorder.Reset();
+        return false;
+    }
+
+    // Tracking already running is replayed from the first sample this file holds
+    if (IsAcquiring())
+    {
+        Recorder->RecordEvent(static_cast<int32>(ESessionEvent::AcquisitionStarted), 0, 0.0f, FPlatformTime::Seconds());
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Recording the session to %s."), *FilePath);
+    return true;
+}
+
+void UEyeTrackingSubsystem::StopRecording()
+{
+    if (Recorder.IsValid())
+    {
+        Recorder->Shutdown();
+        UE_LOG(LogTemp, Log, TEXT("Session recording %s closed after %lld bytes."), *Recorder->GetFilePath(), Recorder->GetBytesWritten());
+        Recorder.Reset();
+    }
+}
+
+bool UEyeTrackingSubsystem::LoadReplay(const FString& FilePath)
+{
+    TSharedRef<FSessionReplay> NewReplay = MakeShared<FSessionReplay>();
+    if (!NewReplay->Load(FilePath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s is not a session recording this build can replay."), *FilePath);
+        Replay.Reset();
+        return false;
+    }
+
+    Replay = NewReplay;
+    UE_LOG(LogTemp, Log, TEXT("Replaying session %s: %d eye samples, %d head poses, %d inputs, %d seeds."), *FilePath,
+        Replay->GetEyeSamples().Num(), Replay->GetHeadPoses().Num(), Replay->GetInputs().Num(), Replay->GetSeeds().Num());
+    return true;
+}
+
+TUniquePtr<IEyeTrackingSource> UEyeTrackingSubsystem::CreateConfiguredSource(bool bNeedCalibration) const
+{
+    // A loaded replay takes precedence over every configured source
+    if (Replay.IsValid())
+    {
+        return MakeUnique<FReplayEyeTrackingSource>(Replay.ToSharedRef());
+    }
+
+    FString Name = SourceName;
+    FString File = SourceFile;
+    FParse::Value(FCommandLine::Get(), TEXT("EyeTrackingSource="), Name);
+    FParse::Value(FCommandLine::Get(), TEXT("EyeTrackingFile="), File);
+
+    if (Name.Equals(TEXT("Synthetic"), ESearchCase::IgnoreCase))
+    {
+        FSyntheticEyeTrackingSettings Settings;
+        Settings.RateHz = SyntheticSampleRateHz;
+        return MakeUnique<FSyntheticEyeTrackingSource>(Settings);
+    }
+    if (Name.Equals(TEXT("File"), ESearchCase::IgnoreCase))
+    {
+        return MakeUnique<FFileEyeTrackingSource>(File, bReplayInRealTime);
+    }
+    return MakeUnique<FPicoEyeTrackingSource>(PicoSampleRateHz, bNeedCalibration);
+}
@@ -0,0 +1,110 @@
+// FClockSync.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FClockSyncSettings
+{
+    // Observations are grouped into windows of this length and only the least-delayed one of each is kept
+    double WindowSeconds = 0.5;
+
+    // Windows kept for the fit; 120 half-second windows follow drift over the last minute
+    int32 MaxWindows = 120;
+
+    // Windows needed before offset and drift come from the fit rather than the best observation so far
+    int32 MinWindowsForFit = 3;
+
+    // An offset this far below the fit (or a whole window this far above it) means the device clock jumped,
+    // for instance because the tracker restarted, and the estimate starts over
+    double ResetThresholdSeconds = 0.25;
+};
+
+// Snapshot of the current alignment, for logs
+struct FClockSyncEstimate
+{
+    // Host time minus device time at the newest window, in seconds
+    double OffsetSeconds = 0.0;
+
+    // How much faster the host clock runs than the device clock, in parts per million
+    double DriftPpm = 0.0;
+
+    // Expected error of an aligned timestamp, in seconds
+    double ErrorSeconds = 0.0;
+
+    // Windows the estimate is based on; zero before the first observation
+    int32 NumWindows = 0;
+};
+
+/**
+ * Maps a device's timestamps onto the FPlatformTime::Seconds timeline.
+ * Each observation pairs a device timestamp with the host time the sample arrived. Transport delay only ever
+ * adds to the host time, so the least-delayed observation of each window is the best offset it holds; a line
+ * fitted through those minima gives the offset and the drift between the clocks, and their scatter about the
+ * line is the error reported for aligned times. Delay that every sample shares cannot be seen from one-way
+ * timestamps and stays in the offset, so it shifts all aligned times alike. Updates are O(1) except when a
+ * window closes, which refits over at most MaxWindows points. Not thread-safe; the acquisition thread owns it.
+ */
+class EYETRACKINGCORE_API FClockSync
+{
+public:
+    explicit FClockSync(const FClockSyncSettings& InSettings = FClockSyncSettings());
+
+    // Forgets every observation
+    void Reset();
+
+    // Adds a device timestamp and the host time its sample was received at
+    void AddObservation(int64 DeviceNanoseconds, double HostSeconds);
+
+    // True once there is at least one observation to align against
+    bool IsSynchronized() const { return bHasOrigin; }
+
+    // Host time at which the device clock read DeviceNanoseconds
+    double DeviceToHost(int64 DeviceNanoseconds) const;
+
+    // Expected error of DeviceToHost, in seconds
+    double GetErrorSeconds() const;
+
+    FClockSyncEstimate GetEstimate() const;
+
+private:
+    struct FWindowPoint
+    {
+        double DeviceSeconds;
+        double OffsetSeconds;
+    };
+
+    // Device time relative to the first observation, so doubles keep nanosecond resolution
+    double ToDeviceSeconds(int64 DeviceNanoseconds) const { return static_cast<double>(DeviceNanoseconds - DeviceOrigin) * 1.0e-9; }
+
+    // Offset predicted at a device time
+    double PredictOffset(double DeviceSeconds) const;
+
+    // Stores the open window's minimum and refits
+    void CloseWindow();
+    void Fit();
+
+    FClockSyncSettings Settings;
+
+    bool bHasOrigin = false;
+    int64 DeviceOrigin = 0;
+
+    // The window being filled
+    double WindowStartSeconds = 0.0;
+    FWindowPoint WindowMinimum = {0.0, 0.0};
+
+    // Closed windows, oldest overwritten first
+    TArray<FWindowPoint> Windows;
+    int32 NextWindow = 0;
+
+    // Offset(x) = FitIntercept + FitSlope * (x - FitMeanDevice), valid once MinWindowsForFit windows closed
+    bool bHasFit = false;
+    double FitMeanDevice = 0.0;
+    double FitIntercept = 0.0;
+    double FitSlope = 0.0;
+    double FitResidualSeconds = 0.0;
+
+    // Spread of all offsets since the last reset, the error bound before there is a fit
+    double MinOffsetSeconds = 0.0;
+    double MaxOffsetSeconds = 0.0;
+};
@@ -0,0 +1,74 @@
+// FEyeSampleRing.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FEyeTrackingSample.h"
+#include <atomic>
+
+/**
+ * Fixed-capacity broadcast ring of eye samples with one writer and any number of readers.
+ * Nothing is ever locked: each slot carries a version counter that is odd while the writer is copying into it,
+ * so a reader copies a slot optimistically and keeps the copy only if the version was the expected even value
+ * before and after. Readers never hold the writer up; a reader that falls more than a ring behind loses the
+ * oldest samples instead. Readers keep their own cursor (see FEyeTrackingReader), so every consumer sees
+ * every sample exactly once.
+ */
+class EYETRACKINGCORE_API FEyeSampleRing
+{
+public:
+    // Capacity is rounded up to a power of two
+    explicit FEyeSampleRing(int32 InCapacity);
+
+    // Appends a sample and stamps its sequence number; only one thread may publish
+    void Publish(const FEyeTrackingSample& Sample);
+
+    // Number of samples published so far, which is also the sequence number of the next one
+    uint64 GetPublishedCount() const { return PublishedCount.load(std::memory_order_acquire); }
+
+    // Copies the sample with this sequence number; false if it is not published yet or was already overwritten
+    bool TryRead(uint64 SequenceNumber, FEyeTrackingSample& OutSample) const;
+
+    int32 GetCapacity() const { return static_cast<int32>(Mask + 1); }
+
+private:
+    struct FSlot
+    {
+        // 2 * SequenceNumber + 1 while being written, 2 * SequenceNumber + 2 once the sample is complete
+        std::atomic<uint64> Version{0};
+        FEyeTrackingSample Sample;
+    };
+
+    TUniquePtr<FSlot[]> Slots;
+    uint64 Mask;
+
+    std::atomic<uint64> PublishedCount{0};
+};
+
+/**
+ * One consumer's view of an FEyeSampleRing.
+ * Each reader starts at the newest sample when it is created and then returns everything published after it,
+ * oldest first. Readers are cheap to copy and are used from a single thread each.
+ */
+class EYETRACKINGCORE_API FEyeTrackingReader
+{
+public:
+    FEyeTrackingReader() = default;
+    explicit FEyeTrackingReader(TSharedRef<const FEyeSampleRing> InRing);
+
+    bool IsValid() const { return Ring.IsValid(); }
+
+    // Appends every sample published since the last call and returns how many were added
+    int32 ReadNew(TArray<FEyeTrackingSample>& OutSamples);
+
+    // Copies the newest published sample without moving the cursor; false if there is none
+    bool PeekLatest(FEyeTrackingSample& OutSample) const;
+
+    // Samples that were overwritten before this reader got to them
+    uint64 GetSkippedCount() const { return SkippedCount; }
+
+private:
+    TSharedPtr<const FEyeSampleRing> Ring;
+    uint64 Cursor = 0;
+    uint64 SkippedCount = 0;
+};
@@ -0,0 +1,62 @@
+// FEyeTrackingSample.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Index of each pose in FEyeTrackingSample::Eyes
+enum class EEyeSampleEye : uint8
+{
+    Left = 0,
+    Right,
+    Combined,
+    Count
+};
+
+// Pose, pupil and lid state of one eye (or the combined cyclopean eye) in one tracker sample
+struct EYETRACKINGCORE_API FEyeSampleEye
+{
+    // Gaze origin and orientation in the tracker's frame. Every source uses Unreal's forward convention: the
+    // orientation rotates +X onto the gaze direction, so Orientation.Vector() is where the eye is looking
+    FVector Position = FVector::ZeroVector;
+    FQuat Orientation = FQuat::Identity;
+
+    // Pupil diameter in mm; zero when the tracker does not report it (always zero for the combined eye)
+    float PupilDiameter = 0.0f;
+
+    // Lid openness from 0 (closed) to 1 (open), and the tracker's own blink flag
+    float Openness = 1.0f;
+    bool bBlink = false;
+
+    bool bPoseValid = false;
+};
+
+/**
+ * One sample from the eye tracker, as published by FEyeTrackingService.
+ * HostTimeSeconds is when the tracker took the sample, on the FPlatformTime::Seconds timeline that frames and
+ * stimuli are timed on: the service maps the device timestamp onto it with FClockSync, or, for sources without a
+ * real-time device clock, uses the time the sample was received. TimeErrorSeconds is the expected error of that
+ * mapping. DeviceTimestampNanoseconds is the tracker's own clock, kept raw.
+ */
+struct EYETRACKINGCORE_API FEyeTrackingSample
+{
+    // Position of the sample in the service's stream; consecutive samples differ by one
+    uint64 SequenceNumber = 0;
+
+    // Time the sample was taken, on the host timeline
+    double HostTimeSeconds = 0.0;
+
+    // Time the acquisition thread received it; HostTimeSeconds is never later
+    double ReceivedTimeSeconds = 0.0;
+
+    // Expected error of HostTimeSeconds, in seconds
+    float TimeErrorSeconds = 0.0f;
+
+    // Timestamp from the tracker, in its own time base; zero when the source has none
+    int64 DeviceTimestampNanoseconds = 0;
+
+    FEyeSampleEye Eyes[static_cast<int32>(EEyeSampleEye::Count)];
+
+    const FEyeSampleEye& GetEye(EEyeSampleEye Eye) const { return Eyes[static_cast<int32>(Eye)]; }
+    FEyeSampleEye& GetEye(EEyeSampleEye Eye) { return Eyes[static_cast<int32>(Eye)]; }
+};
@@ -0,0 +1,62 @@
+// FEyeTrackingService.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "IEyeTrackingSource.h"
+#include "FEyeSampleRing.h"
+#include "FClockSync.h"
+#include <atomic>
+
+class FRunnableThread;
+
+/**
+ * Acquisition thread for one eye-tracking source.
+ * The thread polls the source at its native rate, puts each sample on the host timeline (its device timestamp
+ * aligned by an FClockSync, or the time it was received) and publishes it to a shared FEyeSampleRing.
+ * Consumers read the ring through their own FEyeTrackingReader, so sampling no longer depends on game-thread timers or frame pacing and every test sees
+ * the same samples. The ring is owned outside the service and outlives it, so readers stay valid when the
+ * service is restarted with a different source.
+ */
+class EYETRACKINGCORE_API FEyeTrackingService : public FRunnable
+{
+public:
+    FEyeTrackingService(TUniquePtr<IEyeTrackingSource> InSource, TSharedRef<FEyeSampleRing> InRing);
+    virtual ~FEyeTrackingService();
+
+    // Starts the source and then the acquisition thread; returns false if the source could not start
+    bool Start();
+
+    // Stops the acquisition thread, waits for it and then stops the source
+    void Shutdown();
+
+    // True while the acquisition thread is running; false once it stopped or the source finished
+    bool IsRunning() const { return bRunning.load(std::memory_order_acquire); }
+
+    const IEyeTrackingSource& GetSource() const { return *Source; }
+
+    // Latest alignment of the source's clock with the host's; all zero for sources without a device clock
+    FClockSyncEstimate GetClockEstimate() const;
+
+    // FRunnable interface
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    // Sets the sample's host time and its error; Period is the polling period, zero for free-running sources
+    void StampSample(FEyeTrackingSample& Sample, double Period);
+
+    TUniquePtr<IEyeTrackingSource> Source;
+    TSharedRef<FEyeSampleRing> Ring;
+
+    // Owned by the acquisition thread; the estimate is copied out for other threads under the lock
+    FClockSync ClockSync;
+    int64 LastDeviceTimestamp = 0;
+    mutable FCriticalSection ClockEstimateLock;
+    FClockSyncEstimate ClockEstimate;
+
+    FRunnableThread* Thread = nullptr;
+    std::atomic<bool> bStopRequested{false};
+    std::atomic<bool> bRunning{false};
+};
@@ -0,0 +1,39 @@
+// FFileEyeTrackingSource.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IEyeTrackingSource.h"
+
+/**
+ * Replays an RAPD eye recording (the CSV ALightController writes) as an eye-tracking source.
+ * Columns are TimeStamp, Intensity_Left, Pupil_Diameter_Left, Intensity_Right, Pupil_Diameter_Right, the gaze
+ * origin and direction, and optionally the openness and blink columns; intensities are ignored. The recorded
+ * direction is the combined eye's up axis, so it is turned back into an orientation whose up axis matches, and
+ * the recorded time becomes the device timestamp. Pupil diameters are taken as written, including the +1 mm
+ * offset ALightController adds. With bRealTime the samples are paced at the recording's
+ * average rate; otherwise the service takes them as fast as it can, which is what headless runs want.
+ */
+class EYETRACKINGCORE_API FFileEyeTrackingSource : public IEyeTrackingSource
+{
+public:
+    FFileEyeTrackingSource(const FString& InFilePath, bool bInRealTime);
+
+    // IEyeTrackingSource interface
+    virtual FString GetName() const override { return TEXT("File"); }
+    virtual float GetNativeRateHz() const override { return bRealTime ? RecordedRateHz : 0.0f; }
+    virtual bool Start() override;
+    virtual void Stop() override;
+    virtual EEyeSourcePollResult Poll(FEyeTrackingSample& OutSample) override;
+
+private:
+    // Parses one data row; false if it is malformed
+    static bool ParseRow(const FString& Row, FEyeTrackingSample& OutSample);
+
+    FString FilePath;
+    bool bRealTime;
+
+    TArray<FString> Rows;
+    int32 NextRow = 0;
+    float RecordedRateHz = 0.0f;
+};
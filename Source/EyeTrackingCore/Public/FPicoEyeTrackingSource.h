@@ -0,0 +1,29 @@
+// FPicoEyeTrackingSource.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IEyeTrackingSource.h"
+
+/**
+ * Eye-tracking source for the PICO headset, read through PICOXRMotionTracking.
+ * Start checks that both eyes can be tracked and starts the runtime's tracker (with calibration if asked);
+ * each poll reads the per-eye poses, pupil diameters, openness and blink state in one go. Builds without the
+ * PICO runtime (WITH_PICOXR == 0) compile the class, but Start always fails.
+ */
+class EYETRACKINGCORE_API FPicoEyeTrackingSource : public IEyeTrackingSource
+{
+public:
+    FPicoEyeTrackingSource(float InRateHz, bool bInNeedCalibration);
+
+    // IEyeTrackingSource interface
+    virtual FString GetName() const override { return TEXT("Pico"); }
+    virtual float GetNativeRateHz() const override { return RateHz; }
+    virtual bool Start() override;
+    virtual void Stop() override;
+    virtual EEyeSourcePollResult Poll(FEyeTrackingSample& OutSample) override;
+
+private:
+    float RateHz;
+    bool bNeedCalibration;
+};
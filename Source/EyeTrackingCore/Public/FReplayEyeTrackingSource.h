@@ -0,0 +1,33 @@
+// FReplayEyeTrackingSource.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IEyeTrackingSource.h"
+#include "FSessionReplay.h"
+
+/**
+ * Plays the eye samples of a recorded session back through the acquisition service.
+ * Each sample is published once as much time has passed since Start as had passed since the recording
+ * started, so gaze, head pose and button presses stay in step with each other and with the stimuli. The
+ * device timestamps are kept as recorded; the service stamps the host time as for a live source.
+ */
+class EYETRACKINGCORE_API FReplayEyeTrackingSource : public IEyeTrackingSource
+{
+public:
+    // Polled well above any tracker rate, so each sample is published within a millisecond of its recorded time
+    static constexpr float PollRateHz = 1000.0f;
+
+    explicit FReplayEyeTrackingSource(TSharedRef<FSessionReplay> InReplay);
+
+    // IEyeTrackingSource interface
+    virtual FString GetName() const override { return TEXT("Replay"); }
+    virtual float GetNativeRateHz() const override { return PollRateHz; }
+    virtual bool Start() override;
+    virtual void Stop() override;
+    virtual EEyeSourcePollResult Poll(FEyeTrackingSample& OutSample) override;
+
+private:
+    TSharedRef<FSessionReplay> Replay;
+    int32 NextSample = 0;
+};
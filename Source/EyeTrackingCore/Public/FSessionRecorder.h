@@ -0,0 +1,72 @@
+// FSessionRecorder.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include "FEyeSampleRing.h"
+#include "FSessionRecording.h"
+#include <atomic>
+
+class FRunnableThread;
+class IFileHandle;
+
+/**
+ * Records a whole session (raw gaze and pupil samples, head pose, button presses, random seeds, frame timing
+ * and test events) into one FSessionRecording file that FSessionReplay plays back.
+ * Eye samples are taken straight from the acquisition ring by the recorder's own reader, so recording costs the
+ * tests nothing per sample. Everything else is serialized by the caller into a small record and queued; a
+ * writer thread drains the reader and the queue every FlushIntervalSeconds and appends them to the file, so
+ * no Record* call ever touches the disk. Record* may be called from any thread.
+ */
+class EYETRACKINGCORE_API FSessionRecorder : public FRunnable
+{
+public:
+    FSessionRecorder(const FString& InFilePath, FEyeTrackingReader InEyeReader, float InFlushIntervalSeconds = 0.1f);
+    virtual ~FSessionRecorder();
+
+    // Creates the file, writes the header and starts the writer thread; returns false if the file cannot be written
+    bool Start();
+
+    // Stops the writer thread, writes everything still queued and closes the file
+    void Shutdown();
+
+    bool IsRecording() const { return bRecording.load(std::memory_order_acquire); }
+    const FString& GetFilePath() const { return FilePath; }
+
+    // Bytes written to the file so far
+    int64 GetBytesWritten() const { return BytesWritten.load(std::memory_order_relaxed); }
+
+    // Functions to queue one record; times are FPlatformTime::Seconds
+    void RecordHeadPose(const FHeadPoseSample& Pose);
+    void RecordInput(ESessionInput Input, bool bPressed, double HostTimeSeconds);
+    void RecordSeed(ESessionSeedStream Stream, int32 Seed, double HostTimeSeconds);
+    void RecordFrame(uint64 FrameNumber, float DeltaSeconds, double HostTimeSeconds);
+    void RecordEvent(int32 Code, int32 IntValue, float FloatValue, double HostTimeSeconds);
+
+    // FRunnable interface
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    template <typename RecordType>
+    void Enqueue(ESessionRecordType Type, const RecordType& Record);
+
+    // Writes new eye samples and queued records to the file; writer thread only
+    void Drain();
+
+    FString FilePath;
+    FEyeTrackingReader EyeReader;
+    float FlushIntervalSeconds;
+
+    TUniquePtr<IFileHandle> File;
+    TArray<FEyeTrackingSample> EyeSamples;
+    TArray<uint8> Batch;
+    TQueue<TArray<uint8>, EQueueMode::Mpsc> PendingRecords;
+
+    FRunnableThread* Thread = nullptr;
+    std::atomic<bool> bStopRequested{false};
+    std::atomic<bool> bRecording{false};
+    std::atomic<int64> BytesWritten{0};
+};
@@ -0,0 +1,122 @@
+// FSessionRecording.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FEyeTrackingSample.h"
+#include "Serialization/MemoryWriter.h"
+
+// Kinds of record in a session file; values are stored in the file, so only ever append
+enum class ESessionRecordType : uint8
+{
+    EyeSample = 1,  // One raw tracker sample, all three eyes
+    HeadPose = 2,   // HMD orientation, position and angular velocity (the IMU stream)
+    Input = 3,      // A button press or release
+    Seed = 4,       // A random seed a test drew its sequence from
+    Frame = 5,      // One rendered frame
+    Event = 6       // A test-defined marker (light step, stimulus on, ...)
+};
+
+// Buttons recorded as ESessionRecordType::Input
+enum class ESessionInput : int32
+{
+    DetectStimulus = 0
+};
+
+// Random streams recorded as ESessionRecordType::Seed
+enum class ESessionSeedStream : int32
+{
+    TrialScheduler = 0
+};
+
+// Markers the eye tracking core writes as ESessionRecordType::Event; test-defined codes are zero or above
+enum class ESessionEvent : int32
+{
+    AcquisitionStarted = -1  // The eye tracking source was started; replay starts its clock here
+};
+
+// Head pose as the HMD reported it at HostTimeSeconds
+struct FHeadPoseSample
+{
+    double HostTimeSeconds = 0.0;
+    FQuat Orientation = FQuat::Identity;
+    FVector Position = FVector::ZeroVector;
+    FVector AngularVelocity = FVector::ZeroVector;
+};
+
+struct FSessionInputRecord
+{
+    double HostTimeSeconds = 0.0;
+    int32 Code = 0;
+    bool bPressed = true;
+};
+
+struct FSessionSeedRecord
+{
+    double HostTimeSeconds = 0.0;
+    int32 Stream = 0;
+    int32 Seed = 0;
+};
+
+struct FSessionFrameRecord
+{
+    double HostTimeSeconds = 0.0;
+    uint64 FrameNumber = 0;
+    float DeltaSeconds = 0.0f;
+};
+
+struct FSessionEventRecord
+{
+    double HostTimeSeconds = 0.0;
+    int32 Code = 0;
+    int32 IntValue = 0;
+    float FloatValue = 0.0f;
+};
+
+/**
+ * Layout of a session file, shared by FSessionRecorder and FSessionReplay.
+ * A file is a header (magic, version, the host time recording started at and the wall-clock start) followed
+ * by records of a one-byte type, a two-byte payload size and the payload, so readers skip types they do not
+ * know. Payloads are fixed-size and little-endian; poses and gaze are stored as floats and times as doubles on
+ * the FPlatformTime::Seconds clock. An eye sample takes 130 bytes, about 42 MB per hour at 90 Hz, and the head
+ * pose and frame marker add 74 bytes per frame, so an hour of 90 Hz tracking and rendering comes to about 66 MB.
+ * Records of one type are in time order, but different types are written by different threads and may
+ * interleave out of order.
+ */
+struct EYETRACKINGCORE_API FSessionRecording
+{
+    static constexpr uint32 Magic = 0x53535056;  // "VPSS"
+    static constexpr uint32 Version = 1;
+
+    // Header written at the start of every file
+    static void SerializeHeader(FArchive& Ar, uint32& InOutMagic, uint32& InOutVersion, double& InOutStartSeconds, int64& InOutStartTicks);
+
+    // Payload serializers; the same function writes with a saving archive and reads with a loading one
+    static void Serialize(FArchive& Ar, FEyeTrackingSample& Sample);
+    static void Serialize(FArchive& Ar, FHeadPoseSample& Pose);
+    static void Serialize(FArchive& Ar, FSessionInputRecord& Record);
+    static void Serialize(FArchive& Ar, FSessionSeedRecord& Record);
+    static void Serialize(FArchive& Ar, FSessionFrameRecord& Record);
+    static void Serialize(FArchive& Ar, FSessionEventRecord& Record);
+
+    // Appends a framed record (type, size, payload) to a byte buffer
+    template <typename RecordType>
+    static void AppendRecord(TArray<uint8>& OutBytes, ESessionRecordType Type, RecordType Record);
+
+    // Size of the type and payload-size prefix of every record
+    static constexpr int32 RecordPrefixSize = 3;
+};
+
+template <typename RecordType>
+void FSessionRecording::AppendRecord(TArray<uint8>& OutBytes, ESessionRecordType Type, RecordType Record)
+{
+    const int32 PrefixOffset = OutBytes.AddUninitialized(RecordPrefixSize);
+
+    FMemoryWriter Writer(OutBytes);
+    Writer.Seek(OutBytes.Num());
+    Serialize(Writer, Record);
+
+    const uint16 PayloadSize = static_cast<uint16>(OutBytes.Num() - PrefixOffset - RecordPrefixSize);
+    OutBytes[PrefixOffset] = static_cast<uint8>(Type);
+    FMemory::Memcpy(&OutBytes[PrefixOffset + 1], &PayloadSize, sizeof(PayloadSize));
+}
@@ -0,0 +1,66 @@
+// FSessionReplay.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FSessionRecording.h"
+
+/**
+ * A session file loaded for playback, split into one time-ordered stream per record type.
+ * FReplayEyeTrackingSource feeds the eye samples back through the acquisition service; tests look up head
+ * poses, button presses and seeds here in place of the HMD, the input bindings and the clock. Recorded times
+ * map to the live clock through BeginPlayback, which the eye source calls when it starts: that moment is lined
+ * up with the recorded acquisition start, so every stream is played back on the schedule it was recorded on
+ * relative to the point the test started tracking. Nothing here depends on the headset plugins.
+ */
+class EYETRACKINGCORE_API FSessionReplay
+{
+public:
+    // Reads and splits a session file; false if it is missing or not a session file of a known version
+    bool Load(const FString& FilePath);
+
+    const FString& GetFilePath() const { return FilePath; }
+
+    // Host time the recording started at, on the recording machine's clock
+    double GetRecordingStartSeconds() const { return RecordingStartSeconds; }
+
+    // Recorded time the live clock is anchored to: the acquisition start marker, or for files without one the
+    // first seed or frame the test recorded
+    double GetPlaybackAnchorSeconds() const { return PlaybackAnchorSeconds; }
+
+    // Marks now as the recorded acquisition start; called by the replay source when it starts
+    void BeginPlayback(double HostTimeSeconds) { PlaybackStartSeconds = HostTimeSeconds; }
+
+    bool IsPlaying() const { return PlaybackStartSeconds >= 0.0; }
+
+    // Converts a live host time into the recording's time base
+    double ToRecordedTime(double HostTimeSeconds) const { return PlaybackAnchorSeconds + (HostTimeSeconds - PlaybackStartSeconds); }
+
+    // Latest head pose recorded at or before a recorded time; false if there is none
+    bool GetHeadPoseAt(double RecordedSeconds, FHeadPoseSample& OutPose) const;
+
+    // The Index-th seed recorded for a stream (a test draws one per eye); false if there are not that many
+    bool GetSeed(ESessionSeedStream Stream, int32 Index, int32& OutSeed) const;
+
+    const TArray<FEyeTrackingSample>& GetEyeSamples() const { return EyeSamples; }
+    const TArray<FHeadPoseSample>& GetHeadPoses() const { return HeadPoses; }
+    const TArray<FSessionInputRecord>& GetInputs() const { return Inputs; }
+    const TArray<FSessionSeedRecord>& GetSeeds() const { return Seeds; }
+    const TArray<FSessionFrameRecord>& GetFrames() const { return Frames; }
+    const TArray<FSessionEventRecord>& GetEvents() const { return Events; }
+
+private:
+    FString FilePath;
+    double RecordingStartSeconds = 0.0;
+    double PlaybackAnchorSeconds = 0.0;
+
+    // Written once on the game thread before the acquisition thread starts, read-only afterwards
+    double PlaybackStartSeconds = -1.0;
+
+    TArray<FEyeTrackingSample> EyeSamples;
+    TArray<FHeadPoseSample> HeadPoses;
+    TArray<FSessionInputRecord> Inputs;
+    TArray<FSessionSeedRecord> Seeds;
+    TArray<FSessionFrameRecord> Frames;
+    TArray<FSessionEventRecord> Events;
+};
@@ -0,0 +1,70 @@
+// FSyntheticEyeTrackingSource.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IEyeTrackingSource.h"
+
+// Behaviour of the simulated observer behind an FSyntheticEyeTrackingSource
+struct EYETRACKINGCORE_API FSyntheticEyeTrackingSettings
+{
+    float RateHz = 90.0f;
+    int32 Seed = 0;
+
+    // Standard deviation of the fixational jitter around the current gaze target, in degrees
+    float NoiseDegrees = 0.1f;
+
+    // Average time between saccades, which alternate between leaving fixation and returning to it (0 disables them)
+    float SaccadeIntervalSeconds = 0.0f;
+    float SaccadeAmplitudeDegrees = 8.0f;
+    float SaccadeDurationSeconds = 0.04f;
+
+    // Average time between blinks (0 disables them) and how long the lids stay closed
+    float BlinkIntervalSeconds = 0.0f;
+    float BlinkDurationSeconds = 0.15f;
+
+    float PupilDiameter = 4.0f;
+
+    // Number of samples before the source finishes (0 runs until the service is stopped)
+    int32 MaxSamples = 0;
+};
+
+/**
+ * Deterministic eye-tracking source for headless runs.
+ * Simulates an observer fixating straight ahead (gaze along +X) with Gaussian jitter, optional saccades away
+ * from and back to fixation, and optional blinks. Everything is driven by the sample index and a seeded
+ * FRandomStream, so the same settings always produce the same stream. The device timestamp is the simulated
+ * time in nanoseconds.
+ */
+class EYETRACKINGCORE_API FSyntheticEyeTrackingSource : public IEyeTrackingSource
+{
+public:
+    explicit FSyntheticEyeTrackingSource(const FSyntheticEyeTrackingSettings& InSettings = FSyntheticEyeTrackingSettings());
+
+    // IEyeTrackingSource interface
+    virtual FString GetName() const override { return TEXT("Synthetic"); }
+    virtual float GetNativeRateHz() const override { return Settings.RateHz; }
+    virtual bool Start() override;
+    virtual void Stop() override {}
+    virtual EEyeSourcePollResult Poll(FEyeTrackingSample& OutSample) override;
+
+private:
+    // Draws the time until the next event of a process with this average interval
+    double NextEventTime(double Now, float AverageIntervalSeconds);
+
+    // Draws from the standard normal distribution
+    float Gaussian();
+
+    FSyntheticEyeTrackingSettings Settings;
+    FRandomStream Random;
+    int64 SampleIndex = 0;
+
+    // Gaze offset from straight ahead (yaw, pitch in degrees) at the start and end of the current saccade
+    FVector2D SaccadeFrom = FVector2D::ZeroVector;
+    FVector2D SaccadeTo = FVector2D::ZeroVector;
+    double SaccadeStartTime = 0.0;
+    double NextSaccadeTime = 0.0;
+
+    double BlinkEndTime = 0.0;
+    double NextBlinkTime = 0.0;
+};
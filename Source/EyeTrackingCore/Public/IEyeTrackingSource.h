@@ -0,0 +1,41 @@
+// IEyeTrackingSource.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FEyeTrackingSample.h"
+
+// Outcome of polling an IEyeTrackingSource
+enum class EEyeSourcePollResult : uint8
+{
+    Sample,     // A new sample was written
+    NoSample,   // Nothing this period (tracking lost, lids closed on some devices, ...)
+    Finished    // The source has no more data and the service should stop
+};
+
+/**
+ * Where FEyeTrackingService gets its samples from.
+ * Implementations wrap a device (PICO), generate data (synthetic) or replay a recording (file), so the same
+ * consumers run on the headset and in headless builds. Start and Stop run on the thread that starts and
+ * stops the service (the game thread in practice); Poll only runs on the acquisition thread, between the two.
+ */
+class EYETRACKINGCORE_API IEyeTrackingSource
+{
+public:
+    virtual ~IEyeTrackingSource() = default;
+
+    // Short name for logs ("Pico", "Synthetic", "File")
+    virtual FString GetName() const = 0;
+
+    // Rate at which the service should poll, in Hz; zero or less polls as fast as the source returns samples
+    virtual float GetNativeRateHz() const = 0;
+
+    // Prepares the device or data; returns false if the source cannot produce samples
+    virtual bool Start() = 0;
+
+    // Releases the device or data
+    virtual void Stop() = 0;
+
+    // Fills the next sample; timestamps on the host are added by the service
+    virtual EEyeSourcePollResult Poll(FEyeTrackingSample& OutSample) = 0;
+};
@@ -0,0 +1,113 @@
+// UEyeTrackingSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "IEyeTrackingSource.h"
+#include "FEyeSampleRing.h"
+#include "FEyeTrackingService.h"
+#include "FSessionRecorder.h"
+#include "FSessionReplay.h"
+#include "UEyeTrackingSubsystem.generated.h"
+
+/**
+ * Process-wide eye-tracking acquisition service shared by perimetry, RAPD and metamorphopsia.
+ * The first test that needs eye data starts the service; later ones reuse it. The source is chosen by
+ * SourceName ("Pico", "Synthetic" or "File"), which "-EyeTrackingSource=" overrides on the command line
+ * together with "-EyeTrackingFile=" for recordings, so headless runs can drive every test without a headset.
+ * "-RecordSession=<file>" (or bRecordSessions) records the session to a file from startup, and
+ * "-ReplaySession=<file>" replays one: the replay becomes the eye source, and tests take head pose, button
+ * presses and seeds from GetReplay() instead of the headset, so a session runs again on any machine.
+ * Tests read samples through their own FEyeTrackingReader; readers stay valid for the life of the engine,
+ * even if the service is restarted with another source.
+ */
+UCLASS(Config = Game)
+class EYETRACKINGCORE_API UEyeTrackingSubsystem : public UEngineSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // USubsystem interface
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // Returns the running service, or nullptr before the engine has initialized subsystems and after shutdown
+    static UEyeTrackingSubsystem* Get() { return Instance; }
+
+    // Starts acquisition from the configured source unless it is already running, in which case the calibration
+    // request is ignored; returns true if it is running
+    bool StartAcquisition(bool bNeedCalibration);
+
+    // Replaces the current source with this one and starts it; returns true if it is running
+    bool StartAcquisition(TUniquePtr<IEyeTrackingSource> Source);
+
+    // Stops the acquisition thread; readers keep working and simply see no new samples
+    void StopAcquisition();
+
+    bool IsAcquiring() const { return Service.IsValid() && Service->IsRunning(); }
+
+    // Name and polling rate of the running source, for logs
+    FString GetSourceName() const { return Service.IsValid() ? Service->GetSource().GetName() : FString(); }
+    float GetSourceRateHz() const { return Service.IsValid() ? Service->GetSource().GetNativeRateHz() : 0.0f; }
+
+    // How the running source's clock currently maps onto the host timeline
+    FClockSyncEstimate GetClockEstimate() const { return Service.IsValid() ? Service->GetClockEstimate() : FClockSyncEstimate(); }
+
+    // A new reader positioned after the newest sample
+    FEyeTrackingReader CreateReader() const { return FEyeTrackingReader(Ring.ToSharedRef()); }
+
+    // Starts recording the session to a file, replacing any recording in progress; returns true if it is recording
+    bool StartRecording(const FString& FilePath);
+
+    // Finishes the recording and closes its file
+    void StopRecording();
+
+    // The recording in progress, or nullptr; tests add head pose, inputs, seeds and frames to it
+    FSessionRecorder* GetRecorder() const { return Recorder.IsValid() && Recorder->IsRecording() ? Recorder.Get() : nullptr; }
+
+    // Loads a session to replay; the next StartAcquisition plays its eye samples instead of the configured source
+    bool LoadReplay(const FString& FilePath);
+
+    // The session being replayed, or nullptr
+    const FSessionReplay* GetReplay() const { return Replay.Get(); }
+
+private:
+    // Builds the source named in the config or on the command line
+    TUniquePtr<IEyeTrackingSource> CreateConfiguredSource(bool bNeedCalibration) const;
+
+    UPROPERTY(Config)
+    FString SourceName = TEXT("Pico");
+
+    // Recording replayed by the "File" source, and whether it is replayed at its recorded rate
+    UPROPERTY(Config)
+    FString SourceFile;
+
+    UPROPERTY(Config)
+    bool bReplayInRealTime = true;
+
+    // Polling rates of the headset and synthetic sources
+    UPROPERTY(Config)
+    float PicoSampleRateHz = 90.0f;
+
+    UPROPERTY(Config)
+    float SyntheticSampleRateHz = 90.0f;
+
+    // Samples kept in the ring; readers more than this far behind lose the oldest
+    UPROPERTY(Config)
+    int32 RingCapacity = 1024;
+
+    // Records every run into SessionDirectory (relative to Saved) without "-RecordSession="
+    UPROPERTY(Config)
+    bool bRecordSessions = false;
+
+    UPROPERTY(Config)
+    FString SessionDirectory = TEXT("Sessions");
+
+    TSharedPtr<FEyeSampleRing> Ring;
+    TUniquePtr<FEyeTrackingService> Service;
+    TUniquePtr<FSessionRecorder> Recorder;
+    TSharedPtr<FSessionReplay> Replay;
+
+    static UEyeTrackingSubsystem* Instance;
+};
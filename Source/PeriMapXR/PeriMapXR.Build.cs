@@ -14,14 +14,26 @@ public class PeriMapXR : ModuleRules
                 "InputCore",
                 "HeadMountedDisplay", 
                 "EyeTracker", 
-                "PICOXREyeTracker", 
-                "PICOXRHMD", 
-                "PICOXRInput", 
-                "PICOXRMR", 
-                "PICOXRMotionTracking" 
+                "EyeTrackingCore"
             }
         );
 
+        // The PICO plugins only ship for Win64 and Android; elsewhere the head pose comes from the engine's HMD
+        // interface or a replayed session (EyeTrackingCore defines WITH_PICOXR to match)
+        if (Target.Platform == UnrealTargetPlatform.Win64 || Target.Platform == UnrealTargetPlatform.Android)
+        {
+            PublicDependencyModuleNames.AddRange(
+                new string[]
+                {
+                    "PICOXREyeTracker",
+                    "PICOXRHMD",
+                    "PICOXRInput",
+                    "PICOXRMR",
+                    "PICOXRMotionTracking"
+                }
+            );
+        }
+
         PrivateDependencyModuleNames.AddRange(
             new string[] 
             {  
@@ -31,6 +43,9 @@ public class PeriMapXR : ModuleRules
             }
         );
 
+        // Normative prior database, memory-mapped at runtime, so it is staged as a loose file
+        RuntimeDependencies.Add("$(ProjectDir)/Data/PeriMapXR/NormativePriors.bin", StagedFileType.NonUFS);
+
         // Uncomment if you are using Slate UI
         // PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 
@@ -5,13 +5,12 @@
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Engine/StaticMesh.h"
 #include "UObject/ConstructorHelpers.h"
-#include "Engine/Engine.h" // For GEngine
 
 // Sets default values
 ABackgroundSphere::ABackgroundSphere()
 {
-    // Set actor to call Tick() every frame
-    PrimaryActorTick.bCanEverTick = true;
+    // Never ticks: the sphere follows the head-locked rig by attachment
+    PrimaryActorTick.bCanEverTick = false;
 
     // Create and attach the static mesh component
     MeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComponent"));
@@ -22,17 +21,11 @@ ABackgroundSphere::ABackgroundSphere()
     if (SphereMeshAsset.Succeeded())
     {
         MeshComponent->SetStaticMesh(SphereMeshAsset.Object);
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("Sphere mesh for background assigned successfully."));
-        }
+        LogManager.LogMessage(TEXT("Sphere mesh for background assigned successfully."), ELogVerbosity::Log);
     }
     else
     {
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Failed to find background sphere mesh."));
-        }
+        LogManager.LogMessage(TEXT("Failed to find background sphere mesh."), ELogVerbosity::Error);
     }
 
     // Find and assign the M_BackgroundSphere material
@@ -40,17 +33,11 @@ ABackgroundSphere::ABackgroundSphere()
     if (MaterialAsset.Succeeded())
     {
         MeshComponent->SetMaterial(0, MaterialAsset.Object);
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("M_BackgroundSphere material assigned successfully."));
-        }
+        LogManager.LogMessage(TEXT("M_BackgroundSphere material assigned successfully."), ELogVerbosity::Log);
     }
     else
     {
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Failed to find M_BackgroundSphere material."));
-        }
+        LogManager.LogMessage(TEXT("Failed to find M_BackgroundSphere material."), ELogVerbosity::Error);
     }
 }
 
@@ -58,23 +45,14 @@ ABackgroundSphere::ABackgroundSphere()
 void ABackgroundSphere::BeginPlay()
 {
     Super::BeginPlay();
-    if (GEngine)
-    {
-        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Blue, TEXT("ABackgroundSphere::BeginPlay() called."));
-    }
-}
-
-// Called every frame
-void ABackgroundSphere::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
+    LogManager.LogMessage(TEXT("ABackgroundSphere::BeginPlay() called."), ELogVerbosity::Log);
 }
 
 void ABackgroundSphere::SetScale(float Diameter)
 {
     if (MeshComponent)
     {
-        UE_LOG(LogTemp, Warning, TEXT("ABackgroundSphere.cpp=> SetScale called with Diameter: %f"), Diameter);
+        LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, true, false, true, TEXT("ABackgroundSphere.cpp=> SetScale called with Diameter: %f"), Diameter);
         // Calculate the scale factor needed to match the desired diameter
         float OriginalDiameter = 320.0f; // Original diameter of shell sphere mesh is 320 units
         float ScaleFactor = Diameter / OriginalDiameter;
@@ -82,12 +60,8 @@ void ABackgroundSphere::SetScale(float Diameter)
         MeshComponent->SetWorldScale3D(FinalScale);
 
         FVector AppliedScale = MeshComponent->GetComponentScale();
-        UE_LOG(LogTemp, Warning, TEXT("ABackgroundSphere.cpp=> Applied Scale: %s"), *AppliedScale.ToString());
+        LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, true, false, true, TEXT("ABackgroundSphere.cpp=> Applied Scale: %s"), *AppliedScale.ToString());
 
-        if (GEngine)
-        {
-            FString DebugMessage = FString::Printf(TEXT("ABackgroundSphere.cpp=> Background sphere scale set to: %s"), *FinalScale.ToString());
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, DebugMessage);
-        }
+        LogManager.LogMessagef(ELogVerbosity::Log, 5.0f, false, true, true, TEXT("ABackgroundSphere.cpp=> Background sphere scale set to: %s"), *FinalScale.ToString());
     }
 }
\ No newline at end of file
@@ -7,13 +7,12 @@
 #include "UObject/ConstructorHelpers.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/World.h"
-#include "Engine/Engine.h" // For GEngine
 
 // Sets default values
 AFixationPoint::AFixationPoint()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+    // Never ticks: the fixation point is placed once, and attached to the head-locked rig when a test runs
+    PrimaryActorTick.bCanEverTick = false;
 
     // Create and set up the static mesh component
     MeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComponent"));
@@ -24,17 +23,11 @@ AFixationPoint::AFixationPoint()
     if (SphereMeshAsset.Succeeded())
     {
         MeshComponent->SetStaticMesh(SphereMeshAsset.Object);
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("Sphere mesh for fixation point assigned successfully."));
-        }
+        LogManager.LogMessage(TEXT("Sphere mesh for fixation point assigned successfully."), ELogVerbosity::Log);
     }
     else
     {
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Failed to find mesh for fixation point."));
-        }
+        LogManager.LogMessage(TEXT("Failed to find mesh for fixation point."), ELogVerbosity::Error);
     }
 
     // Find and assign the M_FixationPoint material
@@ -42,17 +35,11 @@ AFixationPoint::AFixationPoint()
     if (MaterialAsset.Succeeded())
     {
         MeshComponent->SetMaterial(0, MaterialAsset.Object);
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("M_FixationPoint material assigned successfully."));
-        }
+        LogManager.LogMessage(TEXT("M_FixationPoint material assigned successfully."), ELogVerbosity::Log);
     }
     else
     {
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Failed to find M_FixationPoint material."));
-        }
+        LogManager.LogMessage(TEXT("Failed to find M_FixationPoint material."), ELogVerbosity::Error);
     }
 }
 
@@ -74,28 +61,11 @@ void AFixationPoint::BeginPlay()
     }
 }
 
-// Called every frame
-void AFixationPoint::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-    if (APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
-    {
-        FVector PlayerViewLocation;
-        FRotator PlayerViewRotation;
-        PlayerController->GetPlayerViewPoint(PlayerViewLocation, PlayerViewRotation);
-
-        // Set the fixation point position in front of the player's view
-        FVector FixationPointPosition = PlayerViewLocation + PlayerViewRotation.Vector() * DistanceFromPlayer;
-        SetActorLocation(FixationPointPosition);
-    }
-}
-
 void AFixationPoint::SetScale(float DesiredDiameter)
 {
     if (MeshComponent)
     {
-        UE_LOG(LogTemp, Warning, TEXT("AFixationPoint.cpp=> SetScale called with Desired Diameter: %f"), DesiredDiameter);
+        LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, true, false, true, TEXT("AFixationPoint.cpp=> SetScale called with Desired Diameter: %f"), DesiredDiameter);
         // Calculate the scale factor needed to match the desired diameter
         float OriginalDiameter = 100.0f; // Original diameter of UE sphere mesh is 100 units
         float ScaleFactor = DesiredDiameter / OriginalDiameter;
@@ -103,12 +73,8 @@ void AFixationPoint::SetScale(float DesiredDiameter)
         MeshComponent->SetWorldScale3D(FinalScale);
 
         FVector AppliedScale = MeshComponent->GetComponentScale();
-        UE_LOG(LogTemp, Warning, TEXT("AFixationPoint.cpp=> Applied Scale: %s"), *AppliedScale.ToString());
+        LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, true, false, true, TEXT("AFixationPoint.cpp=> Applied Scale: %s"), *AppliedScale.ToString());
 
-        if (GEngine)
-        {
-            FString DebugMessage = FString::Printf(TEXT("AFixationPoint.cpp=> Fixation point scale set to: %s"), *FinalScale.ToString());
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, DebugMessage);
-        }
+        LogManager.LogMessagef(ELogVerbosity::Log, 5.0f, false, true, true, TEXT("AFixationPoint.cpp=> Fixation point scale set to: %s"), *FinalScale.ToString());
     }
 }
\ No newline at end of file
@@ -12,8 +12,8 @@
 // Sets default values
 AStimuli::AStimuli()
 {
-    // Set this actor to call Tick() every frame
-    PrimaryActorTick.bCanEverTick = true;
+    // Never ticks: stimuli only change when the test asks them to
+    PrimaryActorTick.bCanEverTick = false;
 
     // Initialize max luminance and brightness values
     MaxLuminanceNits = 60.0f; // Max luminance of the Pico 4 in nits
@@ -77,12 +77,6 @@ void AStimuli::BeginPlay()
     }
 }
 
-// Called every frame
-void AStimuli::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
-}
-
 // Function to set the scale of the visual stimulus
 void AStimuli::SetScale(float DesiredDiameter)
 {
@@ -95,8 +89,7 @@ void AStimuli::SetScale(float DesiredDiameter)
         MeshComponent->SetWorldScale3D(FinalScale);
 
         FVector AppliedScale = MeshComponent->GetComponentScale();
-        LogMessage = FString::Printf(TEXT("AStimuli::Stimuli scale set to : % s"), *FinalScale.ToString());
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        LogManager.LogMessagef(ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("AStimuli::Stimuli scale set to : % s"), *FinalScale.ToString());
     }
 }
 
@@ -114,8 +107,7 @@ void AStimuli::SetBrightnessFromDb(float dBValue)
         // Apply the brightness to the material's scalar parameter
         DynamicMaterial->SetScalarParameterValue(TEXT("Brightness"), BrightnessValue);
 
-        LogMessage = FString::Printf(TEXT("AStimuli::Stimuli brightness set to: %f dB"), dBValue);
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        LogManager.LogMessagef(ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("AStimuli::Stimuli brightness set to: %f dB"), dBValue);
     }
     else
     {
@@ -130,7 +122,6 @@ void AStimuli::SetVisibility(bool bVisible)
     if (MeshComponent)
     {
         MeshComponent->SetVisibility(bVisible);
-        LogMessage = FString::Printf(TEXT("AStimuli::Stimuli is now: %s"), bVisible ? TEXT("Visible") : TEXT("Hidden"));
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        LogManager.LogMessagef(ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("AStimuli::Stimuli is now: %s"), bVisible ? TEXT("Visible") : TEXT("Hidden"));
     }
 }
\ No newline at end of file
@@ -2,31 +2,62 @@
 
 #include "ATestStimuli.h"
 #include "UThresholdEstimator.h"
-#include "AStimuli.h"
 #include "AFixationPoint.h"
 #include "ABackgroundSphere.h"
 #include "FTestResults.h"
 #include "Engine/World.h"
+#include "Engine/GameInstance.h"
 #include "GameFramework/PlayerController.h"
 #include "Kismet/GameplayStatics.h"
 #include "TimerManager.h"
-#include "PXR_MotionTracking.h"
-#include "PXR_MotionTrackingTypes.h" 
+#if WITH_PICOXR
 #include "PXR_HMDFunctionLibrary.h"
+#endif
+#include "HeadMountedDisplayFunctionLibrary.h"
 #include "EyeTrackerFunctionLibrary.h"
 #include "Camera/CameraComponent.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
 #include "FLogManager.h"
+#include "FStructuredLog.h"
+#include "FNormativePriorDatabase.h"
+#include "FTestPatternLibrary.h"
+#include "IVisualFieldHistoryProvider.h"
+#include "UEyeTrackingSubsystem.h"
+#include "HAL/PlatformTime.h"
 
 // Constructor sets default values for properties and initializes eye tracking and test settings
 ATestStimuli::ATestStimuli()
 {
+    // Presentations are shown and hidden on frame boundaries from Tick
+    PrimaryActorTick.bCanEverTick = true;
+
     // Initialize default test parameters. These values are set based on standard visual field tests.
     TestType = ETestType::TEST_24_2;  // Default test type: 24-2, commonly used in visual field tests
+    StimulusSelectionStrategy = EStimulusSelectionStrategy::PosteriorMean;  // Present at the posterior mean unless configured otherwise
+    PatientAgeYears = 0;              // Unknown age: the estimator starts from uniform priors
     TestState = ETestState::Idle;     // The test starts in the idle state, no stimuli presented initially
     StimuliDuration = 0.2f;           // Default duration of each stimulus, set to 200ms for visual threshold assessment
     TimeBetweenStimuli = 1.0f;        // Time between stimuli presentation to prevent overlap
+    bSpeculateNextTrial = true;       // Prepare the next trial while each stimulus is showing
+    DisplayRefreshRateHz = 90.0f;     // Pico 4 default display refresh rate
+    PresentationToleranceFrames = 0.5f;  // Flag presentations more than half a frame off the requested duration
+    GazeFilterType = EGazeFilterType::MovingAverage;
+    GazeFilterWindowSamples = 45;     // Half a second at the tracker's 90 Hz, the span the old 10 Hz buffer covered
+    GazeFilterMinCutoffHz = 1.0f;     // One Euro settings for fixation: heavy smoothing at rest
+    GazeFilterBeta = 0.5f;
+    GazeFilterTimeConstant = 0.1f;
+    SaccadeVelocityThreshold = 30.0f; // Common I-VT threshold; fixational jitter stays well below it
+    FixationLossPauseSeconds = 1.0f;  // Saccades and blinks are over long before this
+    StimulusResponseWindow = 0.0f;    // Set for each trial in RunTest
     RetestCount = 3;                  // Number of retests for stimuli near threshold to ensure accuracy
     RetestProbability = 0.1f;         // Probability that a stimulus is retested
+    MinStimulusSeparationDegrees = 12.0f;  // Consecutive stimuli are at least this far apart
+    CatchTrialProbability = 0.1f;     // Probability that a trial is a catch trial
+    MaxPresentationsPerLocation = 12; // Cap on presentations at a location that never converges
+    MaxRejectionsPerLocation = 3;     // Cap on retests of a location after a saccade or blink
+    RandomSeed = 0;                   // A new presentation order every test unless one is requested
     bIsDemoMode = false;              // By default, the demo mode is disabled; real eye-tracking data is used
     bIsLeftEye = true;                // Start with the left eye, as is standard in most vision tests
     ConsecutiveMisses = 0;            // Track missed stimuli to adjust the test dynamically
@@ -41,12 +72,27 @@ ATestStimuli::ATestStimuli()
     bIsEyeTrackingSupported = false;
     bIsEyeTrackingActive = false;
 
-    // Predefine settings for different test types (e.g., 24-2 and 10-2), defining degrees and spacing between stimuli
-    TestSettingsMap.Add(ETestType::TEST_10_2, FTestSettings(55.0f, 2.0f, 0.5f, 6.0f, 68, 15.0f, 15.0f));
-    TestSettingsMap.Add(ETestType::TEST_24_2, FTestSettings(133.5f, 2.0f, 0.5f, 6.0f, 54, 24.0f, 24.0f));
+    // Predefine settings for each test type; the point coordinates themselves come from FTestPatternLibrary
+    TestSettingsMap.Add(ETestType::TEST_10_2, FTestSettings(55.0f, 2.0f, 0.5f, 2.0f, 68, 10.0f, 10.0f));
+    TestSettingsMap.Add(ETestType::TEST_24_2, FTestSettings(133.5f, 2.0f, 0.5f, 6.0f, 54, 21.0f, 27.0f));
+    TestSettingsMap.Add(ETestType::TEST_30_2, FTestSettings(133.5f, 2.0f, 0.5f, 6.0f, 76, 27.0f, 27.0f));
+    TestSettingsMap.Add(ETestType::TEST_60_4, FTestSettings(133.5f, 2.0f, 0.5f, 12.0f, 60, 54.0f, 54.0f));
 
     // Initialize ThresholdEstimator for tracking and managing threshold estimation
     ThresholdEstimator = CreateDefaultSubobject<UThresholdEstimator>(TEXT("ThresholdEstimator"));
+
+    // Head-locked rig: attached to the camera at SetupTest, carrying the fixation point, background and stimuli
+    RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+    HeadLockedRig = CreateDefaultSubobject<USceneComponent>(TEXT("HeadLockedRig"));
+    HeadLockedRig->SetupAttachment(RootComponent);
+    HeadLockedRig->PrimaryComponentTick.bCanEverTick = false;
+
+    // A single instanced mesh draws every stimulus, centred on the fixation point. Pattern locations have the
+    // horizontal along X, the vertical along Y and the line of sight along Z, so map them onto the camera's right,
+    // up and forward axes
+    StimulusField = CreateDefaultSubobject<UStimulusFieldComponent>(TEXT("StimulusField"));
+    StimulusField->SetupAttachment(HeadLockedRig);
+    StimulusField->SetRelativeLocationAndRotation(FVector(FixationDistance, 0.0f, 0.0f), FRotationMatrix::MakeFromXY(FVector::RightVector, FVector::UpVector).Rotator());
 }
 
 // Called when the game starts. Initializes the eye tracking and sets up the test environment.
@@ -69,22 +115,24 @@ void ATestStimuli::BeginPlay()
     // Set up the test parameters and environment (e.g., fixation point, stimuli locations) for the first eye
     SetupTest(TestType);
 
-    // Initialize LastFixationPosition to the starting position of the fixation actor
-    if (FixationActor)
+    // Seed from the patient's previous visit when the game instance keeps their history
+    if (PreviousVisitResultsFile.IsEmpty())
     {
-        LastFixationPosition = FixationActor->GetActorLocation();
+        if (const IVisualFieldHistoryProvider* History = Cast<IVisualFieldHistoryProvider>(GetGameInstance()))
+        {
+            PreviousVisitResultsFile = History->GetPreviousVisualFieldFile();
+        }
     }
+    ResultsFilePath = FPaths::ProjectSavedDir() / TEXT("VisualFields") / FString::Printf(TEXT("VisualField_%s.csv"), *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")));
 
-    // Initialize the threshold estimator
-    FTestSettings TestSettings = *TestSettingsMap.Find(TestType);
-    ThresholdEstimator->Initialize(TestSettings, TestType, bIsLeftEye);
+    // StartTest initializes the threshold estimator for the first eye
 
     // Start the test and monitor eye gaze to check if the participant is focused on the fixation point
     StartTest();
     GetWorld()->GetTimerManager().SetTimer(GazeCheckTimerHandle, [this]() { CheckGazeFocus(); }, 0.1f, true);
 }
 
-// Called every frame to update the position of dynamic elements such as the fixation point.
+// Called every frame to monitor frame latency.
 void ATestStimuli::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
@@ -92,110 +140,48 @@ void ATestStimuli::Tick(float DeltaTime)
     // Call MonitorLatency() to track any hardware or performance delays
     MonitorLatency();
 
-    // Ensure the test is running and the fixation actor is valid
-    if (TestState == ETestState::Running && FixationActor)
-    {
-        // Get the user's current camera location and rotation
-        AActor* PICOXRPawnActor = UGameplayStatics::GetActorOfClass(GetWorld(), PICOXRPawnClass);
-        if (PICOXRPawnActor)
-        {
-            UCameraComponent* CameraComponent = PICOXRPawnActor->FindComponentByClass<UCameraComponent>();
-            if (CameraComponent)
-            {
-                FVector CameraLocation = CameraComponent->GetComponentLocation();
-                FRotator CameraRotation = CameraComponent->GetComponentRotation();
-
-                // Update the fixation point location to stay a fixed distance from the user's camera
-                FVector NewFixationLocation = CameraLocation + CameraRotation.Vector() * 30.0f;  // 30cm ahead of the user
+    // Record this frame for later replay, and feed in the button presses of a replayed session
+    RecordFrame(DeltaTime);
+    DispatchReplayedInputs();
 
-                // Set the updated location for the fixation actor
-                FixationActor->SetActorLocation(NewFixationLocation);
+    // Put the current stimulus up or take it down on this frame's boundary
+    AdvancePresentation();
 
-                // If the fixation point has moved update the stimuli positions accordingly
-                if (FixationActorMoved())
-                {
-                    // Update stimuli positions only when the fixation point has moved
-                    UpdateStimuliPositions();
-
-                    // Update the last known position to the current one
-                    LastFixationPosition = FixationActor->GetActorLocation();
-                }
-            }
-        }
-    }
+    // The fixation point, background and stimuli follow the camera through the head-locked rig, so nothing is repositioned here
 }
 
 // Checks and configures the eye-tracking system for compatibility and activation
 void ATestStimuli::InitializeEyeTracking()
 {
-    // Check if the device supports eye tracking. This ensures the test can proceed with valid data.
-    bool bSupportSuccess = PICOXRMotionTracking::GetEyeTrackingSupported(bIsEyeTrackingSupported, SupportedModes);
-    if (bSupportSuccess && bIsEyeTrackingSupported)
-    {
-        bool bSupportsBothEyes = false;
-        for (const EPXREyeTrackingMode& Mode : SupportedModes)
-        {
-            if (Mode == EPXREyeTrackingMode::PXR_ETM_BOTH)
-            {
-                bSupportsBothEyes = true;
-                break;
-            }
-        }
-
-        if (bSupportsBothEyes)
-        {
-            // Now start the eye tracking service
-            FPXREyeTrackingStartInfo StartInfo;
-            StartInfo.StartMode = EPXREyeTrackingMode::PXR_ETM_BOTH; // Start tracking for both eyes
-            StartInfo.NeedCalibration = true;
-
-            bool bStartSuccess = PICOXRMotionTracking::StartEyeTracking(StartInfo);
-
-            if (bStartSuccess)
-            {
-                LogMessage = "Eye tracking service started successfully.";
-                LogManager.LogMessage(LogMessage, ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-            }
-            else
-            {
-                LogMessage = "Failed to start eye tracking service.";
-                LogManager.LogMessage(LogMessage, ELogVerbosity::Error, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-                return;
-            }
-
-            // Check if eye tracking is active.
-            bool bTrackingSuccess = PICOXRMotionTracking::GetEyeTrackingState(bIsEyeTrackingActive, TrackingState);
-
-            if (bTrackingSuccess && bIsEyeTrackingActive && TrackingState.CurrentTrackingMode == EPXREyeTrackingMode::PXR_ETM_BOTH)
-            {
-                LogMessage = "Eye tracking is active and operational.";
-                LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-            }
-            else
-            {
-                LogMessage = "Eye tracking is not currently active or failed to retrieve state.";
-                LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-            }
-
-            // Setup the eye tracking data request to gather real-time position and orientation data.
-            GetInfo.DisplayTime = 0;  // Use predicted frame time for smoother gaze tracking
-            GetInfo.QueryPosition = true;
-            GetInfo.QueryOrientation = true;
-        }
-        else
-        {
-            LogMessage = "Eye tracking is supported, but not for both eyes.";
-            LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-            return;
-        }
-    }
-    else
+    // The shared acquisition service owns the tracker; it starts it (with calibration) for the first test that asks
+    UEyeTrackingSubsystem* EyeTracking = UEyeTrackingSubsystem::Get();
+    bIsEyeTrackingSupported = EyeTracking && EyeTracking->StartAcquisition(true);
+    if (!bIsEyeTrackingSupported)
     {
         // If unsupported, log a warning and proceed with the test in demo mode.
-        LogMessage = "Eye tracking is not supported or API call failed.";
+        LogMessage = "Eye tracking is not supported for both eyes or the eye tracking service failed to start.";
         LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
         return;
     }
+
+    // Read only the samples published from now on
+    GazeReader = EyeTracking->CreateReader();
+
+    FGazeFilterSettings FilterSettings;
+    FilterSettings.Type = GazeFilterType;
+    FilterSettings.WindowSamples = GazeFilterWindowSamples;
+    FilterSettings.MinCutoffHz = GazeFilterMinCutoffHz;
+    FilterSettings.Beta = GazeFilterBeta;
+    FilterSettings.TimeConstantSeconds = GazeFilterTimeConstant;
+    GazeFilter.Configure(FilterSettings);
+    bHasGazeSample = false;
+
+    FGazeClassifierSettings ClassifierSettings;
+    ClassifierSettings.SaccadeVelocityThreshold = SaccadeVelocityThreshold;
+    GazeClassifier.Configure(ClassifierSettings);
+    FixationLostSince = -1.0;
+
+    LogManager.LogMessagef(ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Eye tracking service started successfully (%s, %.0f Hz)."), *EyeTracking->GetSourceName(), EyeTracking->GetSourceRateHz());
 }
 
 // Configures the test environment for the specified test type (e.g., 24-2, 10-2)
@@ -215,16 +201,19 @@ void ATestStimuli::SetupTest(ETestType NewTestType)
             UCameraComponent* CameraComponent = PICOXRPawnActor->FindComponentByClass<UCameraComponent>();
             if (CameraComponent)
             {
-                FVector CameraLocation = CameraComponent->GetComponentLocation();
-                FRotator CameraRotation = CameraComponent->GetComponentRotation();
+                // Lock the rig to the camera; everything on it follows the head by attachment from here on
+                HeadLockedRig->AttachToComponent(CameraComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+                const FVector FixationOffset(FixationDistance, 0.0f, 0.0f);
+                const FTransform& RigTransform = HeadLockedRig->GetComponentTransform();
 
-                // Calculate fixation point's position 30cm in front of the users camera
-                FVector FixationLocation = CameraLocation + CameraRotation.Vector() * 30.0f;
-
-                // Spawn and scale the fixation point based on the test settings
+                // Spawn the fixation point on the rig the first time, then just rescale it for the test settings
                 if (FixationActorClass)
                 {
-                    FixationActor = GetWorld()->SpawnActor<AFixationPoint>(FixationActorClass, FixationLocation, FRotator::ZeroRotator);
+                    if (!FixationActor)
+                    {
+                        FixationActor = GetWorld()->SpawnActor<AFixationPoint>(FixationActorClass, RigTransform.TransformPosition(FixationOffset), RigTransform.Rotator());
+                        AttachToHeadLockedRig(FixationActor, FixationOffset);
+                    }
                     FixationActor->SetScale(Settings.FixationPointDiameter);
                 }
                 else
@@ -233,14 +222,17 @@ void ATestStimuli::SetupTest(ETestType NewTestType)
                     LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
                 }
 
-                // Spawn and scale the background sphere that encapsulates stimuli
+                // Spawn and scale the background sphere that encapsulates stimuli, centred on the camera
                 if (BackgroundSphereActorClass)
                 {
-                    BackgroundSphereActor = GetWorld()->SpawnActor<ABackgroundSphere>(BackgroundSphereActorClass, CameraLocation, FRotator::ZeroRotator);
+                    if (!BackgroundSphereActor)
+                    {
+                        BackgroundSphereActor = GetWorld()->SpawnActor<ABackgroundSphere>(BackgroundSphereActorClass, RigTransform.GetLocation(), RigTransform.Rotator());
+                        AttachToHeadLockedRig(BackgroundSphereActor, FVector::ZeroVector);
+                    }
                     float BackgroundSphereScale(Settings.StimuliRadius * 10);  // Ensure the sphere encompasses all stimuli
                     BackgroundSphereActor->SetScale(BackgroundSphereScale);
-                    LogMessage = FString::Printf(TEXT("BackgroundSphere Scale: %s"), *BackgroundSphereActor->GetActorScale3D().ToString());
-                    LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+                    LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("BackgroundSphere Scale: %s"), *BackgroundSphereActor->GetActorScale3D().ToString());
                 }
                 else
                 {
@@ -248,12 +240,14 @@ void ATestStimuli::SetupTest(ETestType NewTestType)
                     LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
                 }
 
-                // Spawn and orient the converging lines actor, ensuring it points toward the fixation point
+                // Spawn the converging lines at the fixation point, pointing along the line of sight
                 if (ConvergingLinesActorClass)
                 {
-                    ConvergingLinesActor = GetWorld()->SpawnActor<AActor>(ConvergingLinesActorClass, FixationLocation, FRotator::ZeroRotator);
-                    FVector DirectionToFixation = FixationActor->GetActorLocation() - ConvergingLinesActor->GetActorLocation();
-                    ConvergingLinesActor->SetActorRotation(DirectionToFixation.Rotation());
+                    if (!ConvergingLinesActor)
+                    {
+                        ConvergingLinesActor = GetWorld()->SpawnActor<AActor>(ConvergingLinesActorClass, RigTransform.TransformPosition(FixationOffset), RigTransform.Rotator());
+                        AttachToHeadLockedRig(ConvergingLinesActor, FixationOffset);
+                    }
                     SetConvergingLinesScale();  // Scale the lines relative to the background sphere
                 }
                 else
@@ -262,42 +256,20 @@ void ATestStimuli::SetupTest(ETestType NewTestType)
                     LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
                 }
 
-                // Prepare the locations for stimuli presentation, ensuring appropriate spacing and coverage
-                StimuliLocations.Empty();
-                StimuliActors.Empty();
-
-                for (int32 i = 0; i < Settings.NumStimuli; ++i)
-                {
-                    // Distribute stimuli evenly across the angular range
-                    float VerticalAngle = FMath::RandRange(-Settings.MaxVerticalAngle, Settings.MaxVerticalAngle);
-                    float HorizontalAngle = FMath::RandRange(-Settings.MaxHorizontalAngle, Settings.MaxHorizontalAngle);
+                // Take the standard grid for this test and eye from the pattern library; positions are cached per
+                // eye and radius, so setting up again (or for the other eye) only copies them
+                StimuliLocations = FTestPatternLibrary::GetLocations(TestType, bIsLeftEye, Settings.StimuliRadius);
+                StimuliLocationIds.Empty();
 
-                    FVector RelativeLocation = PolarToCartesian(Settings.StimuliRadius, FMath::DegreesToRadians(VerticalAngle), FMath::DegreesToRadians(HorizontalAngle));
-                    StimuliLocations.Add(RelativeLocation);
+                // One instance per location on the stimulus field, all hidden until flashed
+                const double FieldStartSeconds = FPlatformTime::Seconds();
+                StimulusField->SetStimuli(StimuliLocations, Settings.StimuliDiameter);
+                LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Stimulus field set up with %d stimuli in %.3f ms."), StimulusField->GetNumStimuli(), (FPlatformTime::Seconds() - FieldStartSeconds) * 1000.0);
 
-                    if (StimuliActorClass)
-                    {
-                        FActorSpawnParameters SpawnParams;
-                        AStimuli* NewStimulus = GetWorld()->SpawnActor<AStimuli>(StimuliActorClass, FixationLocation + RelativeLocation, FRotator::ZeroRotator, SpawnParams);
-                        if (NewStimulus)
-                        {
-                            NewStimulus->bEnableConsoleMessages = bEnableConsoleMessages;
-                            NewStimulus->bEnableOnScreenMessages = bEnableOnScreenMessages;
-                            NewStimulus->bEnableSaveToLog = bEnableSaveToLog;
-                            NewStimulus->SetVisibility(false);
-                            NewStimulus->SetScale(Settings.StimuliDiameter);
-                            StimuliActors.Add(NewStimulus);
-
-                            // Debug message for confirmation
-                            LogMessage = FString::Printf(TEXT("Stimulus %d spawned at location: %s"), i, *(FixationLocation + RelativeLocation).ToString());
-                            LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-                        }
-                    }
-                    else
-                    {
-                        LogMessage = "StimuliActor is null.";
-                        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-                    }
+                // Assign dense IDs so the trial loop addresses estimator state by index rather than by vector
+                if (ThresholdEstimator)
+                {
+                    StimuliLocationIds = ThresholdEstimator->RegisterLocations(StimuliLocations);
                 }
             }
         }
@@ -315,19 +287,56 @@ void ATestStimuli::StartTest()
     }
 
     // Log that the test is starting
-    LogMessage = FString::Printf(TEXT("Starting the test for the %s eye."), bIsLeftEye ? TEXT("left") : TEXT("right"));
-    LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+    LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Starting the test for the %s eye."), bIsLeftEye ? TEXT("left") : TEXT("right"));
 
     // Set the test state to running, which triggers stimuli generation
     TestState = ETestState::Running;
 
-    // Initialize threshold estimator for the current eye
+    // Initialize threshold estimator for the current eye, once nothing is still computing from its old state
+    TrialPlanner.Cancel();
+    PlannedTrial = FPlannedTrial();
+    PresentationScheduler.Cancel();
+    PresentationScheduler.Configure(DisplayRefreshRateHz, PresentationToleranceFrames);
     if (ThresholdEstimator)
     {
         FTestSettings TestSettings = *TestSettingsMap.Find(TestType);
+        ThresholdEstimator->SelectionStrategy = StimulusSelectionStrategy;
+        ThresholdEstimator->PatientAgeYears = PatientAgeYears;
+        ThresholdEstimator->PreviousVisitResultsFile = PreviousVisitResultsFile;
         ThresholdEstimator->Initialize(TestSettings, TestType, bIsLeftEye);
     }
 
+    // Schedule presentations over the new pattern; every location starts at maximum uncertainty
+    FTrialSchedulerSettings SchedulerSettings;
+    SchedulerSettings.MinSeparationDegrees = MinStimulusSeparationDegrees;
+    SchedulerSettings.CatchTrialProbability = CatchTrialProbability;
+    SchedulerSettings.MaxPresentationsPerLocation = MaxPresentationsPerLocation;
+    SchedulerSettings.MaxRejectionsPerLocation = MaxRejectionsPerLocation;
+
+    // Every test runs from an explicit seed: a replay reuses the recorded one, and a recording keeps it
+    UEyeTrackingSubsystem* EyeTracking = UEyeTrackingSubsystem::Get();
+    const FSessionReplay* Replay = EyeTracking ? EyeTracking->GetReplay() : nullptr;
+    int32 Seed = RandomSeed;
+    if (!(Replay && Replay->GetSeed(ESessionSeedStream::TrialScheduler, TestsStarted, Seed)) && Seed == 0)
+    {
+        // Never zero, which the scheduler would replace with an unrecorded seed of its own
+        Seed = static_cast<int32>(FPlatformTime::Cycles() | 1);
+    }
+    if (FSessionRecorder* Recorder = EyeTracking ? EyeTracking->GetRecorder() : nullptr)
+    {
+        Recorder->RecordSeed(ESessionSeedStream::TrialScheduler, Seed, FPlatformTime::Seconds());
+    }
+    ++TestsStarted;
+    SchedulerSettings.RandomSeed = Seed;
+
+    // How well eye samples line up with stimulus frames, for judging the timing in this test's results
+    if (EyeTracking && EyeTracking->IsAcquiring())
+    {
+        const FClockSyncEstimate Clock = EyeTracking->GetClockEstimate();
+        LogManager.LogMessagef(ELogVerbosity::Log, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Eye tracker clock offset %.6f s, drift %.1f ppm, alignment error %.2f ms."), Clock.OffsetSeconds, Clock.DriftPpm, Clock.ErrorSeconds * 1000.0);
+    }
+    TrialScheduler.Reset(StimuliLocations, SchedulerSettings);
+
     // Generate the stimuli pattern and start presenting them to the user
     RunTest();
 }
@@ -342,8 +351,11 @@ void ATestStimuli::StopTest()
         return;
     }
 
-    // Stop stimuli presentation and clear timers
+    // Stop stimuli presentation and clear timers, and drop any trial prepared in advance
     GetWorld()->GetTimerManager().ClearTimer(StimuliPresentationTimerHandle);
+    TrialPlanner.Cancel();
+    PlannedTrial = FPlannedTrial();
+    PresentationScheduler.Cancel();
 
     // Clean up all spawned stimuli
     CleanupStimuli();
@@ -378,19 +390,23 @@ void ATestStimuli::StopTest()
 // Temporarily halts the stimuli presentation and test progression
 void ATestStimuli::PauseTest()
 {
+    // A trial interrupted while showing or awaiting its response is abandoned; the scheduler re-queues its location
+    if (TestState == ETestState::WaitingForInput)
+    {
+        PresentationScheduler.Cancel();
+        GetWorld()->GetTimerManager().ClearTimer(StimulusResponseTimerHandle);
+        TrialPlanner.Cancel();
+        PlannedTrial = FPlannedTrial();
+        GetWorld()->GetTimerManager().SetTimer(StimuliPresentationTimerHandle, this, &ATestStimuli::RunTest, TimeBetweenStimuli, false);
+    }
+
     TestState = ETestState::Paused;
     GetWorld()->GetTimerManager().PauseTimer(StimuliPresentationTimerHandle);
     GetWorld()->GetTimerManager().PauseTimer(StimulusResponseTimerHandle);
     GetWorld()->GetTimerManager().PauseTimer(CatchTrialTimerHandle);
 
-    // Hide any visible stimuli using SetVisibility
-    for (AStimuli* Stimulus : StimuliActors)
-    {
-        if (Stimulus)
-        {
-            Stimulus->SetVisibility(false);
-        }
-    }
+    // Hide any visible stimuli
+    StimulusField->HideAllStimuli();
     LogMessage = "Test paused.";
     LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
 }
@@ -409,27 +425,21 @@ void ATestStimuli::ResumeTest()
 // Handles the logic of presenting each stimulus and checking for user response
 void ATestStimuli::RunTest()
 {
-    LogMessage = FString::Printf(TEXT("RunTest called with CurrentStimulusIndex: %d"), CurrentStimulusIndex);
-    LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-
     // Ensure that the test is running and hasn't reached the end of stimuli
     if (TestState != ETestState::Running || bIsTestPaused)
     {
-        LogMessage = FString::Printf(TEXT("RunTest exiting: TestState=%d, bIsTestPaused=%d"), (int32)TestState, bIsTestPaused);
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("RunTest exiting: TestState=%d, bIsTestPaused=%d"), (int32)TestState, bIsTestPaused);
         return;
     }
 
-    // Check if all stimuli have been processed for the current eye
-    if (CurrentStimulusIndex >= StimuliLocations.Num())
+    // Check if every location has met its stopping rule for the current eye
+    if (TrialScheduler.IsFinished())
     {
-        LogMessage = "All stimuli processed for current eye.";
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("All stimuli processed for current eye after %d presentations."), TrialScheduler.GetNumPresentations());
         // If testing for the left eye is complete, switch to the right eye or end the test
         if (bIsLeftEye)
         {
-            SwitchEye();
-            RunTest();  // Start testing for the right eye
+            SwitchEye();  // Restarts the test, and RunTest, for the right eye
         }
         else
         {
@@ -438,6 +448,18 @@ void ATestStimuli::RunTest()
         return;
     }
 
+    // Occasionally present nothing to catch false positives; the catch trial schedules the next RunTest itself
+    if (CheckForFalsePositives())
+    {
+        return;
+    }
+
+    // Present the location we currently know least about; usually already chosen while the last stimulus was showing
+    const FPlannedTrial Trial = PlannedTrial;
+    PlannedTrial = FPlannedTrial();
+    CurrentStimulusIndex = Trial.IsValid() ? Trial.StimulusIndex : TrialScheduler.PopNext();
+    FStructuredLog::Get().Log(EStructuredLogFormat::TrialStart, CurrentStimulusIndex);
+
     // Check if the CurrentStimulusIndex is within bounds
     if (!StimuliLocations.IsValidIndex(CurrentStimulusIndex))
     {
@@ -447,14 +469,15 @@ void ATestStimuli::RunTest()
         return;
     }
 
-    FVector Location = StimuliLocations[CurrentStimulusIndex];
+    const int32 StimulusIndex = CurrentStimulusIndex;
+    FVector Location = StimuliLocations[StimulusIndex];
+    const int32 LocationId = StimuliLocationIds.IsValidIndex(CurrentStimulusIndex) ? StimuliLocationIds[CurrentStimulusIndex] : INDEX_NONE;
 
     // Get the next stimulus intensity from the threshold estimator
-    float StimulusIntensityInDb = ThresholdEstimator ? ThresholdEstimator->GetNextStimulusIntensityInDb(Location) : 20.0f;
+    float StimulusIntensityInDb = Trial.IsValid() ? Trial.IntensityInDb : (ThresholdEstimator ? ThresholdEstimator->GetNextStimulusIntensityInDbById(LocationId) : 20.0f);
 
     // Debugging: Log the intensity returned by ThresholdEstimator
-    LogMessage = FString::Printf(TEXT("ThresholdEstimator returned intensity %f dB for location %s"), StimulusIntensityInDb, *Location.ToString());
-    LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+    FStructuredLog::Get().Log(EStructuredLogFormat::TrialIntensity, StimulusIntensityInDb, Location);
 
 
     // Adjust StimuliDuration and TimeBetweenStimuli for latency
@@ -466,33 +489,87 @@ void ATestStimuli::RunTest()
     // Set the state to waiting for input
     TestState = ETestState::WaitingForInput;
 
-    // Set a timer to handle the user's response after the stimulus presentation
-    GetWorld()->GetTimerManager().SetTimer(StimulusResponseTimerHandle, [this, Location]()
+    // Work out the following trial for both responses while this one is on screen
+    if (ThresholdEstimator && bSpeculateNextTrial)
     {
-        LogMessage = FString::Printf(TEXT("Response handling lambda called for stimulus at location: %s"), *Location.ToString());
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        TrialPlanner.Begin(*ThresholdEstimator, TrialScheduler, StimuliLocationIds, StimulusIndex, StimulusIntensityInDb);
+    }
 
+    // Handle the user's response once the stimulus has come down and the response window has passed
+    StimulusResponseWindow = AdjustedStimuliDuration;
+    StimulusResponseDelegate = FTimerDelegate::CreateLambda([this, StimulusIndex, Location, LocationId, StimulusIntensityInDb]()
+    {
         // Ensure that the test is still waiting for input
         if (TestState != ETestState::WaitingForInput || bIsTestPaused)
         {
-            LogMessage = FString::Printf(TEXT("Exiting response handler: TestState=%d, bIsTestPaused=%d"), (int32)TestState, bIsTestPaused);
-            LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+            LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Exiting response handler: TestState=%d, bIsTestPaused=%d"), (int32)TestState, bIsTestPaused);
             return;
         }
 
         // Check if the stimulus was detected
         bool bStimulusDetected = WasStimulusDetected();
-        LogMessage = FString::Printf(TEXT("Stimulus detected: %s"), bStimulusDetected ? TEXT("Yes") : TEXT("No"));
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        FStructuredLog::Get().Log(EStructuredLogFormat::TrialResponse, Location, bStimulusDetected);
+
+        // Look for a saccade or blink while the stimulus was up. Eye samples are aligned onto the FPlatformTime
+        // timeline the frame times are read from (FApp's current time is set from it at the start of each frame),
+        // so the window only needs widening by the alignment error
+        const FStimulusPresentation& Presentation = PresentationScheduler.GetPresentation();
+        UpdateGazeStream();
+        const double AlignmentError = bHasGazeSample ? LatestGazeSample.TimeErrorSeconds : 0.0;
+        FGazeEvent GazeEvent;
+        const bool bFixationLost = !bIsDemoMode && bIsEyeTrackingSupported && GazeClassifier.FindEventInWindow(Presentation.FirstFrameSeconds - AlignmentError, Presentation.LastFrameSeconds + AlignmentError, GazeEvent);
+
+        // An invalid trial is not scored and its location is re-queued, until the location runs out of retests
+        const bool bRejected = bFixationLost && TrialScheduler.RejectTrial(StimulusIndex);
+
+        // Keep the trial with the frames the stimulus was actually shown in
+        FTestResults TrialResult(Location, bStimulusDetected, StimulusIntensityInDb);
+        TrialResult.FirstFrame = static_cast<int64>(Presentation.FirstFrame);
+        TrialResult.LastFrame = static_cast<int64>(Presentation.LastFrame);
+        TrialResult.FirstFrameTime = Presentation.FirstFrameSeconds;
+        TrialResult.LastFrameTime = Presentation.LastFrameSeconds;
+        TrialResult.RequestedDuration = static_cast<float>(Presentation.RequestedDurationSeconds);
+        TrialResult.MeasuredDuration = static_cast<float>(Presentation.MeasuredDurationSeconds);
+        TrialResult.bDurationWithinTolerance = Presentation.bWithinTolerance;
+        TrialResult.bFixationLost = bRejected;
+        TrialResult.bFixationUnreliable = bFixationLost && !bRejected;
+        TestResultsArray.Add(TrialResult);
+
+        // The branches prepared for a rejected trial are dropped; the scheduler has already re-queued its location
+        if (bRejected)
+        {
+            const bool bSaccade = GazeEvent.Type == EGazeEventType::Saccade;
+            FStructuredLog::Get().Log(EStructuredLogFormat::TrialInvalidated, StimulusIndex, bSaccade, !bSaccade, GazeEvent.PeakVelocity);
+            LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Stimulus %d rejected: %s during presentation."), StimulusIndex, bSaccade ? TEXT("saccade") : TEXT("blink"));
+
+            TrialPlanner.Cancel();
+            PlannedTrial = FPlannedTrial();
+            TestState = ETestState::Running;
+            GetWorld()->GetTimerManager().SetTimer(StimuliPresentationTimerHandle, this, &ATestStimuli::RunTest, TimeBetweenStimuli, false);
+            return;
+        }
 
-        // Record the result with the threshold estimator
-        if (ThresholdEstimator)
+        if (bFixationLost)
         {
-            ThresholdEstimator->UpdateWithResponse(Location, ThresholdEstimator->GetThresholdEstimateInDb(Location), bStimulusDetected);
+            LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Stimulus %d scored despite a fixation loss: retested %d times already, fixation at this location is unreliable."), StimulusIndex, TrialScheduler.GetRejectionCount(StimulusIndex));
         }
 
-        // Move to the next stimulus
-        CurrentStimulusIndex++;
+        // Record the result with the threshold estimator, then re-queue the location by its new uncertainty;
+        // a prepared branch has already done both, along with choosing the next trial
+        const bool bCommitted = ThresholdEstimator && TrialPlanner.Commit(bStimulusDetected, *ThresholdEstimator, TrialScheduler, PlannedTrial);
+        if (bCommitted)
+        {
+            FStructuredLog::Get().Log(EStructuredLogFormat::TrialPrepared, PlannedTrial.StimulusIndex, PlannedTrial.IntensityInDb);
+        }
+        else if (ThresholdEstimator)
+        {
+            ThresholdEstimator->UpdateWithResponseById(LocationId, StimulusIntensityInDb, bStimulusDetected);
+            TrialScheduler.ReportResult(StimulusIndex, ThresholdEstimator->GetThresholdUncertaintyInDbById(LocationId), ThresholdEstimator->IsThresholdEstimationCompleteById(LocationId));
+        }
+        else
+        {
+            TrialScheduler.ReportResult(StimulusIndex, 0.0f, true);
+        }
 
         // Reset test state
         TestState = ETestState::Running;
@@ -500,44 +577,27 @@ void ATestStimuli::RunTest()
         // Schedule the next RunTest() call after TimeBetweenStimuli
         GetWorld()->GetTimerManager().SetTimer(StimuliPresentationTimerHandle, this, &ATestStimuli::RunTest, TimeBetweenStimuli, false);
 
-    }, AdjustedStimuliDuration, false);
+    });
 }
 
-// Update stimuli positions, used when the user moves their head position.
-void ATestStimuli::UpdateStimuliPositions()
+// Attaches a spawned actor to the head-locked rig, so it follows the camera without ticking.
+void ATestStimuli::AttachToHeadLockedRig(AActor* Actor, const FVector& RelativeLocation)
 {
-    if (FixationActor)
+    if (Actor)
     {
-        FVector FixationLocation = FixationActor->GetActorLocation();
-        for (int32 i = 0; i < StimuliActors.Num(); ++i)
-        {
-            if (StimuliActors[i])
-            {
-                // Update each stimulus' position relative to the fixation point
-                StimuliActors[i]->SetActorLocation(FixationLocation + StimuliLocations[i]);
-            }
-        }
+        Actor->AttachToComponent(HeadLockedRig, FAttachmentTransformRules::KeepWorldTransform);
+        Actor->SetActorRelativeLocation(RelativeLocation);
+        Actor->SetActorRelativeRotation(FRotator::ZeroRotator);
+        Actor->SetActorTickEnabled(false);
     }
 }
 
-// Compares the current position of the fixation actor to the last stored position.
-bool ATestStimuli::FixationActorMoved() const
-{
-    if (FixationActor)
-    {
-        // Compare the current position of the fixation actor with the last known position
-        FVector CurrentPosition = FixationActor->GetActorLocation();
-        return !CurrentPosition.Equals(LastFixationPosition, 0.01f);  // Allow small tolerance to prevent floating point errors
-    }
-    return false;
-}
-
 // Handles the visibility logic for a specific stimulus
 void ATestStimuli::FlashStimuli(int32 StimulusIndex, float StimulusIntensityInDb)
 {
     // Exit if demo mode is active, or the test is paused, or the index is invalid
     /*
-    if (bIsDemoMode || bIsTestPaused || !StimuliActors.IsValidIndex(StimulusIndex))
+    if (bIsDemoMode || bIsTestPaused || StimulusIndex >= StimulusField->GetNumStimuli())
     {
         LogMessage = "Stimuli flashing is paused due to demo mode or test pause.";
         LogManager.LogMessage(LogMessage, ELogVerbosity::Error, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
@@ -545,77 +605,114 @@ void ATestStimuli::FlashStimuli(int32 StimulusIndex, float StimulusIntensityInDb
     }
     */
 
-    // Get the stimulus actor for the current index
-    AStimuli* StimulusActor = StimuliActors[StimulusIndex];
-    if (StimulusActor)
+    // Queue the stimulus; it goes up on the next frame and comes down after StimuliDuration in whole frames
+    if (StimulusIndex >= 0 && StimulusIndex < StimulusField->GetNumStimuli())
     {
-        // Set the brightness of the stimulus based on the intensity in decibels
-        StimulusActor->SetBrightnessFromDb(StimulusIntensityInDb);
-        LogMessage = FString::Printf(TEXT("SetBrightnessFromDb called on StimulusActor at index %d with intensity %f dB."), StimulusIndex, StimulusIntensityInDb);
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-
-        // Make the stimulus visible using the SetVisibility function
-        StimulusActor->SetVisibility(true);
-        LogMessage = FString::Printf(TEXT("SetVisibility(true) called on StimulusActor at index %d."), StimulusIndex);
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-
-        // Hide the stimulus after the specified duration using SetVisibility(false)
-        FTimerHandle HideStimuliTimerHandle;
-        GetWorld()->GetTimerManager().SetTimer(HideStimuliTimerHandle, [this, StimulusIndex, StimulusActor]()
-        {
-            StimulusActor->SetVisibility(false);  // Hide the stimulus after the flash
-            LogMessage = FString::Printf(TEXT("Stimulus %d hidden after duration."), StimulusIndex);
-            LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-
-        }, StimuliDuration, false);
+        PresentationScheduler.Schedule(StimulusIndex, StimulusIntensityInDb, StimuliDuration);
     }
     else
     {
-        LogMessage = FString::Printf(TEXT("StimulusActor is null at index %d."), StimulusIndex);
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Error, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        LogManager.LogMessagef(ELogVerbosity::Error, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("No stimulus at index %d."), StimulusIndex);
     }
 }
 
-// Removes and destroys all existing stimuli actors from the world.
-void ATestStimuli::CleanupStimuli()
+// Shows and hides the presented stimulus on frame boundaries, and starts the response handler once it is down.
+void ATestStimuli::AdvancePresentation()
 {
-    // Iterate through each spawned stimulus actor and destroy it
-    for (AActor* StimulusActor : StimuliActors)
+    // Pausing cancels the presentation, so there is nothing to advance until the next trial is scheduled
+    if (TestState == ETestState::Paused)
+    {
+        return;
+    }
+
+    const FStimulusPresentation& Presentation = PresentationScheduler.GetPresentation();
+    switch (PresentationScheduler.AdvanceFrame(GFrameCounter, FApp::GetCurrentTime()))
+    {
+    case FStimulusPresentationScheduler::EAction::Show:
+        StimulusField->ShowStimulus(Presentation.StimulusIndex, Presentation.IntensityInDb);
+        FStructuredLog::Get().Log(EStructuredLogFormat::StimulusShown, Presentation.StimulusIndex, Presentation.IntensityInDb);
+        break;
+
+    case FStimulusPresentationScheduler::EAction::Hide:
     {
-        if (StimulusActor)
+        StimulusField->HideStimulus(Presentation.StimulusIndex);
+        FStructuredLog::Get().Log(EStructuredLogFormat::StimulusHidden, Presentation.StimulusIndex);
+        FStructuredLog::Get().Log(EStructuredLogFormat::StimulusTiming, Presentation.StimulusIndex, Presentation.MeasuredDurationSeconds, Presentation.RequestedDurationSeconds, Presentation.bWithinTolerance);
+        if (!Presentation.bWithinTolerance)
+        {
+            LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Stimulus %d was on screen for %.1f ms instead of %.1f ms."), Presentation.StimulusIndex, Presentation.MeasuredDurationSeconds * 1000.0, Presentation.RequestedDurationSeconds * 1000.0);
+        }
+
+        // Check the response once the rest of the response window has passed
+        const float RemainingWindow = StimulusResponseWindow - static_cast<float>(Presentation.MeasuredDurationSeconds);
+        if (RemainingWindow > KINDA_SMALL_NUMBER)
         {
-            StimulusActor->Destroy();
+            GetWorld()->GetTimerManager().SetTimer(StimulusResponseTimerHandle, StimulusResponseDelegate, RemainingWindow, false);
         }
+        else
+        {
+            StimulusResponseDelegate.ExecuteIfBound();
+        }
+        break;
     }
 
-    // Clear the array of actors after they are destroyed
-    StimuliActors.Empty();
+    default:
+        break;
+    }
+}
+
+// Removes all existing stimuli from the stimulus field.
+void ATestStimuli::CleanupStimuli()
+{
+    StimulusField->ClearStimuli();
 }
 
 // Saves the test results to a file for later analysis and review.
 void ATestStimuli::SaveResultsToFile()
 {
-    FString SavePath = FPaths::ProjectDir() + "/TestResults.csv";
-    FString ResultsString = "LocationX,LocationY,Threshold,Sensitivity\n";
+    // Both eyes go in one file, with each location's field position and posterior spread so the next visit can use it as a prior
+    FString ResultsString = "Eye,LocationId,HorizontalDegrees,VerticalDegrees,LocationX,LocationY,LocationZ,Threshold,Sensitivity,StandardDeviation\n";
 
-    const TMap<FVector, float>& FinalThresholds = ThresholdEstimator->GetFinalThresholdsInDb();
-    for (const auto& Pair : FinalThresholds)
+    for (const bool bEye : { true, false })
     {
-        FVector Location = Pair.Key;
-        float Threshold = Pair.Value;
-        float Sensitivity = 1.0f / Threshold;
-        ResultsString += FString::Printf(TEXT("%f,%f,%f,%f\n"), Location.X, Location.Y, Threshold, Sensitivity);
+        for (int32 LocationId = 0; LocationId < ThresholdEstimator->GetNumLocations(); ++LocationId)
+        {
+            float Threshold = 0.0f;
+            float StandardDeviation = 0.0f;
+            if (!ThresholdEstimator->GetEyeResultById(bEye, LocationId, Threshold, StandardDeviation))
+            {
+                continue;
+            }
+
+            FVector Location = ThresholdEstimator->GetLocationById(LocationId);
+            float HorizontalDegrees = 0.0f;
+            float VerticalDegrees = 0.0f;
+            FNormativePriorDatabase::ToFieldDegrees(Location, HorizontalDegrees, VerticalDegrees);
+            float Sensitivity = 1.0f / Threshold;
+            ResultsString += FString::Printf(TEXT("%s,%d,%f,%f,%f,%f,%f,%f,%f,%f\n"), FPreviousVisitPriors::GetEyeName(bEye), LocationId,
+                HorizontalDegrees, VerticalDegrees, Location.X, Location.Y, Location.Z, Threshold, Sensitivity, StandardDeviation);
+        }
     }
 
-    FFileHelper::SaveStringToFile(ResultsString, *SavePath);
-    LogMessage = FString::Printf(TEXT("Test results saved to %s"), *SavePath);
-    LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+    FFileHelper::SaveStringToFile(ResultsString, *ResultsFilePath);
+    LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Test results saved to %s"), *ResultsFilePath);
+
+    // Once both eyes are done, add the field to the patient's history so the next visit starts from it
+    if (TestState == ETestState::Completed)
+    {
+        if (IVisualFieldHistoryProvider* History = Cast<IVisualFieldHistoryProvider>(GetGameInstance()))
+        {
+            History->OnVisualFieldSaved(ResultsFilePath);
+        }
+    }
 }
 
 bool ATestStimuli::CheckForFalsePositives()
 {
-    // Determine if a catch trial should occur
-    bool bIsCatchTrial = FMath::RandRange(0, 9) == 0;  // 10% chance
+    // Determine if a catch trial should occur; a prepared trial has already drawn the decision, and the catch
+    // trial runs first only once
+    bool bIsCatchTrial = PlannedTrial.IsValid() ? PlannedTrial.bPrecededByCatchTrial : TrialScheduler.ShouldRunCatchTrial();
+    PlannedTrial.bPrecededByCatchTrial = false;
 
     if (bIsCatchTrial)
     {
@@ -693,31 +790,31 @@ void ATestStimuli::TrackAttentionLapses(bool bSeen)
 // Computes the ratio of correct responses to total stimuli presented to gauge test reliability.
 float ATestStimuli::CalculateResponseReliability()
 {
-    int32 TotalStimuliPresented = TestResultsArray.Num();
-    int32 TotalSeen = TestResultsArray.FilterByPredicate([](const FTestResults& Result) { return Result.bSeen; }).Num();
+    // Trials rejected for a saccade or blink were never scored, so they do not count either way
+    int32 TotalStimuliPresented = TestResultsArray.FilterByPredicate([](const FTestResults& Result) { return !Result.bFixationLost; }).Num();
+    int32 TotalSeen = TestResultsArray.FilterByPredicate([](const FTestResults& Result) { return Result.bSeen && !Result.bFixationLost; }).Num();
     return TotalSeen / static_cast<float>(TotalStimuliPresented);  // Calculate response reliability ratio
 }
 
-// Determines if the user detected the stimulus based on eye gaze and user input.
+// Determines if the user detected the stimulus from their input; fixation during the presentation is judged by the gaze classifier.
 bool ATestStimuli::WasStimulusDetected()
 {
-    // Check if the user's gaze was focused on the fixation point during stimulus presentation and key pressed
-    if (CheckGazeFocus() && bUserResponded)
-    {
-        bUserResponded = false;  // Reset the flag for the next stimulus
-        return true;
-    }
-    else
-    {
-        LogMessage = "Gaze left the fixation point during stimulus presentation.";
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-        return false;
-    }
+    const bool bDetected = bUserResponded;
+    bUserResponded = false;  // Reset the flag for the next stimulus
+    return bDetected;
 }
 
 // Function to set a flag indicating the stimulus was detected
 void ATestStimuli::OnStimulusDetected()
 {
+    if (UEyeTrackingSubsystem* EyeTracking = UEyeTrackingSubsystem::Get())
+    {
+        if (FSessionRecorder* Recorder = EyeTracking->GetRecorder())
+        {
+            Recorder->RecordInput(ESessionInput::DetectStimulus, true, FPlatformTime::Seconds());
+        }
+    }
+
     if (TestState == ETestState::WaitingForInput)
     {
         bUserResponded = true;
@@ -737,12 +834,14 @@ bool ATestStimuli::CheckGazeFocus()
         return true;
     }
 
-    // Retrieve eye-tracking data to check if the user's gaze is focused on the fixation point
-    if (PICOXRMotionTracking::GetEyeTrackingData(0.0f, GetInfo, EyeTrackingData))
-    {
-        // Add the new eye-tracking data to the buffer
-        AddEyeTrackingDataToBuffer(EyeTrackingData);
+    UpdateGazeStream();
 
+    // A check right after another may find nothing new; the newest buffered sample still counts while it is recent
+    const double Now = FPlatformTime::Seconds();
+    const bool bHasRecentGaze = bHasGazeSample && Now - LatestGazeSample.HostTimeSeconds <= MaxGazeSampleAgeSeconds;
+    bool bIsGazingAtFixation = false;
+    if (bHasRecentGaze)
+    {
         FVector GazeDirection = GetSmoothedGazeDirection();
 
         // If gaze data is invalid or delayed, use interpolation
@@ -757,62 +856,78 @@ bool ATestStimuli::CheckGazeFocus()
         {
             LogMessage = "Unable to determine gaze direction.";
             LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
-            return false;
         }
+        else
+        {
+            // Retrieve the current position and orientation of the HMD (head-mounted display)
+            const FHeadPoseSample HeadPose = GetHeadPose();
+            FQuat HMDOrientation = HeadPose.Orientation;
+            FVector HMDPosition = HeadPose.Position;
 
-        // Retrieve the current position and orientation of the HMD (head-mounted display)
-        FQuat HMDOrientation = UPICOXRHMDFunctionLibrary::PXR_GetCurrentOrientation();
-        FVector HMDPosition = UPICOXRHMDFunctionLibrary::PXR_GetCurrentPosition();
-
-        // Rotate the gaze direction according to the HMD's current orientation
-        FVector WorldGazeDirection = HMDOrientation.RotateVector(GazeDirection);
+            // Rotate the gaze direction according to the HMD's current orientation
+            FVector WorldGazeDirection = HMDOrientation.RotateVector(GazeDirection);
 
-        // Calculate the vector pointing to the fixation point and normalize it
-        FVector FixationLocation = FixationActor->GetActorLocation();
-        FVector ToFixation = (FixationLocation - HMDPosition).GetSafeNormal();
+            // Calculate the vector pointing to the fixation point and normalize it
+            FVector FixationLocation = FixationActor->GetActorLocation();
+            FVector ToFixation = (FixationLocation - HMDPosition).GetSafeNormal();
 
-        // Check if the gaze is within a certain angular threshold of the fixation point
-        float GazeToleranceDegrees = 10.0f;  // Define as needed
-        bool bIsGazingAtFixation = FVector::DotProduct(WorldGazeDirection, ToFixation) > FMath::Cos(FMath::DegreesToRadians(GazeToleranceDegrees));
+            // Check if the gaze is within a certain angular threshold of the fixation point
+            float GazeToleranceDegrees = 10.0f;  // Define as needed
+            bIsGazingAtFixation = FVector::DotProduct(WorldGazeDirection, ToFixation) > FMath::Cos(FMath::DegreesToRadians(GazeToleranceDegrees));
+        }
+    }
+    else
+    {
+        // Log an error if no recent eye-tracking data arrived
+        LogMessage = "Failed to retrieve eye tracking data.";
+        LogManager.LogMessage(LogMessage, ELogVerbosity::Error, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+    }
 
-        if (bIsGazingAtFixation)
+    if (bIsGazingAtFixation)
+    {
+        // If the user is gazing at the fixation point, hide the converging lines and resume the test
+        FixationLostSince = -1.0;
+        if (ConvergingLinesActor)
         {
-            // If the user is gazing at the fixation point, hide the converging lines and resume the test
-            if (ConvergingLinesActor)
-            {
-                ConvergingLinesActor->SetActorHiddenInGame(true);
-            }
-            if (TestState == ETestState::Paused)
-            {
-                ResumeTest();
-            }
-            return true;
+            ConvergingLinesActor->SetActorHiddenInGame(true);
         }
-        else
+        if (TestState == ETestState::Paused)
         {
-            // If the user is not focused on the fixation point, show the converging lines and pause the test
-            if (ConvergingLinesActor)
-            {
-                ConvergingLinesActor->SetActorHiddenInGame(false);
-            }
-            if (TestState != ETestState::Paused)
-            {
-                PauseTest();
-            }
-            return false;
+            ResumeTest();
         }
+        return true;
     }
-    else
+
+    // Saccades and blinks are over within a few hundred milliseconds; the classifier rejects the trial they overlap,
+    // so only a sustained loss of fixation shows the converging lines and pauses the test
+    if (FixationLostSince < 0.0)
     {
-        // Log an error if the eye-tracking data retrieval fails
-        LogMessage = "Failed to retrieve eye tracking data.";
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Error, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        FixationLostSince = Now;
+    }
+    if (Now - FixationLostSince >= FixationLossPauseSeconds)
+    {
+        if (ConvergingLinesActor)
+        {
+            ConvergingLinesActor->SetActorHiddenInGame(false);
+        }
         if (TestState != ETestState::Paused)
         {
             PauseTest();
         }
-        return false;
     }
+    return false;
+}
+
+// Feeds every sample the acquisition service published since the last call to the gaze filter and the classifier
+void ATestStimuli::UpdateGazeStream()
+{
+    NewGazeSamples.Reset();
+    GazeReader.ReadNew(NewGazeSamples);
+    for (const FEyeTrackingSample& Sample : NewGazeSamples)
+    {
+        AddEyeTrackingDataToBuffer(Sample);
+    }
+    bIsEyeTrackingActive = NewGazeSamples.Num() > 0;
 }
 
 // Dynamically adjusts the timing of stimulus presentation based on user consistency.
@@ -830,45 +945,21 @@ void ATestStimuli::AdjustTimingBasedOnResponses()
     }
 }
 
-// Function to add data to the buffer and keep it within the BufferSize limit
-void ATestStimuli::AddEyeTrackingDataToBuffer(const FPXREyeTrackingData& NewData)
+// Function to feed one tracker sample to the gaze filter, at constant cost per sample
+void ATestStimuli::AddEyeTrackingDataToBuffer(const FEyeTrackingSample& NewData)
 {
-    // Insert the new data at the front of the buffer
-    EyeTrackingDataBuffer.Insert(NewData, 0);
+    LatestGazeSample = NewData;
+    bHasGazeSample = true;
 
-    // Ensure the buffer doesn't exceed the specified size
-    if (EyeTrackingDataBuffer.Num() > BufferSize)
-    {
-        EyeTrackingDataBuffer.RemoveAt(BufferSize);  // Remove the oldest data
-    }
+    const FEyeSampleEye& EyeData = NewData.GetEye(bIsLeftEye ? EEyeSampleEye::Left : EEyeSampleEye::Right);
+    GazeFilter.Update(EyeData.Orientation.Vector(), EyeData.bPoseValid, NewData.HostTimeSeconds);
+    GazeClassifier.Update(EyeData.Orientation.Vector(), EyeData.bPoseValid && !EyeData.bBlink, NewData.HostTimeSeconds);
 }
 
-// Function to compute a smoothed gaze direction by averaging the buffered data
+// Function to return the filtered gaze direction of the tested eye (zero if no valid gaze data was found)
 FVector ATestStimuli::GetSmoothedGazeDirection()
 {
-    if (EyeTrackingDataBuffer.Num() == 0) return FVector::ZeroVector;
-
-    FVector SmoothedGazeDirection = FVector::ZeroVector;
-
-    // Average the gaze directions from the buffered data
-    for (const FPXREyeTrackingData& Data : EyeTrackingDataBuffer)
-    {
-        const FPXRPerEyeData& EyeData = bIsLeftEye ? Data.PerEyeDatas[0] : Data.PerEyeDatas[1];
-        if (EyeData.bIsPoseValid)
-        {
-            SmoothedGazeDirection += EyeData.Orientation.Vector();
-        }
-    }
-
-    // Handle the case where no valid gaze data was found
-    if (SmoothedGazeDirection.IsZero())
-    {
-        return FVector::ZeroVector;
-    }
-
-    // Normalize the resulting gaze direction vector
-    SmoothedGazeDirection /= EyeTrackingDataBuffer.Num();
-    return SmoothedGazeDirection;
+    return GazeFilter.GetValue();
 }
 
 // Function to predict the user's gaze based on the angular velocity
@@ -876,14 +967,14 @@ FVector ATestStimuli::PredictGazeDirection(float PredictionTime)
 {
     FVector PredictedGazeDirection = FVector::ZeroVector;
 
-    if (EyeTrackingDataBuffer.Num() > 0)
+    if (bHasGazeSample)
     {
         // Get the most recent eye-tracking data
-        const FPXREyeTrackingData& CurrentEyeData = EyeTrackingDataBuffer[0];
+        const FEyeTrackingSample& CurrentEyeData = LatestGazeSample;
 
         // Get the current gaze direction and angular velocity from the data
-        FVector CurrentGazeDirection = CurrentEyeData.PerEyeDatas[0].Orientation.Vector();  // Example for left eye
-        FVector AngularVelocity = UPICOXRHMDFunctionLibrary::PXR_GetAngularVelocity();
+        FVector CurrentGazeDirection = CurrentEyeData.GetEye(EEyeSampleEye::Left).Orientation.Vector();  // Example for left eye
+        FVector AngularVelocity = GetHeadPose().AngularVelocity;
 
         // Predict the next gaze direction based on current angular velocity
         PredictedGazeDirection = CurrentGazeDirection + AngularVelocity * PredictionTime;
@@ -903,14 +994,14 @@ FVector ATestStimuli::InterpolateGazeDirection(float DeltaTime, float Interpolat
     FVector LastGazePosition = SmoothedGazeDirection;
     FVector CurrentGazePosition = FVector::ZeroVector;  // Placeholder for actual gaze direction
 
-    if (EyeTrackingDataBuffer.Num() > 0)
+    if (bHasGazeSample)
     {
         // Retrieve the most recent gaze direction
-        CurrentGazePosition = EyeTrackingDataBuffer[0].PerEyeDatas[0].Orientation.Vector();
+        CurrentGazePosition = LatestGazeSample.GetEye(EEyeSampleEye::Left).Orientation.Vector();
     }
 
-    // If eye-tracking data is unavailable, predict the gaze direction
-    if (EyeTrackingDataBuffer.Num() == 0 || PICOXRMotionTracking::GetEyeTrackingData(100.0f, GetInfo, EyeTrackingData) == false)
+    // If eye-tracking data is unavailable (nothing new arrived since the last check), predict the gaze direction
+    if (!bHasGazeSample || NewGazeSamples.Num() == 0)
     {
         FVector PredictedGaze = PredictGazeDirection(0.05f);  // Predict 50ms ahead
         CurrentGazePosition = FMath::VInterpTo(LastGazePosition, PredictedGaze, DeltaTime, InterpolationSpeed);
@@ -919,19 +1010,95 @@ FVector ATestStimuli::InterpolateGazeDirection(float DeltaTime, float Interpolat
     return CurrentGazePosition.GetSafeNormal();
 }
 
+// Function to read the HMD pose, from the headset or from the replayed session
+FHeadPoseSample ATestStimuli::GetHeadPose() const
+{
+    const UEyeTrackingSubsystem* EyeTracking = UEyeTrackingSubsystem::Get();
+    const FSessionReplay* Replay = EyeTracking ? EyeTracking->GetReplay() : nullptr;
+
+    FHeadPoseSample Pose;
+    if (Replay && Replay->IsPlaying())
+    {
+        Replay->GetHeadPoseAt(Replay->ToRecordedTime(FPlatformTime::Seconds()), Pose);
+        return Pose;
+    }
+
+    Pose.HostTimeSeconds = FPlatformTime::Seconds();
+#if WITH_PICOXR
+    Pose.Orientation = UPICOXRHMDFunctionLibrary::PXR_GetCurrentOrientation();
+    Pose.Position = UPICOXRHMDFunctionLibrary::PXR_GetCurrentPosition();
+    Pose.AngularVelocity = UPICOXRHMDFunctionLibrary::PXR_GetAngularVelocity();
+#else
+    // Without the PICO runtime the engine's HMD interface still gives the pose, but no angular velocity
+    FRotator Rotation;
+    UHeadMountedDisplayFunctionLibrary::GetOrientationAndPosition(Rotation, Pose.Position);
+    Pose.Orientation = Rotation.Quaternion();
+#endif
+    return Pose;
+}
+
+// Function to add the frame's timing and the head pose to the session recording
+void ATestStimuli::RecordFrame(float DeltaTime)
+{
+    UEyeTrackingSubsystem* EyeTracking = UEyeTrackingSubsystem::Get();
+    FSessionRecorder* Recorder = EyeTracking ? EyeTracking->GetRecorder() : nullptr;
+    if (!Recorder)
+    {
+        return;
+    }
+
+    Recorder->RecordFrame(GFrameCounter, DeltaTime, FApp::GetCurrentTime());
+    Recorder->RecordHeadPose(GetHeadPose());
+}
+
+// Function to press the detection button at the times it was pressed in the replayed session
+void ATestStimuli::DispatchReplayedInputs()
+{
+    const UEyeTrackingSubsystem* EyeTracking = UEyeTrackingSubsystem::Get();
+    const FSessionReplay* Replay = EyeTracking ? EyeTracking->GetReplay() : nullptr;
+    if (!Replay || !Replay->IsPlaying())
+    {
+        return;
+    }
+
+    const TArray<FSessionInputRecord>& Inputs = Replay->GetInputs();
+    const double RecordedNow = Replay->ToRecordedTime(FPlatformTime::Seconds());
+    while (NextReplayedInput < Inputs.Num() && Inputs[NextReplayedInput].HostTimeSeconds <= RecordedNow)
+    {
+        const FSessionInputRecord& Input = Inputs[NextReplayedInput++];
+        if (Input.Code == static_cast<int32>(ESessionInput::DetectStimulus) && Input.bPressed)
+        {
+            OnStimulusDetected();
+        }
+    }
+}
+
 // Switches the test to the other eye (e.g., from left eye to right eye).
 void ATestStimuli::SwitchEye()
 {
+    // Finish the eye just tested, so locations retired at the presentation cap still get a threshold
+    if (ThresholdEstimator)
+    {
+        ThresholdEstimator->CalculateFinalThresholds();
+        ThresholdEstimator->CalculateFinalSensitivities();
+    }
+
     bIsLeftEye = !bIsLeftEye;  // Toggle the eye being tested
-    LogMessage = FString::Printf(TEXT("Switched to %s eye."), bIsLeftEye ? TEXT("left") : TEXT("right"));
-    LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+    LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Switched to %s eye."), bIsLeftEye ? TEXT("left") : TEXT("right"));
 
     // Reset the stimulus index and clean up existing stimuli before starting the test for the other eye
     CurrentStimulusIndex = 0;
     CleanupStimuli();
 
-    // Reconfigure the test for the newly selected eye and start the test
+    // The filtered gaze and its saccades belonged to the other eye
+    GazeFilter.Reset();
+    GazeClassifier.Reset();
+    bHasGazeSample = false;
+    FixationLostSince = -1.0;
+
+    // Reconfigure the test for the newly selected eye and start the test; StartTest only runs from Idle
     SetupTest(TestType);
+    TestState = ETestState::Idle;
     StartTest();
 }
 
@@ -987,7 +1154,6 @@ void ATestStimuli::MonitorLatency()
     // Log a warning if the smoothed latency exceeds a certain threshold
     if (DetectedLatency > 0.05f)  // Adjust this threshold as needed
     {
-        LogMessage = FString::Printf(TEXT("Latency spike detected: %f seconds."), DetectedLatency);
-        LogManager.LogMessage(LogMessage, ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+        LogManager.LogMessagef(ELogVerbosity::Warning, 5.0f, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog, TEXT("Latency spike detected: %f seconds."), DetectedLatency);
     }
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+// FDiagnosticsOverlay.cpp
+
+#include "FDiagnosticsOverlay.h"
+#include "Engine/Engine.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+FDiagnosticsOverlay::FDiagnosticsOverlay(float InUpdateRateHz, int32 InMaxSlots)
+    : MaxSlots(FMath::Max(InMaxSlots, 1))
+    , OverflowCount(0)
+    , bOverflowDirty(false)
+{
+    // All slot storage is allocated up front; Report never grows the slot array
+    Slots.SetNum(MaxSlots);
+    SlotIndexByKey.Reserve(MaxSlots);
+    Line.Reserve(256);
+
+    const float UpdateInterval = 1.0f / FMath::Max(InUpdateRateHz, 0.1f);
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FDiagnosticsOverlay::Tick), UpdateInterval);
+}
+
+FDiagnosticsOverlay::~FDiagnosticsOverlay()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+void FDiagnosticsOverlay::Report(FName Category, ELogVerbosity::Type Verbosity, const FString& Message, float DisplayTime)
+{
+    const uint32 Key = MakeKey(Category, Verbosity, Message);
+
+    FScopeLock ScopeLock(&Lock);
+
+    int32* ExistingIndex = SlotIndexByKey.Find(Key);
+    int32 SlotIndex = ExistingIndex ? *ExistingIndex : INDEX_NONE;
+    if (SlotIndex == INDEX_NONE)
+    {
+        SlotIndex = Slots.IndexOfByPredicate([](const FSlot& Slot) { return !Slot.bInUse; });
+        if (SlotIndex == INDEX_NONE)
+        {
+            OverflowCount++;
+            bOverflowDirty = true;
+            return;
+        }
+
+        FSlot& NewSlot = Slots[SlotIndex];
+        NewSlot.Key = Key;
+        NewSlot.Category = Category;
+        NewSlot.Verbosity = Verbosity;
+        NewSlot.Count = 0;
+        NewSlot.bInUse = true;
+        SlotIndexByKey.Add(Key, SlotIndex);
+    }
+
+    FSlot& Slot = Slots[SlotIndex];
+
+    // Reset keeps the slot's allocation, so repeated reports of similar messages do not reallocate
+    Slot.LatestMessage.Reset();
+    Slot.LatestMessage.Append(Message);
+    Slot.Count++;
+    Slot.DisplayTime = DisplayTime;
+    Slot.LastReportTime = FPlatformTime::Seconds();
+    Slot.bDirty = true;
+}
+
+void FDiagnosticsOverlay::Flush()
+{
+    if (!GEngine || !GEngine->IsInitialized())
+    {
+        return;
+    }
+
+    FScopeLock ScopeLock(&Lock);
+    const double Now = FPlatformTime::Seconds();
+
+    for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+    {
+        FSlot& Slot = Slots[SlotIndex];
+        if (!Slot.bInUse)
+        {
+            continue;
+        }
+
+        if (Slot.bDirty)
+        {
+            Line.Reset();
+            if (Slot.Count > 1)
+            {
+                Line.Appendf(TEXT("[%s] (x%d) %s"), *Slot.Category.ToString(), Slot.Count, *Slot.LatestMessage);
+            }
+            else
+            {
+                Line.Appendf(TEXT("[%s] %s"), *Slot.Category.ToString(), *Slot.LatestMessage);
+            }
+
+            GEngine->AddOnScreenDebugMessage(MessageKeyBase + SlotIndex, Slot.DisplayTime, GetColor(Slot.Verbosity), Line);
+            Slot.bDirty = false;
+        }
+        else if (Now - Slot.LastReportTime > Slot.DisplayTime)
+        {
+            // The engine has already expired the line; free the slot for another message
+            SlotIndexByKey.Remove(Slot.Key);
+            Slot.bInUse = false;
+        }
+    }
+
+    if (bOverflowDirty)
+    {
+        Line.Reset();
+        Line.Appendf(TEXT("(x%d) further diagnostics messages not shown, all %d overlay slots are in use"), OverflowCount, MaxSlots);
+        GEngine->AddOnScreenDebugMessage(MessageKeyBase + MaxSlots, 5.0f, FColor::Orange, Line);
+        bOverflowDirty = false;
+    }
+}
+
+void FDiagnosticsOverlay::Reset()
+{
+    FScopeLock ScopeLock(&Lock);
+    for (FSlot& Slot : Slots)
+    {
+        Slot.bInUse = false;
+        Slot.bDirty = false;
+        Slot.Count = 0;
+    }
+    SlotIndexByKey.Reset();
+    OverflowCount = 0;
+    bOverflowDirty = false;
+}
+
+int32 FDiagnosticsOverlay::GetActiveSlotCount() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return SlotIndexByKey.Num();
+}
+
+uint32 FDiagnosticsOverlay::MakeKey(FName Category, ELogVerbosity::Type Verbosity, const FString& Message)
+{
+    uint32 Hash = HashCombine(GetTypeHash(Category), static_cast<uint32>(Verbosity));
+    for (const TCHAR Character : Message)
+    {
+        // Numbers carry the changing values (indices, positions, intensities); leave them out of the key
+        if (FChar::IsDigit(Character) || Character == TEXT('.') || Character == TEXT('-') || Character == TEXT('+'))
+        {
+            continue;
+        }
+        Hash = HashCombineFast(Hash, static_cast<uint32>(Character));
+    }
+    return Hash;
+}
+
+FColor FDiagnosticsOverlay::GetColor(ELogVerbosity::Type Verbosity)
+{
+    switch (Verbosity)
+    {
+    case ELogVerbosity::Warning:
+        return FColor::Yellow;
+    case ELogVerbosity::Error:
+        return FColor::Red;
+    case ELogVerbosity::Fatal:
+        return FColor::Magenta;
+    default:
+        return FColor::Green;
+    }
+}
+
+bool FDiagnosticsOverlay::Tick(float DeltaTime)
+{
+    Flush();
+    return true;
+}
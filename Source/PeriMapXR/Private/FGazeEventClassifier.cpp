@@ -0,0 +1,138 @@
+// FGazeEventClassifier.cpp
+
+#include "FGazeEventClassifier.h"
+
+FGazeEventClassifier::FGazeEventClassifier()
+{
+    Reset();
+}
+
+void FGazeEventClassifier::Configure(const FGazeClassifierSettings& InSettings)
+{
+    Settings = InSettings;
+    Reset();
+}
+
+void FGazeEventClassifier::Reset()
+{
+    Current = FGazeEvent();
+    bHasSample = false;
+    LastSampleTime = 0.0;
+    LastOpenDirection = FVector::ZeroVector;
+    LastOpenTime = 0.0;
+    bHasOpenSample = false;
+    RecentEvents.Reset();
+    RecentEvents.Reserve(FMath::Max(Settings.MaxStoredEvents, 1));
+    RecentHead = 0;
+    NumSaccades = 0;
+    NumBlinks = 0;
+}
+
+void FGazeEventClassifier::BeginEvent(EGazeEventType Type, double StartSeconds)
+{
+    if (bHasSample && Current.Type != EGazeEventType::Fixation)
+    {
+        if (RecentEvents.Num() < FMath::Max(Settings.MaxStoredEvents, 1))
+        {
+            RecentEvents.Add(Current);
+        }
+        else
+        {
+            RecentEvents[RecentHead] = Current;
+            RecentHead = (RecentHead + 1) % RecentEvents.Num();
+        }
+    }
+
+    Current = FGazeEvent();
+    Current.Type = Type;
+    Current.StartSeconds = StartSeconds;
+    Current.EndSeconds = StartSeconds;
+
+    if (Type == EGazeEventType::Saccade)
+    {
+        ++NumSaccades;
+    }
+    else if (Type == EGazeEventType::Blink)
+    {
+        ++NumBlinks;
+    }
+}
+
+EGazeEventType FGazeEventClassifier::Update(const FVector& Direction, bool bEyeOpen, double TimeSeconds)
+{
+    // Samples stopped arriving for a while (the tracker lost the eye); the gap counts as a blink
+    if (bHasSample && TimeSeconds - LastSampleTime > Settings.MaxSampleGapSeconds)
+    {
+        if (Current.Type != EGazeEventType::Blink)
+        {
+            BeginEvent(EGazeEventType::Blink, LastSampleTime);
+        }
+        Current.EndSeconds = TimeSeconds;
+        bHasOpenSample = false;
+    }
+
+    EGazeEventType Type = EGazeEventType::Blink;
+    float Velocity = 0.0f;
+    if (bEyeOpen)
+    {
+        // The first open sample after a blink has no reference direction, so it starts a fixation
+        Type = EGazeEventType::Fixation;
+        const double DeltaSeconds = TimeSeconds - LastOpenTime;
+        if (bHasOpenSample && DeltaSeconds > 0.0)
+        {
+            const float CosAngle = FMath::Clamp(static_cast<float>(FVector::DotProduct(Direction.GetSafeNormal(), LastOpenDirection)), -1.0f, 1.0f);
+            Velocity = FMath::RadiansToDegrees(FMath::Acos(CosAngle)) / static_cast<float>(DeltaSeconds);
+            if (Velocity > Settings.SaccadeVelocityThreshold)
+            {
+                Type = EGazeEventType::Saccade;
+            }
+        }
+    }
+
+    if (!bHasSample || Type != Current.Type)
+    {
+        // A saccade began when the eye left the previous sample's direction
+        BeginEvent(Type, Type == EGazeEventType::Saccade ? LastOpenTime : TimeSeconds);
+    }
+    Current.EndSeconds = TimeSeconds;
+    Current.PeakVelocity = FMath::Max(Current.PeakVelocity, Velocity);
+
+    if (bEyeOpen)
+    {
+        LastOpenDirection = Direction.GetSafeNormal();
+        LastOpenTime = TimeSeconds;
+        bHasOpenSample = true;
+    }
+    else
+    {
+        bHasOpenSample = false;
+    }
+    LastSampleTime = TimeSeconds;
+    bHasSample = true;
+
+    return Type;
+}
+
+bool FGazeEventClassifier::FindEventInWindow(double StartSeconds, double EndSeconds, FGazeEvent& OutEvent) const
+{
+    bool bFound = false;
+    auto Consider = [&](const FGazeEvent& Event)
+    {
+        if (Event.Type != EGazeEventType::Fixation && Event.StartSeconds <= EndSeconds && Event.EndSeconds >= StartSeconds
+            && (!bFound || Event.StartSeconds < OutEvent.StartSeconds))
+        {
+            OutEvent = Event;
+            bFound = true;
+        }
+    };
+
+    for (const FGazeEvent& Event : RecentEvents)
+    {
+        Consider(Event);
+    }
+    if (bHasSample)
+    {
+        Consider(Current);
+    }
+    return bFound;
+}
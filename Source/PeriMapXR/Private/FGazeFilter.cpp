@@ -0,0 +1,142 @@
+// FGazeFilter.cpp
+
+#include "FGazeFilter.h"
+
+namespace
+{
+    // Adds after which the running sum is rebuilt from the slots
+    constexpr int32 RebuildInterval = 4096;
+}
+
+void FGazeRingBuffer::Reset(int32 InCapacity)
+{
+    const int32 Capacity = FMath::Max(InCapacity, 1);
+    Directions.SetNumZeroed(Capacity);
+    ValidFlags.Init(false, Capacity);
+    Head = 0;
+    Count = 0;
+    ValidCount = 0;
+    AddsSinceRebuild = 0;
+    Sum = FVector::ZeroVector;
+}
+
+void FGazeRingBuffer::Add(const FVector& Direction, bool bValid)
+{
+    if (Directions.Num() == 0)
+    {
+        Reset(1);
+    }
+
+    // Take the oldest sample out of the sum before its slot is reused
+    if (Count == Directions.Num())
+    {
+        if (ValidFlags[Head])
+        {
+            Sum -= Directions[Head];
+            --ValidCount;
+        }
+    }
+    else
+    {
+        ++Count;
+    }
+
+    Directions[Head] = bValid ? Direction : FVector::ZeroVector;
+    ValidFlags[Head] = bValid;
+    if (bValid)
+    {
+        Sum += Direction;
+        ++ValidCount;
+    }
+    Head = (Head + 1) % Directions.Num();
+
+    if (++AddsSinceRebuild >= RebuildInterval)
+    {
+        Rebuild();
+    }
+}
+
+void FGazeRingBuffer::Rebuild()
+{
+    Sum = FVector::ZeroVector;
+    ValidCount = 0;
+    for (int32 Index = 0; Index < Directions.Num(); ++Index)
+    {
+        if (ValidFlags[Index])
+        {
+            Sum += Directions[Index];
+            ++ValidCount;
+        }
+    }
+    AddsSinceRebuild = 0;
+}
+
+void FGazeFilter::Configure(const FGazeFilterSettings& InSettings)
+{
+    Settings = InSettings;
+    Reset();
+}
+
+void FGazeFilter::Reset()
+{
+    Window.Reset(Settings.WindowSamples);
+    Smoothed = FVector::ZeroVector;
+    SmoothedVelocity = FVector::ZeroVector;
+    LastTimeSeconds = 0.0;
+    bHasState = false;
+    Value = FVector::ZeroVector;
+}
+
+float FGazeFilter::Alpha(float CutoffHz, float DeltaSeconds)
+{
+    const float TimeConstant = 1.0f / (2.0f * PI * FMath::Max(CutoffHz, KINDA_SMALL_NUMBER));
+    return 1.0f / (1.0f + TimeConstant / DeltaSeconds);
+}
+
+FVector FGazeFilter::Update(const FVector& Direction, bool bValid, double TimeSeconds)
+{
+    if (Settings.Type == EGazeFilterType::MovingAverage)
+    {
+        Window.Add(Direction, bValid);
+        Value = Window.GetMean().GetSafeNormal();
+        return Value;
+    }
+
+    if (!bValid)
+    {
+        return Value;
+    }
+
+    // The first valid sample starts the filter where the eye is; a repeated timestamp changes nothing
+    const float DeltaSeconds = static_cast<float>(TimeSeconds - LastTimeSeconds);
+    if (!bHasState || DeltaSeconds <= 0.0f)
+    {
+        if (!bHasState)
+        {
+            Smoothed = Direction;
+            SmoothedVelocity = FVector::ZeroVector;
+            LastTimeSeconds = TimeSeconds;
+            bHasState = true;
+        }
+        Value = Smoothed.GetSafeNormal();
+        return Value;
+    }
+    LastTimeSeconds = TimeSeconds;
+
+    if (Settings.Type == EGazeFilterType::Exponential)
+    {
+        const float Weight = 1.0f - FMath::Exp(-DeltaSeconds / FMath::Max(Settings.TimeConstantSeconds, KINDA_SMALL_NUMBER));
+        Smoothed += (Direction - Smoothed) * Weight;
+    }
+    else
+    {
+        // One Euro: smooth the speed, then let it raise the cutoff for the direction
+        const FVector Velocity = (Direction - Smoothed) / DeltaSeconds;
+        SmoothedVelocity += (Velocity - SmoothedVelocity) * Alpha(Settings.DerivativeCutoffHz, DeltaSeconds);
+        const float CutoffHz = Settings.MinCutoffHz + Settings.Beta * SmoothedVelocity.Size();
+        Smoothed += (Direction - Smoothed) * Alpha(CutoffHz, DeltaSeconds);
+    }
+
+    Value = Smoothed.GetSafeNormal();
+    return Value;
+}
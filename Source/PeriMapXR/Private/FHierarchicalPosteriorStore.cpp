@@ -0,0 +1,213 @@
+// FHierarchicalPosteriorStore.cpp
+
+#include "FHierarchicalPosteriorStore.h"
+
+FHierarchicalPosteriorStore::FHierarchicalPosteriorStore()
+    : MostProbableHypothesis(0)
+    , NumComplete(0)
+{
+}
+
+void FHierarchicalPosteriorStore::Initialize(const TArray<TSharedRef<const FPsychometricTable>>& InTables)
+{
+    check(InTables.Num() > 0);
+
+    Tables = InTables;
+    Hypotheses.SetNum(Tables.Num());
+    for (int32 Hypothesis = 0; Hypothesis < Tables.Num(); ++Hypothesis)
+    {
+        check(Tables[Hypothesis]->GetThresholdLevels() == Tables[0]->GetThresholdLevels());
+        Hypotheses[Hypothesis].Initialize(Tables[Hypothesis]);
+    }
+
+    LogPriors.Init(0.0f, Tables.Num());
+    Means.Empty();
+    StandardDeviations.Empty();
+    CompleteFlags.Empty();
+    Reset();
+}
+
+void FHierarchicalPosteriorStore::Reset()
+{
+    for (FPosteriorStore& Store : Hypotheses)
+    {
+        Store.Reset();
+    }
+    LogEvidence.Init(0.0f, Hypotheses.Num());
+    Means.Reset();
+    StandardDeviations.Reset();
+    CompleteFlags.Reset();
+    NumComplete = 0;
+    RefreshWeights();
+}
+
+int32 FHierarchicalPosteriorStore::AddLocation()
+{
+    check(Hypotheses.Num() > 0);
+
+    for (FPosteriorStore& Store : Hypotheses)
+    {
+        Store.AddLocation();
+    }
+    const int32 Index = CompleteFlags.Add(0);
+    Means.AddZeroed();
+    StandardDeviations.AddZeroed();
+    RefreshMixture(Index);
+    return Index;
+}
+
+void FHierarchicalPosteriorStore::Update(int32 Index, float StimulusIntensity, bool bSeen)
+{
+    // Each hypothesis explains the response with its own table; how well it did is evidence for it
+    for (int32 Hypothesis = 0; Hypothesis < Hypotheses.Num(); ++Hypothesis)
+    {
+        LogEvidence[Hypothesis] += Hypotheses[Hypothesis].Update(Index, StimulusIntensity, bSeen);
+    }
+
+    if (Hypotheses.Num() == 1)
+    {
+        RefreshMixture(Index);
+        return;
+    }
+
+    // The weights moved, so every location's mixture moves with them
+    RefreshWeights();
+    for (int32 Location = 0; Location < Num(); ++Location)
+    {
+        RefreshMixture(Location);
+    }
+}
+
+void FHierarchicalPosteriorStore::ApplyGaussianPrior(int32 Index, float MeanInDb, float StandardDeviationInDb)
+{
+    for (FPosteriorStore& Store : Hypotheses)
+    {
+        Store.ApplyGaussianPrior(Index, MeanInDb, StandardDeviationInDb);
+    }
+    RefreshMixture(Index);
+}
+
+float FHierarchicalPosteriorStore::SelectMinimumEntropyIntensity(int32 Index) const
+{
+    // The mixture's entropy would need every hypothesis expanded; the dominant one is close and costs one
+    return Hypotheses[MostProbableHypothesis].SelectMinimumEntropyIntensity(Index);
+}
+
+void FHierarchicalPosteriorStore::SetComplete(int32 Index, bool bComplete)
+{
+    const uint8 NewFlag = bComplete ? 1 : 0;
+    if (CompleteFlags[Index] != NewFlag)
+    {
+        CompleteFlags[Index] = NewFlag;
+        NumComplete += bComplete ? 1 : -1;
+    }
+}
+
+void FHierarchicalPosteriorStore::GetPosterior(int32 Index, TArray<float>& OutPosterior) const
+{
+    OutPosterior.Init(0.0f, GetNumThresholds());
+
+    TArray<float> HypothesisPosterior;
+    for (int32 Hypothesis = 0; Hypothesis < Hypotheses.Num(); ++Hypothesis)
+    {
+        Hypotheses[Hypothesis].GetPosterior(Index, HypothesisPosterior);
+        for (int32 i = 0; i < OutPosterior.Num(); ++i)
+        {
+            OutPosterior[i] += Weights[Hypothesis] * HypothesisPosterior[i];
+        }
+    }
+}
+
+float FHierarchicalPosteriorStore::GetExpectedSlope() const
+{
+    float Slope = 0.0f;
+    for (int32 Hypothesis = 0; Hypothesis < Hypotheses.Num(); ++Hypothesis)
+    {
+        Slope += Weights[Hypothesis] * GetHypothesisParams(Hypothesis).Slope;
+    }
+    return Slope;
+}
+
+float FHierarchicalPosteriorStore::GetExpectedLapseRate() const
+{
+    float LapseRate = 0.0f;
+    for (int32 Hypothesis = 0; Hypothesis < Hypotheses.Num(); ++Hypothesis)
+    {
+        LapseRate += Weights[Hypothesis] * GetHypothesisParams(Hypothesis).LapseRate;
+    }
+    return LapseRate;
+}
+
+void FHierarchicalPosteriorStore::SetHypothesisLogPrior(TArrayView<const float> InLogPrior)
+{
+    if (InLogPrior.Num() != LogPriors.Num())
+    {
+        return;
+    }
+
+    LogPriors.Reset();
+    LogPriors.Append(InLogPrior.GetData(), InLogPrior.Num());
+    RefreshWeights();
+    for (int32 Location = 0; Location < Num(); ++Location)
+    {
+        RefreshMixture(Location);
+    }
+}
+
+TArray<float> FHierarchicalPosteriorStore::GetHypothesisLogPosterior() const
+{
+    TArray<float> LogPosterior = LogPriors;
+    for (int32 Hypothesis = 0; Hypothesis < LogPosterior.Num(); ++Hypothesis)
+    {
+        LogPosterior[Hypothesis] += LogEvidence[Hypothesis];
+    }
+    return LogPosterior;
+}
+
+void FHierarchicalPosteriorStore::RefreshWeights()
+{
+    const int32 NumHypotheses = LogPriors.Num();
+    Weights.SetNumUninitialized(NumHypotheses);
+    if (NumHypotheses == 0)
+    {
+        return;
+    }
+
+    // Subtract the largest log posterior before exponentiating; evidence grows without bound over a session
+    MostProbableHypothesis = 0;
+    for (int32 Hypothesis = 1; Hypothesis < NumHypotheses; ++Hypothesis)
+    {
+        if (LogPriors[Hypothesis] + LogEvidence[Hypothesis] > LogPriors[MostProbableHypothesis] + LogEvidence[MostProbableHypothesis])
+        {
+            MostProbableHypothesis = Hypothesis;
+        }
+    }
+
+    const float MaxLogPosterior = LogPriors[MostProbableHypothesis] + LogEvidence[MostProbableHypothesis];
+    float Sum = 0.0f;
+    for (int32 Hypothesis = 0; Hypothesis < NumHypotheses; ++Hypothesis)
+    {
+        Weights[Hypothesis] = FMath::Exp(LogPriors[Hypothesis] + LogEvidence[Hypothesis] - MaxLogPosterior);
+        Sum += Weights[Hypothesis];
+    }
+    for (float& Weight : Weights)
+    {
+        Weight /= Sum;
+    }
+}
+
+void FHierarchicalPosteriorStore::RefreshMixture(int32 Index)
+{
+    // Mean = sum(w * m); variance = sum(w * (s^2 + m^2)) - Mean^2
+    float Mean = 0.0f;
+    float SecondMoment = 0.0f;
+    for (int32 Hypothesis = 0; Hypothesis < Hypotheses.Num(); ++Hypothesis)
+    {
+        const float HypothesisMean = Hypotheses[Hypothesis].GetMean(Index);
+        const float HypothesisDeviation = Hypotheses[Hypothesis].GetStandardDeviation(Index);
+        Mean += Weights[Hypothesis] * HypothesisMean;
+        SecondMoment += Weights[Hypothesis] * (HypothesisDeviation * HypothesisDeviation + HypothesisMean * HypothesisMean);
+    }
+    Means[Index] = Mean;
+    StandardDeviations[Index] = FMath::Sqrt(FMath::Max(SecondMoment - Mean * Mean, 0.0f));
+}
@@ -0,0 +1,34 @@
+// FLocationRegistry.cpp
+
+#include "FLocationRegistry.h"
+
+int32 FLocationRegistry::FindOrAdd(const FVector& Location)
+{
+    const FIntVector Key = MakeKey(Location);
+    if (const int32* ExistingId = IdsByKey.Find(Key))
+    {
+        return *ExistingId;
+    }
+
+    const int32 LocationId = Locations.Add(Location);
+    IdsByKey.Add(Key, LocationId);
+    return LocationId;
+}
+
+int32 FLocationRegistry::Find(const FVector& Location) const
+{
+    const int32* ExistingId = IdsByKey.Find(MakeKey(Location));
+    return ExistingId ? *ExistingId : INDEX_NONE;
+}
+
+void FLocationRegistry::Reset()
+{
+    Locations.Reset();
+    IdsByKey.Reset();
+}
+
+FIntVector FLocationRegistry::MakeKey(const FVector& Location)
+{
+    // 0.01 cm cells; stimuli are centimetres apart, so neighbouring points never share a key
+    return FIntVector(FMath::RoundToInt(Location.X * 100.0), FMath::RoundToInt(Location.Y * 100.0), FMath::RoundToInt(Location.Z * 100.0));
+}
@@ -0,0 +1,284 @@
+// FLogFileSink.cpp
+
+#include "FLogFileSink.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+FLogFileSink::FLogFileSink(const FString& InDirectory, const FString& InPrefix, const FString& InExtension, const FLogFileSinkSettings& InSettings, TArray<uint8> InFileHeader)
+    : Directory(InDirectory)
+    , Prefix(InPrefix)
+    , Extension(InExtension)
+    , SessionTag(FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")))
+    , Settings(InSettings)
+    , FileHeader(MoveTemp(InFileHeader))
+    , PendingBytes(0)
+    , DroppedCount(0)
+    , ReportedDroppedCount(0)
+    , LastWriteTime(FPlatformTime::Seconds())
+    , FileIndex(-1)
+    , FileBytesWritten(0)
+    , WakeEvent(nullptr)
+    , Thread(nullptr)
+    , bUseWriterThread(false)
+    , bStopping(false)
+{
+    Settings.BatchSizeBytes = FMath::Max(Settings.BatchSizeBytes, 256);
+    Settings.FlushIntervalSeconds = FMath::Max(Settings.FlushIntervalSeconds, 0.01f);
+    Settings.MaxPendingBytes = FMath::Max<int64>(Settings.MaxPendingBytes, Settings.BatchSizeBytes);
+
+    FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*Directory);
+
+    // The handle stays open until the file is rotated instead of being reopened per message
+    OpenNextFile();
+
+    Batch.Reserve(Settings.BatchSizeBytes * 2);
+
+    // Fall back to writing on the calling thread on platforms without threading support
+    if (FPlatformProcess::SupportsMultithreading())
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+        bUseWriterThread = true;
+        Thread = FRunnableThread::Create(this, TEXT("PeriMapXRLogWriter"), 0, TPri_BelowNormal);
+        bUseWriterThread = Thread != nullptr;
+    }
+}
+
+FLogFileSink::~FLogFileSink()
+{
+    if (Thread)
+    {
+        // Stop() wakes the writer, which drains the queue before exiting
+        Thread->Kill(true);
+        delete Thread;
+        Thread = nullptr;
+        bUseWriterThread = false;
+    }
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+
+    // Anything enqueued after the thread exited, or everything when running single-threaded
+    FScopeLock Lock(&DrainLock);
+    DrainQueue(true);
+    FileHandle.Reset();
+}
+
+bool FLogFileSink::Enqueue(FString&& Record)
+{
+    FPendingRecord PendingRecord;
+    PendingRecord.Text = MoveTemp(Record);
+    return EnqueueRecord(MoveTemp(PendingRecord));
+}
+
+bool FLogFileSink::Enqueue(TArray<uint8>&& Record)
+{
+    FPendingRecord PendingRecord;
+    PendingRecord.Bytes = MoveTemp(Record);
+    return EnqueueRecord(MoveTemp(PendingRecord));
+}
+
+bool FLogFileSink::EnqueueRecord(FPendingRecord&& Record)
+{
+    const int64 RecordBytes = Record.GetSize();
+
+    // Bounded-memory drop policy: never let the backlog grow past MaxPendingBytes
+    const int64 NewPendingBytes = PendingBytes.fetch_add(RecordBytes, std::memory_order_relaxed) + RecordBytes;
+    if (NewPendingBytes > Settings.MaxPendingBytes)
+    {
+        PendingBytes.fetch_sub(RecordBytes, std::memory_order_relaxed);
+        DroppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    PendingRecords.Enqueue(MoveTemp(Record));
+
+    if (!bUseWriterThread)
+    {
+        // Every producer drains here, but the queue only supports one consumer at a time
+        FScopeLock Lock(&DrainLock);
+        DrainQueue(false);
+    }
+    else if (NewPendingBytes >= Settings.BatchSizeBytes && WakeEvent)
+    {
+        // Only wake the writer early when a full batch is waiting; otherwise it wakes on its interval
+        WakeEvent->Trigger();
+    }
+    return true;
+}
+
+uint32 FLogFileSink::Run()
+{
+    const uint32 WaitMs = FMath::Max(1u, static_cast<uint32>(Settings.FlushIntervalSeconds * 1000.0f));
+    while (!bStopping.load(std::memory_order_acquire))
+    {
+        WakeEvent->Wait(WaitMs);
+        DrainQueue(false);
+    }
+
+    DrainQueue(true);
+    return 0;
+}
+
+void FLogFileSink::Stop()
+{
+    bStopping.store(true, std::memory_order_release);
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+void FLogFileSink::DrainQueue(bool bForceWrite)
+{
+    FPendingRecord Record;
+    while (PendingRecords.Dequeue(Record))
+    {
+        PendingBytes.fetch_sub(Record.GetSize(), std::memory_order_relaxed);
+        if (Record.Bytes.Num() > 0)
+        {
+            AppendToBatch(Record.Bytes);
+        }
+        else
+        {
+            AppendToBatch(Record.Text);
+        }
+
+        if (Batch.Num() >= Settings.BatchSizeBytes)
+        {
+            WriteBatch();
+        }
+    }
+
+    // Note dropped records once per flush rather than once per drop (text logs only, binary logs keep their framing)
+    const int64 CurrentDropped = DroppedCount.load(std::memory_order_relaxed);
+    if (CurrentDropped != ReportedDroppedCount && !Settings.bBinary)
+    {
+        AppendToBatch(FString::Printf(TEXT("[FLogFileSink] %lld record(s) dropped, backlog exceeded %lld bytes\n"), CurrentDropped - ReportedDroppedCount, Settings.MaxPendingBytes));
+        ReportedDroppedCount = CurrentDropped;
+    }
+
+    const bool bIntervalElapsed = FPlatformTime::Seconds() - LastWriteTime >= Settings.FlushIntervalSeconds;
+    if (Batch.Num() > 0 && (bForceWrite || bIntervalElapsed || !bUseWriterThread))
+    {
+        WriteBatch();
+    }
+}
+
+void FLogFileSink::WriteBatch()
+{
+    if (FileHandle && Batch.Num() > 0)
+    {
+        FileHandle->Write(Batch.GetData(), Batch.Num());
+        FileHandle->Flush();
+        FileBytesWritten += Batch.Num();
+    }
+    Batch.Reset();
+    LastWriteTime = FPlatformTime::Seconds();
+
+    // Batches only hold whole records, so rotating between batches never splits a record
+    if (Settings.MaxFileSizeBytes > 0 && FileBytesWritten >= Settings.MaxFileSizeBytes)
+    {
+        OpenNextFile();
+    }
+}
+
+void FLogFileSink::OpenNextFile()
+{
+    FileHandle.Reset();
+    FileIndex++;
+    FileBytesWritten = 0;
+
+    const FString FilePath = FPaths::Combine(Directory, FString::Printf(TEXT("%s_%s_%03d.%s"), *Prefix, *SessionTag, FileIndex, *Extension));
+    FileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath, false, true));
+    if (!FileHandle)
+    {
+        UE_LOG(LogTemp, Error, TEXT("FLogFileSink: failed to open %s for writing."), *FilePath);
+        return;
+    }
+
+    if (FileHeader.Num() > 0)
+    {
+        FileHandle->Write(FileHeader.GetData(), FileHeader.Num());
+        FileBytesWritten += FileHeader.Num();
+    }
+
+    PruneOldFiles();
+}
+
+void FLogFileSink::PruneOldFiles()
+{
+    if (Settings.MaxTotalBytes <= 0)
+    {
+        return;
+    }
+
+    struct FLogFile
+    {
+        FString Name;
+        FString AgeKey;
+        int64 Size;
+    };
+
+    TArray<FString> Patterns;
+    Patterns.Add(FString::Printf(TEXT("%s_*.%s"), *Prefix, *Extension));
+    for (const FString& Pattern : Settings.SharedBudgetPatterns)
+    {
+        Patterns.AddUnique(Pattern);
+    }
+
+    TArray<FLogFile> Candidates;
+    int64 TotalBytes = 0;
+    for (const FString& Pattern : Patterns)
+    {
+        TArray<FString> FileNames;
+        IFileManager::Get().FindFiles(FileNames, *FPaths::Combine(Directory, Pattern), true, false);
+
+        // Names embed the session time and a zero-padded index, so name order is age order within a pattern
+        FileNames.Sort();
+
+        const int32 PrefixLength = FMath::Max(Pattern.Find(TEXT("*")), 0);
+        for (int32 Index = 0; Index < FileNames.Num(); ++Index)
+        {
+            const int64 Size = FMath::Max<int64>(IFileManager::Get().FileSize(*FPaths::Combine(Directory, FileNames[Index])), 0);
+            TotalBytes += Size;
+
+            // The newest file of each pattern is the one its sink has open and is never deleted
+            if (Index < FileNames.Num() - 1)
+            {
+                Candidates.Add({ FileNames[Index], FileNames[Index].Mid(PrefixLength), Size });
+            }
+        }
+    }
+
+    // Without the prefix, names start with the session time and index, so they order by age across sinks
+    Candidates.Sort([](const FLogFile& A, const FLogFile& B) { return A.AgeKey < B.AgeKey; });
+
+    for (int32 Index = 0; Index < Candidates.Num() && TotalBytes > Settings.MaxTotalBytes; ++Index)
+    {
+        if (IFileManager::Get().Delete(*FPaths::Combine(Directory, Candidates[Index].Name)))
+        {
+            TotalBytes -= Candidates[Index].Size;
+        }
+    }
+}
+
+void FLogFileSink::AppendToBatch(const FString& Record)
+{
+    FTCHARToUTF8 Utf8Record(*Record, Record.Len());
+    Batch.Append(reinterpret_cast<const uint8*>(Utf8Record.Get()), Utf8Record.Length());
+}
+
+void FLogFileSink::AppendToBatch(const TArray<uint8>& Record)
+{
+    Batch.Append(Record);
+}
\ No newline at end of file
@@ -2,27 +2,12 @@
 
 
 #include "FLogManager.h"
-#include "Misc/DateTime.h"
-#include "HAL/FileManager.h"
+#include "UPeriMapXRLogSubsystem.h"
 #include "Engine/Engine.h"
 
-FLogManager::FLogManager()
+FLogManager::FLogManager(FName InCategory)
+    : Category(InCategory)
 {
-    // Get the current date and time for the filename
-    FString DateTimeString = GetDateTimeString();
-    FString LogFileName = FString::Printf(TEXT("Log_%s.txt"), *DateTimeString);
-
-    // Set the path for the log file
-    LogFilePath = FPaths::ProjectLogDir() + LogFileName;
-
-    // Make sure the directory exists
-    if (!FPlatformFileManager::Get().GetPlatformFile().DirectoryExists(*FPaths::ProjectLogDir()))
-    {
-        FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*FPaths::ProjectLogDir());
-    }
-
-    // Create or clear the log file
-    FFileHelper::SaveStringToFile(TEXT("Log Initialized\n"), *LogFilePath);
 }
 
 FLogManager::~FLogManager()
@@ -32,6 +17,13 @@ FLogManager::~FLogManager()
 void FLogManager::LogMessage(const FString& Message, ELogVerbosity::Type Verbosity, float DisplayTime,
     bool bEnableConsoleMessages, bool bEnableOnScreenMessages, bool bEnableSaveToLog)
 {
+    // Without the log service (e.g. during CDO construction) only the console is available
+    UPeriMapXRLogSubsystem* LogSubsystem = UPeriMapXRLogSubsystem::Get();
+    if (LogSubsystem && !LogSubsystem->IsEnabled(Category, Verbosity))
+    {
+        return;
+    }
+
     // Log to the console if enabled
     if (bEnableConsoleMessages)
     {
@@ -39,29 +31,47 @@ void FLogManager::LogMessage(const FString& Message, ELogVerbosity::Type Verbosi
     }
 
     // Log to the file if enabled
-    if (bEnableSaveToLog)
+    if (bEnableSaveToLog && LogSubsystem)
     {
-        // Prepend the message with a timestamp
-        FString LogEntry = FString::Printf(TEXT("[%s] %s\n"), *FDateTime::Now().ToString(), *Message);
-
-        // Append the log entry to the log file
-        FFileHelper::SaveStringToFile(LogEntry, *LogFilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+        LogSubsystem->WriteToFile(Category, Verbosity, Message);
     }
 
     // Display the message on screen if enabled
     if (bEnableOnScreenMessages)
     {
-        DisplayOnScreen(Message, Verbosity, DisplayTime);
+        // The overlay aggregates repeated messages and refreshes the screen at a fixed rate
+        FDiagnosticsOverlay* Overlay = LogSubsystem ? LogSubsystem->GetOverlay() : nullptr;
+        if (Overlay)
+        {
+            Overlay->Report(Category, Verbosity, Message, DisplayTime);
+        }
+        else
+        {
+            DisplayOnScreen(Message, Verbosity, DisplayTime);
+        }
+    }
+}
+
+// Checks the category filter and the enabled outputs before anything is formatted
+bool FLogManager::ShouldLog(ELogVerbosity::Type Verbosity, bool bEnableConsoleMessages, bool bEnableOnScreenMessages, bool bEnableSaveToLog) const
+{
+    if (!bEnableConsoleMessages && !bEnableOnScreenMessages && !bEnableSaveToLog)
+    {
+        return false;
     }
+
+    UPeriMapXRLogSubsystem* LogSubsystem = UPeriMapXRLogSubsystem::Get();
+    return !LogSubsystem || LogSubsystem->IsEnabled(Category, Verbosity);
 }
 
-FString FLogManager::GetDateTimeString() const
+// Reset between messages, so the buffer keeps the capacity of the longest message formatted on the thread
+FString& FLogManager::GetFormatBuffer()
 {
-    FDateTime Now = FDateTime::Now();
-    return Now.ToString(TEXT("%Y%m%d_%H%M%S"));
+    static thread_local FString Buffer;
+    return Buffer;
 }
 
-// Display messages on the screen with verbosity color-coding
+// Display messages on the screen with verbosity color-coding, used when the overlay is not running
 void FLogManager::DisplayOnScreen(const FString& Message, ELogVerbosity::Type Verbosity, float DisplayTime)
 {
     if (GEngine && GEngine->IsInitialized())
@@ -97,21 +107,21 @@ void FLogManager::LogToConsole(const FString& Message, ELogVerbosity::Type Verbo
     switch (Verbosity)
     {
     case ELogVerbosity::Warning:
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *Message);
+        UE_LOG(LogTemp, Warning, TEXT("[%s] %s"), *Category.ToString(), *Message);
         break;
     case ELogVerbosity::Error:
-        UE_LOG(LogTemp, Error, TEXT("%s"), *Message);
+        UE_LOG(LogTemp, Error, TEXT("[%s] %s"), *Category.ToString(), *Message);
         break;
     case ELogVerbosity::Fatal:
-        UE_LOG(LogTemp, Fatal, TEXT("%s"), *Message);
+        UE_LOG(LogTemp, Fatal, TEXT("[%s] %s"), *Category.ToString(), *Message);
         break;
     default:
-        UE_LOG(LogTemp, Log, TEXT("%s"), *Message);
+        UE_LOG(LogTemp, Log, TEXT("[%s] %s"), *Category.ToString(), *Message);
         break;
     }
 }
 
-// Singleton instance of the log manager
+// Shared handle for the default category
 FLogManager& FLogManager::Get()
 {
     static FLogManager Instance;
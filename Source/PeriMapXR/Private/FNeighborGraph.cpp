@@ -0,0 +1,87 @@
+// FNeighborGraph.cpp
+
+#include "FNeighborGraph.h"
+
+void FNeighborGraph::Build(const TArray<FVector>& Locations, const TArray<int32>& PatternIds, float RadiusDegrees, int32 MaxNeighbors)
+{
+    Reset();
+
+    const int32 NumLocations = Locations.Num();
+    const float RadiusRadians = FMath::DegreesToRadians(FMath::Max(RadiusDegrees, KINDA_SMALL_NUMBER));
+
+    TArray<FVector> Directions;
+    Directions.SetNumUninitialized(NumLocations);
+    for (int32 LocationId = 0; LocationId < NumLocations; ++LocationId)
+    {
+        Directions[LocationId] = Locations[LocationId].GetSafeNormal();
+    }
+
+    // Patterns are a few dozen points, so the all-pairs pass is negligible next to spawning the stimuli
+    TArray<TArray<TPair<float, int32>>> Candidates;
+    Candidates.SetNum(NumLocations);
+    for (const int32 LocationId : PatternIds)
+    {
+        TArray<TPair<float, int32>>& LocationCandidates = Candidates[LocationId];
+        if (LocationCandidates.Num() > 0)
+        {
+            continue;  // Listed twice in the pattern
+        }
+
+        for (const int32 OtherId : PatternIds)
+        {
+            if (OtherId == LocationId)
+            {
+                continue;
+            }
+
+            const float Angle = FMath::Acos(FMath::Clamp(FVector::DotProduct(Directions[LocationId], Directions[OtherId]), -1.0f, 1.0f));
+            if (Angle < RadiusRadians && !LocationCandidates.ContainsByPredicate([OtherId](const TPair<float, int32>& Pair) { return Pair.Value == OtherId; }))
+            {
+                LocationCandidates.Emplace(Angle, OtherId);
+            }
+        }
+
+        LocationCandidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+        if (LocationCandidates.Num() > MaxNeighbors)
+        {
+            LocationCandidates.SetNum(MaxNeighbors);
+        }
+    }
+
+    Offsets.SetNumUninitialized(NumLocations + 1);
+    Offsets[0] = 0;
+    for (int32 LocationId = 0; LocationId < NumLocations; ++LocationId)
+    {
+        for (const TPair<float, int32>& Candidate : Candidates[LocationId])
+        {
+            Neighbors.Add(Candidate.Value);
+            Weights.Add(1.0f - Candidate.Key / RadiusRadians);
+        }
+        Offsets[LocationId + 1] = Neighbors.Num();
+    }
+}
+
+void FNeighborGraph::Reset()
+{
+    Offsets.Reset();
+    Neighbors.Reset();
+    Weights.Reset();
+}
+
+TArrayView<const int32> FNeighborGraph::GetNeighbors(int32 LocationId) const
+{
+    if (LocationId < 0 || LocationId + 1 >= Offsets.Num())
+    {
+        return TArrayView<const int32>();
+    }
+    return TArrayView<const int32>(Neighbors.GetData() + Offsets[LocationId], Offsets[LocationId + 1] - Offsets[LocationId]);
+}
+
+TArrayView<const float> FNeighborGraph::GetWeights(int32 LocationId) const
+{
+    if (LocationId < 0 || LocationId + 1 >= Offsets.Num())
+    {
+        return TArrayView<const float>();
+    }
+    return TArrayView<const float>(Weights.GetData() + Offsets[LocationId], Offsets[LocationId + 1] - Offsets[LocationId]);
+}
\ No newline at end of file
@@ -0,0 +1,254 @@
+// FNormativePriorDatabase.cpp
+
+#include "FNormativePriorDatabase.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "FLogManager.h"
+
+namespace
+{
+    // On-disk layout, little-endian; mirrors scripts/priors/build_normative_priors.py
+    constexpr uint32 PriorFileMagic = 0x50584D50; // "PMXP"
+    constexpr uint16 PriorFileVersion = 1;
+
+    struct FPriorFileHeader
+    {
+        uint32 Magic;
+        uint16 Version;
+        uint16 NumPatternSlots;
+        float FirstAgeYears;
+        float AgeBandWidthYears;
+        uint32 NumAgeBands;
+        uint32 PatternTableOffset;
+        uint32 Reserved[2];
+    };
+
+    // One slot per ETestType value; NumLocations is zero for patterns the database does not cover
+    struct FPriorFilePattern
+    {
+        uint32 NumLocations;
+        float GridOriginHorizontalDegrees;
+        float GridOriginVerticalDegrees;
+        float GridSpacingDegrees;
+        uint16 GridWidth;
+        uint16 GridHeight;
+        uint32 CellTableOffset;  // int16 per grid cell: record index, or -1
+        uint32 RecordsOffset;    // per location: horizontal, vertical, then (mean, SD) per age band, all float
+        uint32 Reserved;
+    };
+
+    static_assert(sizeof(FPriorFileHeader) == 32, "Header layout must match the converter");
+    static_assert(sizeof(FPriorFilePattern) == 32, "Pattern layout must match the converter");
+
+    const FPriorFileHeader& GetHeader(const uint8* Data)
+    {
+        return *reinterpret_cast<const FPriorFileHeader*>(Data);
+    }
+
+    const FPriorFilePattern& GetPattern(const uint8* Data, int32 Slot)
+    {
+        return reinterpret_cast<const FPriorFilePattern*>(Data + GetHeader(Data).PatternTableOffset)[Slot];
+    }
+
+    bool IsRangeValid(int64 Offset, int64 Bytes, int64 Size)
+    {
+        return Offset >= 0 && Bytes >= 0 && Offset + Bytes <= Size && (Offset % 4) == 0;
+    }
+}
+
+FNormativePriorDatabase::FNormativePriorDatabase()
+    : Data(nullptr)
+    , Size(0)
+{
+}
+
+FNormativePriorDatabase::~FNormativePriorDatabase()
+{
+    Close();
+}
+
+const FNormativePriorDatabase& FNormativePriorDatabase::Get()
+{
+    static const FNormativePriorDatabase& Database = []() -> const FNormativePriorDatabase&
+    {
+        static FNormativePriorDatabase Instance;
+        Instance.Open(GetDefaultPath());
+        return Instance;
+    }();
+    return Database;
+}
+
+FString FNormativePriorDatabase::GetDefaultPath()
+{
+    return FPaths::ProjectDir() / TEXT("Data/PeriMapXR/NormativePriors.bin");
+}
+
+bool FNormativePriorDatabase::Open(const FString& Path)
+{
+    Close();
+    FLogManager LogManager(TEXT("NormativePriors"));
+
+    // Map the file where the platform allows it, otherwise fall back to one read
+    MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+    if (MappedFile.IsValid())
+    {
+        MappedRegion.Reset(MappedFile->MapRegion());
+    }
+
+    const uint8* CandidateData = nullptr;
+    int64 CandidateSize = 0;
+    if (MappedRegion.IsValid())
+    {
+        CandidateData = MappedRegion->GetMappedPtr();
+        CandidateSize = MappedRegion->GetMappedSize();
+    }
+    else if (FFileHelper::LoadFileToArray(LoadedBytes, *Path, FILEREAD_Silent))
+    {
+        CandidateData = LoadedBytes.GetData();
+        CandidateSize = LoadedBytes.Num();
+    }
+    else
+    {
+        LogManager.LogMessagef(ELogVerbosity::Log, 0.0f, true, false, true, TEXT("No normative prior database at %s; estimators start from uniform priors."), *Path);
+        Close();
+        return false;
+    }
+
+    if (!Validate(CandidateData, CandidateSize))
+    {
+        LogManager.LogMessagef(ELogVerbosity::Warning, 0.0f, true, false, true, TEXT("Normative prior database %s is malformed and was ignored."), *Path);
+        Close();
+        return false;
+    }
+
+    Data = CandidateData;
+    Size = CandidateSize;
+    return true;
+}
+
+void FNormativePriorDatabase::Close()
+{
+    Data = nullptr;
+    Size = 0;
+    MappedRegion.Reset();
+    MappedFile.Reset();
+    LoadedBytes.Empty();
+}
+
+bool FNormativePriorDatabase::Validate(const uint8* InData, int64 InSize) const
+{
+    // Everything a lookup touches is bounds-checked here, once, so lookups can read the mapping directly
+    if (InData == nullptr || !IsAligned(InData, 4) || InSize < int64(sizeof(FPriorFileHeader)))
+    {
+        return false;
+    }
+
+    const FPriorFileHeader& Header = GetHeader(InData);
+    if (Header.Magic != PriorFileMagic || Header.Version != PriorFileVersion || Header.NumAgeBands == 0 || Header.AgeBandWidthYears <= 0.0f)
+    {
+        return false;
+    }
+    if (!IsRangeValid(Header.PatternTableOffset, int64(Header.NumPatternSlots) * sizeof(FPriorFilePattern), InSize))
+    {
+        return false;
+    }
+
+    const int64 RecordStride = 8 + 8 * int64(Header.NumAgeBands);
+    for (int32 Slot = 0; Slot < Header.NumPatternSlots; ++Slot)
+    {
+        const FPriorFilePattern& Pattern = GetPattern(InData, Slot);
+        if (Pattern.NumLocations == 0)
+        {
+            continue;
+        }
+
+        const int64 NumCells = int64(Pattern.GridWidth) * Pattern.GridHeight;
+        if (Pattern.GridSpacingDegrees <= 0.0f || NumCells == 0
+            || !IsRangeValid(Pattern.CellTableOffset, NumCells * sizeof(int16), InSize)
+            || !IsRangeValid(Pattern.RecordsOffset, Pattern.NumLocations * RecordStride, InSize))
+        {
+            return false;
+        }
+
+        const int16* Cells = reinterpret_cast<const int16*>(InData + Pattern.CellTableOffset);
+        for (int64 Cell = 0; Cell < NumCells; ++Cell)
+        {
+            if (Cells[Cell] < -1 || Cells[Cell] >= int64(Pattern.NumLocations))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+FNormativePriorSelection FNormativePriorDatabase::Select(ETestType TestType, int32 AgeYears) const
+{
+    FNormativePriorSelection Selection;
+    if (!IsValid())
+    {
+        return Selection;
+    }
+
+    const FPriorFileHeader& Header = GetHeader(Data);
+    const int32 Slot = static_cast<int32>(TestType);
+    if (Slot >= Header.NumPatternSlots)
+    {
+        return Selection;
+    }
+
+    const FPriorFilePattern& Pattern = GetPattern(Data, Slot);
+    if (Pattern.NumLocations == 0)
+    {
+        return Selection;
+    }
+
+    // Bands are evenly spaced, so the band is arithmetic; ages outside the table use the nearest band
+    const int32 Band = FMath::Clamp(FMath::FloorToInt((AgeYears - Header.FirstAgeYears) / Header.AgeBandWidthYears), 0, int32(Header.NumAgeBands) - 1);
+
+    Selection.Records = Data + Pattern.RecordsOffset;
+    Selection.Cells = reinterpret_cast<const int16*>(Data + Pattern.CellTableOffset);
+    Selection.GridOriginHorizontal = Pattern.GridOriginHorizontalDegrees;
+    Selection.GridOriginVertical = Pattern.GridOriginVerticalDegrees;
+    Selection.InverseGridSpacing = 1.0f / Pattern.GridSpacingDegrees;
+    Selection.GridWidth = Pattern.GridWidth;
+    Selection.GridHeight = Pattern.GridHeight;
+    Selection.RecordStride = 8 + 8 * Header.NumAgeBands;
+    Selection.BandOffset = 8 + 8 * Band;
+    return Selection;
+}
+
+void FNormativePriorDatabase::ToFieldDegrees(const FVector& Location, float& OutHorizontalDegrees, float& OutVerticalDegrees)
+{
+    const FVector Direction = Location.GetSafeNormal();
+    OutHorizontalDegrees = static_cast<float>(FMath::RadiansToDegrees(FMath::Atan2(Direction.X, Direction.Z)));
+    OutVerticalDegrees = static_cast<float>(FMath::RadiansToDegrees(FMath::Asin(FMath::Clamp(Direction.Y, -1.0, 1.0))));
+}
+
+bool FNormativePriorSelection::Find(float HorizontalDegrees, float VerticalDegrees, FNormativePrior& OutPrior) const
+{
+    if (!IsValid())
+    {
+        return false;
+    }
+
+    const int32 Column = FMath::RoundToInt((HorizontalDegrees - GridOriginHorizontal) * InverseGridSpacing);
+    const int32 GridRow = FMath::RoundToInt((VerticalDegrees - GridOriginVertical) * InverseGridSpacing);
+    if (Column < 0 || Column >= GridWidth || GridRow < 0 || GridRow >= GridHeight)
+    {
+        return false;
+    }
+
+    const int16 RecordIndex = Cells[GridRow * GridWidth + Column];
+    if (RecordIndex < 0)
+    {
+        return false;
+    }
+
+    const float* Prior = reinterpret_cast<const float*>(Records + RecordIndex * RecordStride + BandOffset);
+    OutPrior.MeanInDb = Prior[0];
+    OutPrior.StandardDeviationInDb = Prior[1];
+    return true;
+}
\ No newline at end of file
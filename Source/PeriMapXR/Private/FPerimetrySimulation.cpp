@@ -0,0 +1,219 @@
+// FPerimetrySimulation.cpp
+
+#include "FPerimetrySimulation.h"
+#include "UThresholdEstimator.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "UObject/Package.h"
+
+namespace
+{
+    // Running totals for the sessions handled by one worker
+    struct FSimulationTotals
+    {
+        double SumError = 0.0;
+        double SumAbsoluteError = 0.0;
+        double SumSquaredError = 0.0;
+        int64 NumEstimates = 0;
+        int64 NumCompleted = 0;
+        int64 NumTrials = 0;
+        int64 NumCatchTrials = 0;
+        int64 NumFalsePositives = 0;
+        int64 NumRejectedTrials = 0;
+        int64 NumUnreliableTrials = 0;
+        double SumDurationSeconds = 0.0;
+        double SumSlope = 0.0;
+        double SumLapseRate = 0.0;
+        uint64 CpuCycles = 0;
+
+        void Add(const FSimulationTotals& Other)
+        {
+            SumError += Other.SumError;
+            SumAbsoluteError += Other.SumAbsoluteError;
+            SumSquaredError += Other.SumSquaredError;
+            NumEstimates += Other.NumEstimates;
+            NumCompleted += Other.NumCompleted;
+            NumTrials += Other.NumTrials;
+            NumCatchTrials += Other.NumCatchTrials;
+            NumFalsePositives += Other.NumFalsePositives;
+            NumRejectedTrials += Other.NumRejectedTrials;
+            NumUnreliableTrials += Other.NumUnreliableTrials;
+            SumDurationSeconds += Other.SumDurationSeconds;
+            SumSlope += Other.SumSlope;
+            SumLapseRate += Other.SumLapseRate;
+            CpuCycles += Other.CpuCycles;
+        }
+    };
+
+    // One session, following the same steps as ATestStimuli::RunTest and its response handler
+    void RunSession(const FPerimetrySimulationSettings& Settings, UThresholdEstimator& Estimator, const TArray<int32>& LocationIds, int32 SessionIndex, FSimulationTotals& Totals)
+    {
+        const int32 Seed = Settings.RandomSeed + SessionIndex;
+        const int32 NumLocations = Settings.Locations.Num();
+
+        TArray<float> TrueThresholdsInDb = Settings.TrueThresholdsInDb;
+        if (TrueThresholdsInDb.Num() != NumLocations)
+        {
+            FRandomStream MapStream(Seed ^ 0x5EED);
+            TrueThresholdsInDb.SetNumUninitialized(NumLocations);
+            for (float& Threshold : TrueThresholdsInDb)
+            {
+                Threshold = MapStream.FRandRange(Settings.MinTrueThresholdInDb, Settings.MaxTrueThresholdInDb);
+            }
+        }
+        FSimulatedObserver Observer(TrueThresholdsInDb, Settings.Observer, Seed);
+
+        Estimator.SelectionStrategy = Settings.SelectionStrategy;
+        Estimator.bEstimatePatientPsychometrics = Settings.bEstimatePatientPsychometrics;
+        Estimator.Initialize(FTestSettings(), Settings.TestType, true);
+
+        FTrialSchedulerSettings SchedulerSettings = Settings.Scheduler;
+        SchedulerSettings.RandomSeed = Seed != 0 ? Seed : 1;
+        FTrialScheduler Scheduler;
+        Scheduler.Reset(Settings.Locations, SchedulerSettings);
+
+        const double SecondsPerTrial = Settings.StimuliDuration + Settings.TimeBetweenStimuli;
+        while (!Scheduler.IsFinished())
+        {
+            if (Scheduler.ShouldRunCatchTrial())
+            {
+                ++Totals.NumCatchTrials;
+                Totals.NumFalsePositives += Observer.RespondToCatchTrial() ? 1 : 0;
+                Totals.SumDurationSeconds += SecondsPerTrial;
+                continue;
+            }
+
+            const uint64 SelectStart = FPlatformTime::Cycles64();
+            const int32 LocationIndex = Scheduler.PopNext();
+            if (LocationIndex == INDEX_NONE)
+            {
+                break;
+            }
+            const int32 LocationId = LocationIds[LocationIndex];
+            const float StimulusIntensityInDb = Estimator.GetNextStimulusIntensityInDbById(LocationId);
+            const uint64 SelectEnd = FPlatformTime::Cycles64();
+
+            // A saccade or blink rejects the trial and re-queues the location, as the response handler does; once the
+            // location is out of retests the trial is scored, and a patient looking away does not see the stimulus
+            const bool bFixationLost = Observer.LosesFixation();
+            if (bFixationLost && Scheduler.RejectTrial(LocationIndex))
+            {
+                Totals.CpuCycles += SelectEnd - SelectStart;
+                ++Totals.NumRejectedTrials;
+                Totals.SumDurationSeconds += SecondsPerTrial;
+                continue;
+            }
+            Totals.NumUnreliableTrials += bFixationLost ? 1 : 0;
+
+            const bool bSeen = !bFixationLost && Observer.Respond(LocationIndex, StimulusIntensityInDb);
+
+            const uint64 UpdateStart = FPlatformTime::Cycles64();
+            Estimator.UpdateWithResponseById(LocationId, StimulusIntensityInDb, bSeen);
+            Scheduler.ReportResult(LocationIndex, Estimator.GetThresholdUncertaintyInDbById(LocationId), Estimator.IsThresholdEstimationCompleteById(LocationId));
+            const uint64 UpdateEnd = FPlatformTime::Cycles64();
+
+            Totals.CpuCycles += (SelectEnd - SelectStart) + (UpdateEnd - UpdateStart);
+            ++Totals.NumTrials;
+            Totals.SumDurationSeconds += SecondsPerTrial;
+        }
+
+        // Completion is read before CalculateFinalThresholds fills in the locations that hit the presentation cap
+        for (int32 LocationIndex = 0; LocationIndex < NumLocations; ++LocationIndex)
+        {
+            Totals.NumCompleted += Estimator.IsThresholdEstimationCompleteById(LocationIds[LocationIndex]) ? 1 : 0;
+        }
+
+        Totals.SumSlope += Estimator.GetPatientSlope();
+        Totals.SumLapseRate += Estimator.GetPatientLapseRate();
+
+        Estimator.CalculateFinalThresholds();
+        for (int32 LocationIndex = 0; LocationIndex < NumLocations; ++LocationIndex)
+        {
+            const double Error = Estimator.GetThresholdEstimateInDbById(LocationIds[LocationIndex]) - TrueThresholdsInDb[LocationIndex];
+            Totals.SumError += Error;
+            Totals.SumAbsoluteError += FMath::Abs(Error);
+            Totals.SumSquaredError += Error * Error;
+            ++Totals.NumEstimates;
+        }
+    }
+}
+
+FPerimetrySimulationReport FPerimetrySimulation::Run(const FPerimetrySimulationSettings& Settings)
+{
+    check(IsInGameThread());
+
+    FPerimetrySimulationReport Report;
+    Report.NumSessions = Settings.NumSessions;
+    Report.NumLocations = Settings.Locations.Num();
+    if (Settings.NumSessions <= 0 || Settings.Locations.Num() == 0)
+    {
+        return Report;
+    }
+
+    const double WallStart = FPlatformTime::Seconds();
+
+    // Estimators are UObjects, so they are created here and only their plain methods run on the workers
+    const int32 NumWorkers = FMath::Clamp(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, 1, Settings.NumSessions);
+    TArray<UThresholdEstimator*> Estimators;
+    TArray<TArray<int32>> LocationIds;
+    for (int32 Worker = 0; Worker < NumWorkers; ++Worker)
+    {
+        UThresholdEstimator* Estimator = NewObject<UThresholdEstimator>(GetTransientPackage());
+        Estimator->AddToRoot();
+        LocationIds.Add(Estimator->RegisterLocations(Settings.Locations));
+        Estimators.Add(Estimator);
+    }
+
+    TArray<FSimulationTotals> WorkerTotals;
+    WorkerTotals.SetNum(NumWorkers);
+    ParallelFor(NumWorkers, [&](int32 Worker)
+    {
+        for (int32 SessionIndex = Worker; SessionIndex < Settings.NumSessions; SessionIndex += NumWorkers)
+        {
+            RunSession(Settings, *Estimators[Worker], LocationIds[Worker], SessionIndex, WorkerTotals[Worker]);
+        }
+    });
+
+    for (UThresholdEstimator* Estimator : Estimators)
+    {
+        Estimator->RemoveFromRoot();
+    }
+
+    FSimulationTotals Totals;
+    for (const FSimulationTotals& Worker : WorkerTotals)
+    {
+        Totals.Add(Worker);
+    }
+
+    const double NumSessions = Settings.NumSessions;
+    const double NumEstimates = FMath::Max<int64>(Totals.NumEstimates, 1);
+    Report.MeanErrorInDb = Totals.SumError / NumEstimates;
+    Report.MeanAbsoluteErrorInDb = Totals.SumAbsoluteError / NumEstimates;
+    Report.RootMeanSquareErrorInDb = FMath::Sqrt(Totals.SumSquaredError / NumEstimates);
+    Report.CompletionRate = Totals.NumCompleted / NumEstimates;
+    Report.MeanPresentationsPerLocation = Totals.NumTrials / NumEstimates;
+    Report.MeanPresentationsPerSession = Totals.NumTrials / NumSessions;
+    Report.MeanCatchTrialsPerSession = Totals.NumCatchTrials / NumSessions;
+    Report.MeanRejectedTrialsPerSession = Totals.NumRejectedTrials / NumSessions;
+    Report.MeanUnreliableTrialsPerSession = Totals.NumUnreliableTrials / NumSessions;
+    Report.MeasuredFalsePositiveRate = Totals.NumCatchTrials > 0 ? double(Totals.NumFalsePositives) / Totals.NumCatchTrials : 0.0;
+    Report.MeanEstimatedSlope = Totals.SumSlope / NumSessions;
+    Report.MeanEstimatedLapseRate = Totals.SumLapseRate / NumSessions;
+    Report.MeanSessionDurationSeconds = Totals.SumDurationSeconds / NumSessions;
+    Report.MeanCpuMicrosecondsPerTrial = Totals.NumTrials > 0 ? FPlatformTime::ToMilliseconds64(Totals.CpuCycles) * 1000.0 / Totals.NumTrials : 0.0;
+    Report.WallSeconds = FPlatformTime::Seconds() - WallStart;
+    return Report;
+}
+
+FString FPerimetrySimulationReport::ToString() const
+{
+    return FString::Printf(
+        TEXT("%d sessions x %d locations: error mean %.2f dB, MAE %.2f dB, RMSE %.2f dB, completed %.1f%%, ")
+        TEXT("%.2f presentations/location, %.1f presentations/session, %.1f catch trials/session (FP rate %.3f), ")
+        TEXT("%.1f rejected and %.1f unreliable trials/session, ")
+        TEXT("slope %.2f dB, lapse %.3f, %.1f s/session, %.2f us CPU/trial, %.2f s wall"),
+        NumSessions, NumLocations, MeanErrorInDb, MeanAbsoluteErrorInDb, RootMeanSquareErrorInDb, CompletionRate * 100.0,
+        MeanPresentationsPerLocation, MeanPresentationsPerSession, MeanCatchTrialsPerSession, MeasuredFalsePositiveRate,
+        MeanRejectedTrialsPerSession, MeanUnreliableTrialsPerSession,
+        MeanEstimatedSlope, MeanEstimatedLapseRate, MeanSessionDurationSeconds, MeanCpuMicrosecondsPerTrial, WallSeconds);
+}
\ No newline at end of file
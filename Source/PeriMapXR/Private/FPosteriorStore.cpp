@@ -0,0 +1,268 @@
+// FPosteriorStore.cpp
+
+#include "FPosteriorStore.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    // Log probability held in row padding: exp() of it is exactly zero, and it stays finite through re-centring
+    constexpr float PaddingLogProbability = -1.0e30f;
+}
+
+FPosteriorStore::FPosteriorStore()
+    : NumThresholds(0)
+    , Stride(0)
+    , NumComplete(0)
+{
+}
+
+void FPosteriorStore::Initialize(const TSharedRef<const FPsychometricTable>& InTable)
+{
+    Table = InTable;
+    NumThresholds = InTable->GetNumThresholds();
+    Stride = InTable->GetRowStride();
+
+    PaddedLevels.SetNumZeroed(Stride);
+    FMemory::Memcpy(PaddedLevels.GetData(), InTable->GetThresholdLevels().GetData(), NumThresholds * sizeof(float));
+
+    LogPosteriors.Empty();
+    LogNormalizers.Empty();
+    Means.Empty();
+    StandardDeviations.Empty();
+    CompleteFlags.Empty();
+    NumComplete = 0;
+}
+
+void FPosteriorStore::Reset()
+{
+    LogPosteriors.Reset();
+    LogNormalizers.Reset();
+    Means.Reset();
+    StandardDeviations.Reset();
+    CompleteFlags.Reset();
+    NumComplete = 0;
+}
+
+int32 FPosteriorStore::AddLocation()
+{
+    check(Table.IsValid());
+
+    const int32 Index = CompleteFlags.Add(0);
+    LogPosteriors.AddUninitialized(Stride);
+    LogNormalizers.AddZeroed();
+    Means.AddZeroed();
+    StandardDeviations.AddZeroed();
+
+    SetUniform(&LogPosteriors[Index * Stride]);
+    RefreshRow(Index, 0.0f);
+    return Index;
+}
+
+float FPosteriorStore::Update(int32 Index, float StimulusIntensity, bool bSeen)
+{
+    // Multiplying by the likelihood is an add in log space; no renormalization pass is needed
+    float* Row = &LogPosteriors[Index * Stride];
+    const float* LogLikelihoods = Table->GetLogLikelihoodRowByIndex(Table->GetIntensityIndex(StimulusIntensity), bSeen);
+    const float PreviousLogNormalizer = LogNormalizers[Index];
+    const float Max = AddRow(Row, LogLikelihoods, Stride);
+    RefreshRow(Index, Max);
+
+    // The unnormalized row was re-centred by Max, so its log sum is Max + the new normalizer
+    return Max + LogNormalizers[Index] - PreviousLogNormalizer;
+}
+
+void FPosteriorStore::ApplyGaussianPrior(int32 Index, float MeanInDb, float StandardDeviationInDb)
+{
+    float* Row = &LogPosteriors[Index * Stride];
+    const float Max = AddGaussian(Row, PaddedLevels.GetData(), MeanInDb, 1.0f / FMath::Max(StandardDeviationInDb, KINDA_SMALL_NUMBER), Stride);
+    RefreshRow(Index, Max);
+}
+
+void FPosteriorStore::RefreshRow(int32 Index, float Max)
+{
+    float Sum = 0.0f;
+    float WeightedSum = 0.0f;
+    float WeightedSumSquares = 0.0f;
+    CenterAndSum(&LogPosteriors[Index * Stride], Max, PaddedLevels.GetData(), Stride, Sum, WeightedSum, WeightedSumSquares);
+
+    // The row's maximum is now zero, so Sum is at least one and the divisions are safe
+    const float Mean = WeightedSum / Sum;
+    LogNormalizers[Index] = FMath::Loge(Sum);
+    Means[Index] = Mean;
+    StandardDeviations[Index] = FMath::Sqrt(FMath::Max(WeightedSumSquares / Sum - Mean * Mean, 0.0f));
+}
+
+float FPosteriorStore::SelectMinimumEntropyIntensity(int32 Index) const
+{
+    // With q = p * L / Z the entropy after a response is ln(Z) - A / Z, where Z = sum(p * L) is the probability
+    // of that response and A = sum(p * L * (ln p + ln L)). Weighting by Z and summing over both responses gives
+    // an expected entropy of sum(Z * ln(Z) - A), so each candidate costs two vector passes per response
+    ExpandRow(Index);
+
+    int32 BestIntensityIndex = INDEX_NONE;
+    float BestExpectedEntropy = MAX_flt;
+    for (const int32 IntensityIndex : Table->GetCandidateIntensityIndices())
+    {
+        float ExpectedEntropy = 0.0f;
+        for (const bool bSeen : { false, true })
+        {
+            float Probability = 0.0f;
+            float WeightedLog = 0.0f;
+            OutcomeSums(RowScratch.GetData(), RowLogRowScratch.GetData(), Table->GetLikelihoodRowByIndex(IntensityIndex, bSeen), Table->GetLogLikelihoodRowByIndex(IntensityIndex, bSeen), Stride, Probability, WeightedLog);
+            if (Probability > 0.0f)
+            {
+                ExpectedEntropy += Probability * FMath::Loge(Probability) - WeightedLog;
+            }
+        }
+
+        if (ExpectedEntropy < BestExpectedEntropy)
+        {
+            BestExpectedEntropy = ExpectedEntropy;
+            BestIntensityIndex = IntensityIndex;
+        }
+    }
+
+    return Table->GetIntensityAtIndex(BestIntensityIndex);
+}
+
+void FPosteriorStore::SetComplete(int32 Index, bool bComplete)
+{
+    const uint8 NewFlag = bComplete ? 1 : 0;
+    if (CompleteFlags[Index] != NewFlag)
+    {
+        CompleteFlags[Index] = NewFlag;
+        NumComplete += bComplete ? 1 : -1;
+    }
+}
+
+void FPosteriorStore::GetPosterior(int32 Index, TArray<float>& OutPosterior) const
+{
+    const float* Row = &LogPosteriors[Index * Stride];
+    const float LogNormalizer = LogNormalizers[Index];
+    OutPosterior.SetNumUninitialized(NumThresholds);
+    for (int32 i = 0; i < NumThresholds; ++i)
+    {
+        OutPosterior[i] = FMath::Exp(Row[i] - LogNormalizer);
+    }
+}
+
+void FPosteriorStore::SetUniform(float* Row) const
+{
+    // Equal log probabilities; the normalizer takes care of the 1 / NumThresholds
+    for (int32 i = 0; i < NumThresholds; ++i)
+    {
+        Row[i] = 0.0f;
+    }
+    for (int32 i = NumThresholds; i < Stride; ++i)
+    {
+        Row[i] = PaddingLogProbability;
+    }
+}
+
+void FPosteriorStore::ExpandRow(int32 Index) const
+{
+    const float* Row = &LogPosteriors[Index * Stride];
+    const float LogNormalizer = LogNormalizers[Index];
+    RowScratch.SetNumUninitialized(Stride, false);
+    RowLogRowScratch.SetNumUninitialized(Stride, false);
+    for (int32 i = 0; i < NumThresholds; ++i)
+    {
+        const float LogProbability = Row[i] - LogNormalizer;
+        RowScratch[i] = FMath::Exp(LogProbability);
+        RowLogRowScratch[i] = RowScratch[i] * LogProbability;
+    }
+    for (int32 i = NumThresholds; i < Stride; ++i)
+    {
+        RowScratch[i] = 0.0f;
+        RowLogRowScratch[i] = 0.0f;
+    }
+}
+
+float FPosteriorStore::AddRow(float* Row, const float* LogLikelihoods, int32 Count)
+{
+    // Row += log L, tracking the new maximum for re-centring
+    VectorRegister4Float Max = VectorSetFloat1(PaddingLogProbability);
+    for (int32 i = 0; i < Count; i += 4)
+    {
+        const VectorRegister4Float Sum = VectorAdd(VectorLoadAligned(Row + i), VectorLoadAligned(LogLikelihoods + i));
+        VectorStoreAligned(Sum, Row + i);
+        Max = VectorMax(Max, Sum);
+    }
+
+    alignas(16) float Lanes[4];
+    VectorStoreAligned(Max, Lanes);
+    return FMath::Max(FMath::Max(Lanes[0], Lanes[1]), FMath::Max(Lanes[2], Lanes[3]));
+}
+
+float FPosteriorStore::AddGaussian(float* Row, const float* Levels, float Mean, float InverseStandardDeviation, int32 Count)
+{
+    // Row += -0.5 * ((x - Mean) / SD)^2, tracking the new maximum; padding stays hugely negative
+    const VectorRegister4Float MeanVector = VectorSetFloat1(Mean);
+    const VectorRegister4Float InverseVector = VectorSetFloat1(InverseStandardDeviation);
+    const VectorRegister4Float MinusHalf = VectorSetFloat1(-0.5f);
+    VectorRegister4Float Max = VectorSetFloat1(PaddingLogProbability);
+    for (int32 i = 0; i < Count; i += 4)
+    {
+        const VectorRegister4Float Z = VectorMultiply(VectorSubtract(VectorLoadAligned(Levels + i), MeanVector), InverseVector);
+        const VectorRegister4Float Sum = VectorMultiplyAdd(VectorMultiply(Z, Z), MinusHalf, VectorLoadAligned(Row + i));
+        VectorStoreAligned(Sum, Row + i);
+        Max = VectorMax(Max, Sum);
+    }
+
+    alignas(16) float Lanes[4];
+    VectorStoreAligned(Max, Lanes);
+    return FMath::Max(FMath::Max(Lanes[0], Lanes[1]), FMath::Max(Lanes[2], Lanes[3]));
+}
+
+void FPosteriorStore::CenterAndSum(float* Row, float Max, const float* Levels, int32 Count, float& OutSum, float& OutWeightedSum, float& OutWeightedSumSquares)
+{
+    // Subtracts the maximum and, in the same pass, accumulates sum(e), sum(e * x) and sum(e * x^2) with e = exp(row)
+    const VectorRegister4Float MaxVector = VectorSetFloat1(Max);
+    VectorRegister4Float Sum = VectorZeroFloat();
+    VectorRegister4Float WeightedSum = VectorZeroFloat();
+    VectorRegister4Float WeightedSumSquares = VectorZeroFloat();
+    for (int32 i = 0; i < Count; i += 4)
+    {
+        const VectorRegister4Float Centered = VectorSubtract(VectorLoadAligned(Row + i), MaxVector);
+        VectorStoreAligned(Centered, Row + i);
+
+        const VectorRegister4Float Probability = VectorExp(Centered);
+        const VectorRegister4Float Level = VectorLoadAligned(Levels + i);
+        const VectorRegister4Float Weighted = VectorMultiply(Probability, Level);
+        Sum = VectorAdd(Sum, Probability);
+        WeightedSum = VectorAdd(WeightedSum, Weighted);
+        WeightedSumSquares = VectorMultiplyAdd(Weighted, Level, WeightedSumSquares);
+    }
+
+    alignas(16) float SumLanes[4];
+    alignas(16) float WeightedSumLanes[4];
+    alignas(16) float WeightedSumSquaresLanes[4];
+    VectorStoreAligned(Sum, SumLanes);
+    VectorStoreAligned(WeightedSum, WeightedSumLanes);
+    VectorStoreAligned(WeightedSumSquares, WeightedSumSquaresLanes);
+    OutSum = SumLanes[0] + SumLanes[1] + SumLanes[2] + SumLanes[3];
+    OutWeightedSum = WeightedSumLanes[0] + WeightedSumLanes[1] + WeightedSumLanes[2] + WeightedSumLanes[3];
+    OutWeightedSumSquares = WeightedSumSquaresLanes[0] + WeightedSumSquaresLanes[1] + WeightedSumSquaresLanes[2] + WeightedSumSquaresLanes[3];
+}
+
+void FPosteriorStore::OutcomeSums(const float* Row, const float* RowLogRow, const float* Likelihoods, const float* LogLikelihoods, int32 Count, float& OutProbability, float& OutWeightedLog)
+{
+    // sum(p * L) and sum(L * p ln p + p * L * ln L) in one pass; padding is zero in every input
+    VectorRegister4Float Probability = VectorZeroFloat();
+    VectorRegister4Float WeightedLog = VectorZeroFloat();
+    for (int32 i = 0; i < Count; i += 4)
+    {
+        const VectorRegister4Float Likelihood = VectorLoadAligned(Likelihoods + i);
+        const VectorRegister4Float Joint = VectorMultiply(VectorLoadAligned(Row + i), Likelihood);
+        Probability = VectorAdd(Probability, Joint);
+        WeightedLog = VectorMultiplyAdd(Likelihood, VectorLoadAligned(RowLogRow + i), WeightedLog);
+        WeightedLog = VectorMultiplyAdd(Joint, VectorLoadAligned(LogLikelihoods + i), WeightedLog);
+    }
+
+    alignas(16) float ProbabilityLanes[4];
+    alignas(16) float WeightedLogLanes[4];
+    VectorStoreAligned(Probability, ProbabilityLanes);
+    VectorStoreAligned(WeightedLog, WeightedLogLanes);
+    OutProbability = ProbabilityLanes[0] + ProbabilityLanes[1] + ProbabilityLanes[2] + ProbabilityLanes[3];
+    OutWeightedLog = WeightedLogLanes[0] + WeightedLogLanes[1] + WeightedLogLanes[2] + WeightedLogLanes[3];
+}
@@ -0,0 +1,78 @@
+// FPreviousVisitPriors.cpp
+
+#include "FPreviousVisitPriors.h"
+#include "Misc/FileHelper.h"
+
+bool FPreviousVisitPriors::Load(const FString& Path)
+{
+    Reset();
+    LoadedPath = Path;
+
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *Path) || Lines.Num() < 2)
+    {
+        return false;
+    }
+
+    // Columns are found by name, so files from older builds (without eye or field position) are rejected
+    TArray<FString> Header;
+    Lines[0].ParseIntoArray(Header, TEXT(","));
+    const int32 EyeColumn = Header.IndexOfByKey(TEXT("Eye"));
+    const int32 HorizontalColumn = Header.IndexOfByKey(TEXT("HorizontalDegrees"));
+    const int32 VerticalColumn = Header.IndexOfByKey(TEXT("VerticalDegrees"));
+    const int32 ThresholdColumn = Header.IndexOfByKey(TEXT("Threshold"));
+    const int32 DeviationColumn = Header.IndexOfByKey(TEXT("StandardDeviation"));
+    if (EyeColumn == INDEX_NONE || HorizontalColumn == INDEX_NONE || VerticalColumn == INDEX_NONE || ThresholdColumn == INDEX_NONE)
+    {
+        return false;
+    }
+    const int32 NumRequiredColumns = FMath::Max(FMath::Max(EyeColumn, HorizontalColumn), FMath::Max(FMath::Max(VerticalColumn, ThresholdColumn), DeviationColumn)) + 1;
+
+    TArray<FString> Fields;
+    for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+    {
+        Lines[LineIndex].ParseIntoArray(Fields, TEXT(","), false);
+        if (Fields.Num() < NumRequiredColumns)
+        {
+            continue;
+        }
+
+        const float ThresholdInDb = FCString::Atof(*Fields[ThresholdColumn]);
+        if (!FMath::IsFinite(ThresholdInDb))
+        {
+            continue;
+        }
+
+        const bool bLeftEye = Fields[EyeColumn] == GetEyeName(true);
+        const FIntVector Key = MakeKey(bLeftEye, FCString::Atof(*Fields[HorizontalColumn]), FCString::Atof(*Fields[VerticalColumn]));
+        IndicesByKey.Add(Key, MeansInDb.Add(ThresholdInDb));
+        StandardDeviationsInDb.Add(DeviationColumn != INDEX_NONE ? FMath::Max(FCString::Atof(*Fields[DeviationColumn]), 0.0f) : 0.0f);
+    }
+    return IsValid();
+}
+
+void FPreviousVisitPriors::Reset()
+{
+    LoadedPath.Reset();
+    IndicesByKey.Reset();
+    MeansInDb.Reset();
+    StandardDeviationsInDb.Reset();
+}
+
+bool FPreviousVisitPriors::Find(bool bLeftEye, float HorizontalDegrees, float VerticalDegrees, float& OutMeanInDb, float& OutStandardDeviationInDb) const
+{
+    const int32* Index = IndicesByKey.Find(MakeKey(bLeftEye, HorizontalDegrees, VerticalDegrees));
+    if (!Index)
+    {
+        return false;
+    }
+
+    OutMeanInDb = MeansInDb[*Index];
+    OutStandardDeviationInDb = StandardDeviationsInDb[*Index];
+    return true;
+}
+
+FIntVector FPreviousVisitPriors::MakeKey(bool bLeftEye, float HorizontalDegrees, float VerticalDegrees)
+{
+    return FIntVector(bLeftEye ? 1 : 0, FMath::RoundToInt(HorizontalDegrees), FMath::RoundToInt(VerticalDegrees));
+}
@@ -0,0 +1,137 @@
+// FPsychometricTable.cpp
+
+#include "FPsychometricTable.h"
+#include "Misc/ScopeLock.h"
+#include <cmath>
+
+bool FPsychometricParams::operator==(const FPsychometricParams& Other) const
+{
+    return Slope == Other.Slope
+        && GuessRate == Other.GuessRate
+        && LapseRate == Other.LapseRate
+        && MinThresholdInDb == Other.MinThresholdInDb
+        && MaxThresholdInDb == Other.MaxThresholdInDb
+        && ThresholdStepSizeInDb == Other.ThresholdStepSizeInDb
+        && IntensityStepInDb == Other.IntensityStepInDb
+        && CandidateStepInDb == Other.CandidateStepInDb;
+}
+
+uint32 GetTypeHash(const FPsychometricParams& Params)
+{
+    uint32 Hash = GetTypeHash(Params.Slope);
+    Hash = HashCombine(Hash, GetTypeHash(Params.GuessRate));
+    Hash = HashCombine(Hash, GetTypeHash(Params.LapseRate));
+    Hash = HashCombine(Hash, GetTypeHash(Params.MinThresholdInDb));
+    Hash = HashCombine(Hash, GetTypeHash(Params.MaxThresholdInDb));
+    Hash = HashCombine(Hash, GetTypeHash(Params.ThresholdStepSizeInDb));
+    Hash = HashCombine(Hash, GetTypeHash(Params.IntensityStepInDb));
+    return HashCombine(Hash, GetTypeHash(Params.CandidateStepInDb));
+}
+
+TSharedRef<const FPsychometricTable> FPsychometricTable::GetOrCreate(const FPsychometricParams& Params)
+{
+    // Tables stay alive only while an estimator holds them; a later request for the same parameters rebuilds
+    static FCriticalSection CacheLock;
+    static TMap<FPsychometricParams, TWeakPtr<const FPsychometricTable>> Cache;
+
+    FScopeLock ScopeLock(&CacheLock);
+    if (TWeakPtr<const FPsychometricTable>* Cached = Cache.Find(Params))
+    {
+        if (TSharedPtr<const FPsychometricTable> Table = Cached->Pin())
+        {
+            return Table.ToSharedRef();
+        }
+    }
+
+    // Drop entries whose tables were released, so parameter sweeps do not grow the cache without bound
+    for (auto It = Cache.CreateIterator(); It; ++It)
+    {
+        if (!It.Value().IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    TSharedRef<FPsychometricTable> Table = MakeShared<FPsychometricTable>(Params);
+    Cache.Add(Params, Table);
+    return Table;
+}
+
+FPsychometricTable::FPsychometricTable(const FPsychometricParams& InParams)
+    : Params(InParams)
+    , NumIntensities(0)
+    , RowStride(0)
+{
+    Params.ThresholdStepSizeInDb = FMath::Max(Params.ThresholdStepSizeInDb, KINDA_SMALL_NUMBER);
+    Params.IntensityStepInDb = FMath::Max(Params.IntensityStepInDb, KINDA_SMALL_NUMBER);
+
+    // Same grid the estimator has always used: Min to Max inclusive in ThresholdStepSizeInDb steps
+    for (float Level = Params.MinThresholdInDb; Level <= Params.MaxThresholdInDb; Level += Params.ThresholdStepSizeInDb)
+    {
+        ThresholdLevelsInDb.Add(Level);
+    }
+
+    // Presented intensities are clamped to the threshold range, so the rows cover the same span
+    NumIntensities = FMath::FloorToInt((Params.MaxThresholdInDb - Params.MinThresholdInDb) / Params.IntensityStepInDb) + 1;
+
+    // Padding entries stay zero, so they never contribute to a posterior
+    const int32 NumThresholds = ThresholdLevelsInDb.Num();
+    RowStride = Align(NumThresholds, 4);
+    Likelihoods.SetNumZeroed(NumIntensities * 2 * RowStride);
+    LogLikelihoods.SetNumZeroed(NumIntensities * 2 * RowStride);
+    for (int32 IntensityIndex = 0; IntensityIndex < NumIntensities; ++IntensityIndex)
+    {
+        const float Intensity = Params.MinThresholdInDb + IntensityIndex * Params.IntensityStepInDb;
+        float* NotSeenRow = &Likelihoods[IntensityIndex * 2 * RowStride];
+        float* SeenRow = NotSeenRow + RowStride;
+        float* LogNotSeenRow = &LogLikelihoods[IntensityIndex * 2 * RowStride];
+        float* LogSeenRow = LogNotSeenRow + RowStride;
+        for (int32 ThresholdIndex = 0; ThresholdIndex < NumThresholds; ++ThresholdIndex)
+        {
+            const float ProbabilityOfSeeing = Evaluate(Params, Intensity, ThresholdLevelsInDb[ThresholdIndex]);
+            SeenRow[ThresholdIndex] = ProbabilityOfSeeing;
+            NotSeenRow[ThresholdIndex] = 1.0f - ProbabilityOfSeeing;
+
+            // Guess and lapse rates keep both likelihoods away from zero, so the logs are finite
+            LogSeenRow[ThresholdIndex] = FMath::Loge(FMath::Max(SeenRow[ThresholdIndex], SMALL_NUMBER));
+            LogNotSeenRow[ThresholdIndex] = FMath::Loge(FMath::Max(NotSeenRow[ThresholdIndex], SMALL_NUMBER));
+        }
+    }
+
+    // Candidates for information-gain selection: every CandidateStepInDb, always including both ends of the range
+    const int32 CandidateStride = FMath::Max(FMath::RoundToInt(Params.CandidateStepInDb / Params.IntensityStepInDb), 1);
+    for (int32 IntensityIndex = 0; IntensityIndex < NumIntensities; IntensityIndex += CandidateStride)
+    {
+        CandidateIntensityIndices.Add(IntensityIndex);
+    }
+    if (CandidateIntensityIndices.Last() != NumIntensities - 1)
+    {
+        CandidateIntensityIndices.Add(NumIntensities - 1);
+    }
+}
+
+float FPsychometricTable::Evaluate(const FPsychometricParams& Params, float StimulusIntensity, float ThresholdLevel)
+{
+    return Params.GuessRate + (1.0f - Params.GuessRate - Params.LapseRate) * 0.5f * (1.0f + std::erf((StimulusIntensity - ThresholdLevel) / (Params.Slope * FMath::Sqrt(2.0f))));
+}
+
+int32 FPsychometricTable::GetIntensityIndex(float StimulusIntensity) const
+{
+    const int32 Index = FMath::RoundToInt((StimulusIntensity - Params.MinThresholdInDb) / Params.IntensityStepInDb);
+    return FMath::Clamp(Index, 0, NumIntensities - 1);
+}
+
+const float* FPsychometricTable::GetLikelihoodRow(float StimulusIntensity, bool bSeen) const
+{
+    return &Likelihoods[(GetIntensityIndex(StimulusIntensity) * 2 + (bSeen ? 1 : 0)) * RowStride];
+}
+
+const float* FPsychometricTable::GetLikelihoodRowByIndex(int32 IntensityIndex, bool bSeen) const
+{
+    return &Likelihoods[(IntensityIndex * 2 + (bSeen ? 1 : 0)) * RowStride];
+}
+
+const float* FPsychometricTable::GetLogLikelihoodRowByIndex(int32 IntensityIndex, bool bSeen) const
+{
+    return &LogLikelihoods[(IntensityIndex * 2 + (bSeen ? 1 : 0)) * RowStride];
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+// FSimulatedObserver.cpp
+
+#include "FSimulatedObserver.h"
+
+FSimulatedObserver::FSimulatedObserver(const TArray<float>& InTrueThresholdsInDb, const FSimulatedObserverParams& InParams, int32 Seed)
+    : TrueThresholdsInDb(InTrueThresholdsInDb)
+    , Params(InParams)
+    , RandomStream(Seed)
+{
+}
+
+bool FSimulatedObserver::LosesFixation()
+{
+    return RandomStream.FRand() < Params.FixationLossRate;
+}
+
+bool FSimulatedObserver::Respond(int32 LocationIndex, float StimulusIntensityInDb)
+{
+    if (RandomStream.FRand() < Params.FalseNegativeRate)
+    {
+        return false;
+    }
+
+    if (RandomStream.FRand() < Params.FalsePositiveRate)
+    {
+        return true;
+    }
+
+    const float ProbabilityOfSeeing = FPsychometricTable::Evaluate(Params.Psychometric, StimulusIntensityInDb, TrueThresholdsInDb[LocationIndex]);
+    return RandomStream.FRand() < ProbabilityOfSeeing;
+}
+
+bool FSimulatedObserver::RespondToCatchTrial()
+{
+    return RandomStream.FRand() < Params.FalsePositiveRate;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+// FSpeculativeTrialPlanner.cpp
+
+#include "FSpeculativeTrialPlanner.h"
+#include "UThresholdEstimator.h"
+#include "UObject/Package.h"
+
+FSpeculativeTrialPlanner::FSpeculativeTrialPlanner()
+    : StimulusIndex(INDEX_NONE)
+    , LocationId(INDEX_NONE)
+    , IntensityInDb(0.0f)
+    , StartVersion(0)
+    , bPending(false)
+{
+}
+
+FSpeculativeTrialPlanner::~FSpeculativeTrialPlanner()
+{
+    Cancel();
+}
+
+void FSpeculativeTrialPlanner::Begin(const UThresholdEstimator& Estimator, const FTrialScheduler& Scheduler, const TArray<int32>& InLocationIds, int32 InStimulusIndex, float InIntensityInDb)
+{
+    check(IsInGameThread());
+    Cancel();
+
+    if (!InLocationIds.IsValidIndex(InStimulusIndex))
+    {
+        return;
+    }
+
+    // Branch estimators are UObjects, so they are created here; the tasks only call their plain methods
+    for (FBranch& Branch : Branches)
+    {
+        if (!Branch.Estimator.IsValid())
+        {
+            Branch.Estimator.Reset(NewObject<UThresholdEstimator>(GetTransientPackage()));
+        }
+    }
+
+    LocationIds = InLocationIds;
+    StimulusIndex = InStimulusIndex;
+    LocationId = InLocationIds[InStimulusIndex];
+    IntensityInDb = InIntensityInDb;
+    StartVersion = Estimator.GetStateVersion();
+    bPending = true;
+
+    for (int32 Outcome = 0; Outcome < 2; ++Outcome)
+    {
+        FBranch& Branch = Branches[Outcome];
+        const bool bSeen = Outcome == 1;
+        Branch.Scheduler = Scheduler;
+        Branch.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, &Branch, &Estimator, bSeen]()
+        {
+            RunBranch(Branch, Estimator, LocationIds, StimulusIndex, LocationId, IntensityInDb, bSeen);
+        });
+    }
+}
+
+bool FSpeculativeTrialPlanner::Commit(bool bSeen, UThresholdEstimator& Estimator, FTrialScheduler& Scheduler, FPlannedTrial& OutNextTrial)
+{
+    check(IsInGameThread());
+    if (!bPending)
+    {
+        return false;
+    }
+
+    // Both branches read the live estimator, so both must be done before it changes
+    WaitForBranches();
+    bPending = false;
+
+    if (Estimator.GetStateVersion() != StartVersion)
+    {
+        return false;
+    }
+
+    FBranch& Branch = Branches[bSeen ? 1 : 0];
+    Estimator.CommitBranch(*Branch.Estimator, LocationId, IntensityInDb, bSeen, Branch.bApplied, Branch.bCompleted);
+    Swap(Scheduler, Branch.Scheduler);
+    OutNextTrial = Branch.NextTrial;
+    return true;
+}
+
+void FSpeculativeTrialPlanner::Cancel()
+{
+    WaitForBranches();
+    bPending = false;
+}
+
+void FSpeculativeTrialPlanner::RunBranch(FBranch& Branch, const UThresholdEstimator& Estimator, const TArray<int32>& LocationIds, int32 StimulusIndex, int32 LocationId, float IntensityInDb, bool bSeen)
+{
+    // The same steps as the response handler and the following RunTest, on copies
+    UThresholdEstimator& BranchEstimator = *Branch.Estimator;
+    BranchEstimator.CopyStateFrom(Estimator);
+    Branch.bApplied = BranchEstimator.ApplyResponseById(LocationId, IntensityInDb, bSeen, Branch.bCompleted);
+    Branch.Scheduler.ReportResult(StimulusIndex, BranchEstimator.GetThresholdUncertaintyInDbById(LocationId), BranchEstimator.IsThresholdEstimationCompleteById(LocationId));
+
+    Branch.NextTrial = FPlannedTrial();
+    if (!Branch.Scheduler.IsFinished())
+    {
+        // RunTest draws the catch-trial decision before choosing the location, so the branch does too; drawing
+        // them in the other order would give the random stream a different sequence than an unplanned session
+        Branch.NextTrial.bPrecededByCatchTrial = Branch.Scheduler.ShouldRunCatchTrial();
+        const int32 NextIndex = Branch.Scheduler.PopNext();
+        if (LocationIds.IsValidIndex(NextIndex))
+        {
+            Branch.NextTrial.StimulusIndex = NextIndex;
+            Branch.NextTrial.IntensityInDb = BranchEstimator.GetNextStimulusIntensityInDbById(LocationIds[NextIndex]);
+        }
+    }
+}
+
+void FSpeculativeTrialPlanner::WaitForBranches()
+{
+    for (FBranch& Branch : Branches)
+    {
+        if (Branch.Task.IsValid())
+        {
+            Branch.Task.Wait();
+            Branch.Task = UE::Tasks::FTask();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+// FStimulusPresentationScheduler.cpp
+
+#include "FStimulusPresentationScheduler.h"
+
+void FStimulusPresentationScheduler::Configure(float InRefreshRateHz, float InToleranceFrames)
+{
+    RefreshRateHz = FMath::Max(InRefreshRateHz, 1.0f);
+    ToleranceFrames = FMath::Max(InToleranceFrames, 0.0f);
+}
+
+void FStimulusPresentationScheduler::Schedule(int32 StimulusIndex, float IntensityInDb, float DurationSeconds)
+{
+    Presentation = FStimulusPresentation();
+    Presentation.StimulusIndex = StimulusIndex;
+    Presentation.IntensityInDb = IntensityInDb;
+
+    // A stimulus is always drawn for at least one frame
+    Presentation.RequestedFrames = FMath::Max(FMath::RoundToInt(DurationSeconds * RefreshRateHz), 1);
+    Presentation.RequestedDurationSeconds = Presentation.RequestedFrames * GetFramePeriodSeconds();
+    State = EState::Queued;
+}
+
+void FStimulusPresentationScheduler::Cancel()
+{
+    State = EState::Idle;
+}
+
+FStimulusPresentationScheduler::EAction FStimulusPresentationScheduler::AdvanceFrame(uint64 FrameNumber, double FrameSeconds)
+{
+    EAction Action = EAction::None;
+    switch (State)
+    {
+    case EState::Queued:
+        Presentation.FirstFrame = FrameNumber;
+        Presentation.FirstFrameSeconds = FrameSeconds;
+        State = EState::Showing;
+        Action = EAction::Show;
+        break;
+
+    case EState::Showing:
+    {
+        // Come down on the frame nearest the end of the last requested frame; half a frame early is the
+        // closest a frame boundary can get, so the rounding error stays within half a frame either way
+        const double FramePeriod = GetFramePeriodSeconds();
+        const double Elapsed = FrameSeconds - Presentation.FirstFrameSeconds;
+        if (Elapsed >= Presentation.RequestedDurationSeconds - 0.5 * FramePeriod)
+        {
+            Presentation.LastFrame = PreviousFrame;
+            Presentation.LastFrameSeconds = PreviousFrameSeconds;
+            Presentation.MeasuredDurationSeconds = Elapsed;
+            Presentation.bWithinTolerance = FMath::Abs(Elapsed - Presentation.RequestedDurationSeconds) <= ToleranceFrames * FramePeriod;
+            State = EState::Idle;
+            Action = EAction::Hide;
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    PreviousFrame = FrameNumber;
+    PreviousFrameSeconds = FrameSeconds;
+    return Action;
+}
@@ -0,0 +1,210 @@
+// FStructuredLog.cpp
+
+#include "FStructuredLog.h"
+#include "Misc/DateTime.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+    // Format strings indexed by EStructuredLogFormat; the decoder reads them from the file header
+    const TCHAR* const StructuredLogFormats[] =
+    {
+        TEXT("Updating probability distribution for location %s with intensity %f dB, Seen: %s"),
+        TEXT("Probability distribution after response at %s (from %f dB, step %f dB): %s"),
+        TEXT("Threshold estimation complete for location %s. Estimated threshold: %f dB"),
+        TEXT("Recorded result at location %s: Seen %s at %f dB"),
+        TEXT("Sensitivity at location %s: %f"),
+        TEXT("RunTest called with CurrentStimulusIndex: %d"),
+        TEXT("ThresholdEstimator returned intensity %f dB for location %s"),
+        TEXT("Response for stimulus at location %s, detected: %s"),
+        TEXT("Stimulus %d shown at %f dB"),
+        TEXT("Stimulus %d hidden after duration"),
+        TEXT("Next trial prepared during presentation: stimulus %d at %f dB"),
+        TEXT("Stimulus %d on screen for %f s (requested %f s), within tolerance: %s"),
+        TEXT("Trial for stimulus %d invalidated, saccade: %s, blink: %s, peak velocity %f deg/s"),
+    };
+    static_assert(UE_ARRAY_COUNT(StructuredLogFormats) == static_cast<int32>(EStructuredLogFormat::Count), "Every EStructuredLogFormat needs a format string");
+
+    // Offset of the argument count within a record: size (2) + format (2) + timestamp (8)
+    constexpr int32 ArgCountOffset = 12;
+}
+
+FStructuredLogRecord::FStructuredLogRecord(EStructuredLogFormat Format, double TimestampSeconds)
+    : ArgCount(0)
+{
+    Bytes.Reserve(64);
+
+    const uint16 SizePlaceholder = 0;
+    const uint16 FormatId = static_cast<uint16>(Format);
+    WriteBytes(&SizePlaceholder, sizeof(SizePlaceholder));
+    WriteBytes(&FormatId, sizeof(FormatId));
+    WriteBytes(&TimestampSeconds, sizeof(TimestampSeconds));
+    WriteBytes(&ArgCount, sizeof(ArgCount));
+}
+
+FStructuredLogRecord& FStructuredLogRecord::operator<<(int32 Value)
+{
+    WriteTag(EStructuredLogArg::Int32);
+    WriteBytes(&Value, sizeof(Value));
+    return *this;
+}
+
+FStructuredLogRecord& FStructuredLogRecord::operator<<(float Value)
+{
+    WriteTag(EStructuredLogArg::Float);
+    WriteBytes(&Value, sizeof(Value));
+    return *this;
+}
+
+FStructuredLogRecord& FStructuredLogRecord::operator<<(double Value)
+{
+    WriteTag(EStructuredLogArg::Double);
+    WriteBytes(&Value, sizeof(Value));
+    return *this;
+}
+
+FStructuredLogRecord& FStructuredLogRecord::operator<<(bool Value)
+{
+    WriteTag(EStructuredLogArg::Bool);
+    const uint8 Byte = Value ? 1 : 0;
+    WriteBytes(&Byte, sizeof(Byte));
+    return *this;
+}
+
+FStructuredLogRecord& FStructuredLogRecord::operator<<(const FVector& Value)
+{
+    // Stored as floats; locations are in centimetres so single precision is plenty
+    WriteTag(EStructuredLogArg::Vector);
+    const float Components[3] = { static_cast<float>(Value.X), static_cast<float>(Value.Y), static_cast<float>(Value.Z) };
+    WriteBytes(Components, sizeof(Components));
+    return *this;
+}
+
+FStructuredLogRecord& FStructuredLogRecord::operator<<(TArrayView<const float> Values)
+{
+    WriteTag(EStructuredLogArg::FloatArray);
+    const uint16 Count = static_cast<uint16>(FMath::Min(Values.Num(), static_cast<int32>(MAX_uint16)));
+    WriteBytes(&Count, sizeof(Count));
+    WriteBytes(Values.GetData(), Count * sizeof(float));
+    return *this;
+}
+
+TArray<uint8> FStructuredLogRecord::Finish()
+{
+    // The size field is 16 bits; a larger record would be framed with a wrapped size and corrupt the rest of the file
+    const int32 PayloadBytes = Bytes.Num() - sizeof(uint16);
+    if (!ensureMsgf(PayloadBytes <= MAX_uint16, TEXT("Structured log record of %d bytes exceeds the 64 KiB record limit and was dropped."), PayloadBytes))
+    {
+        return TArray<uint8>();
+    }
+
+    // Patch the payload size (excluding the size field itself) and the argument count
+    const uint16 PayloadSize = static_cast<uint16>(PayloadBytes);
+    FMemory::Memcpy(Bytes.GetData(), &PayloadSize, sizeof(PayloadSize));
+    Bytes[ArgCountOffset] = ArgCount;
+    return MoveTemp(Bytes);
+}
+
+void FStructuredLogRecord::WriteTag(EStructuredLogArg Tag)
+{
+    const uint8 TagByte = static_cast<uint8>(Tag);
+    WriteBytes(&TagByte, sizeof(TagByte));
+    ArgCount++;
+}
+
+void FStructuredLogRecord::WriteBytes(const void* Data, int32 Size)
+{
+    Bytes.Append(static_cast<const uint8*>(Data), Size);
+}
+
+FStructuredLog::FStructuredLog()
+    : SessionStartTime(FPlatformTime::Seconds())
+    , bEnabled(true)
+{
+}
+
+FStructuredLog::~FStructuredLog()
+{
+    Close();
+}
+
+void FStructuredLog::Open(const FString& Directory, const FLogFileSinkSettings& Settings)
+{
+    FLogFileSinkSettings BinarySettings = Settings;
+    BinarySettings.bBinary = true;
+
+    TUniquePtr<FLogFileSink> NewSink = MakeUnique<FLogFileSink>(Directory, TEXT("StructuredLog"), TEXT("plog"), BinarySettings, BuildHeader());
+    TUniquePtr<FLogFileSink> OldSink;
+    {
+        FRWScopeLock Lock(SinkLock, SLT_Write);
+        OldSink = MoveTemp(Sink);
+        Sink = MoveTemp(NewSink);
+        SessionStartTime = FPlatformTime::Seconds();
+    }
+}
+
+void FStructuredLog::Close()
+{
+    // Detach the sink under the lock so no Log call can still be using it, then drain it without blocking loggers
+    TUniquePtr<FLogFileSink> ClosedSink;
+    {
+        FRWScopeLock Lock(SinkLock, SLT_Write);
+        ClosedSink = MoveTemp(Sink);
+    }
+    ClosedSink.Reset();
+}
+
+bool FStructuredLog::IsEnabled() const
+{
+    if (!bEnabled.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    FRWScopeLock Lock(SinkLock, SLT_ReadOnly);
+    return Sink.IsValid();
+}
+
+// Singleton instance of the structured log
+FStructuredLog& FStructuredLog::Get()
+{
+    static FStructuredLog Instance;
+    return Instance;
+}
+
+const TCHAR* FStructuredLog::GetFormatString(EStructuredLogFormat Format)
+{
+    const int32 Index = static_cast<int32>(Format);
+    return Index >= 0 && Index < UE_ARRAY_COUNT(StructuredLogFormats) ? StructuredLogFormats[Index] : TEXT("");
+}
+
+TArray<uint8> FStructuredLog::BuildHeader()
+{
+    // Header: magic, version, session start (ISO 8601, UTF-8), format count, then (id, UTF-8 format) pairs
+    TArray<uint8> Header;
+    auto WriteBytes = [&Header](const void* Data, int32 Size)
+    {
+        Header.Append(static_cast<const uint8*>(Data), Size);
+    };
+    auto WriteString = [&WriteBytes](const TCHAR* String)
+    {
+        FTCHARToUTF8 Utf8(String);
+        const uint16 Length = static_cast<uint16>(Utf8.Length());
+        WriteBytes(&Length, sizeof(Length));
+        WriteBytes(Utf8.Get(), Length);
+    };
+
+    WriteBytes(&FileMagic, sizeof(FileMagic));
+    WriteBytes(&FileVersion, sizeof(FileVersion));
+    WriteString(*FDateTime::Now().ToIso8601());
+
+    const uint16 FormatCount = static_cast<uint16>(EStructuredLogFormat::Count);
+    WriteBytes(&FormatCount, sizeof(FormatCount));
+    for (uint16 FormatId = 0; FormatId < FormatCount; ++FormatId)
+    {
+        WriteBytes(&FormatId, sizeof(FormatId));
+        WriteString(StructuredLogFormats[FormatId]);
+    }
+
+    return Header;
+}
@@ -0,0 +1,151 @@
+// FTestPatternLibrary.cpp
+
+#include "FTestPatternLibrary.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    // Rows run from superior to inferior and each row from nasal to temporal (right eye), as on a printout.
+    // 10-2: 2 degree grid offset 1 degree from the meridians, within 10 degrees of fixation
+    constexpr FTestPatternPoint Pattern10_2[] =
+    {
+        { -1.0f, 9.0f, false }, { 1.0f, 9.0f, false },
+        { -5.0f, 7.0f, false }, { -3.0f, 7.0f, false }, { -1.0f, 7.0f, false }, { 1.0f, 7.0f, false }, { 3.0f, 7.0f, false }, { 5.0f, 7.0f, false },
+        { -7.0f, 5.0f, false }, { -5.0f, 5.0f, false }, { -3.0f, 5.0f, false }, { -1.0f, 5.0f, false }, { 1.0f, 5.0f, false }, { 3.0f, 5.0f, false }, { 5.0f, 5.0f, false }, { 7.0f, 5.0f, false },
+        { -7.0f, 3.0f, false }, { -5.0f, 3.0f, false }, { -3.0f, 3.0f, false }, { -1.0f, 3.0f, false }, { 1.0f, 3.0f, false }, { 3.0f, 3.0f, false }, { 5.0f, 3.0f, false }, { 7.0f, 3.0f, false },
+        { -9.0f, 1.0f, false }, { -7.0f, 1.0f, false }, { -5.0f, 1.0f, false }, { -3.0f, 1.0f, false }, { -1.0f, 1.0f, false }, { 1.0f, 1.0f, false }, { 3.0f, 1.0f, false }, { 5.0f, 1.0f, false }, { 7.0f, 1.0f, false }, { 9.0f, 1.0f, false },
+        { -9.0f, -1.0f, false }, { -7.0f, -1.0f, false }, { -5.0f, -1.0f, false }, { -3.0f, -1.0f, false }, { -1.0f, -1.0f, false }, { 1.0f, -1.0f, false }, { 3.0f, -1.0f, false }, { 5.0f, -1.0f, false }, { 7.0f, -1.0f, false }, { 9.0f, -1.0f, false },
+        { -7.0f, -3.0f, false }, { -5.0f, -3.0f, false }, { -3.0f, -3.0f, false }, { -1.0f, -3.0f, false }, { 1.0f, -3.0f, false }, { 3.0f, -3.0f, false }, { 5.0f, -3.0f, false }, { 7.0f, -3.0f, false },
+        { -7.0f, -5.0f, false }, { -5.0f, -5.0f, false }, { -3.0f, -5.0f, false }, { -1.0f, -5.0f, false }, { 1.0f, -5.0f, false }, { 3.0f, -5.0f, false }, { 5.0f, -5.0f, false }, { 7.0f, -5.0f, false },
+        { -5.0f, -7.0f, false }, { -3.0f, -7.0f, false }, { -1.0f, -7.0f, false }, { 1.0f, -7.0f, false }, { 3.0f, -7.0f, false }, { 5.0f, -7.0f, false },
+        { -1.0f, -9.0f, false }, { 1.0f, -9.0f, false },
+    };
+
+    // 24-2: 6 degree grid offset 3 degrees from the meridians, with the nasal step out to 27 degrees
+    constexpr FTestPatternPoint Pattern24_2[] =
+    {
+        { -9.0f, 21.0f, false }, { -3.0f, 21.0f, false }, { 3.0f, 21.0f, false }, { 9.0f, 21.0f, false },
+        { -15.0f, 15.0f, false }, { -9.0f, 15.0f, false }, { -3.0f, 15.0f, false }, { 3.0f, 15.0f, false }, { 9.0f, 15.0f, false }, { 15.0f, 15.0f, false },
+        { -21.0f, 9.0f, false }, { -15.0f, 9.0f, false }, { -9.0f, 9.0f, false }, { -3.0f, 9.0f, false }, { 3.0f, 9.0f, false }, { 9.0f, 9.0f, false }, { 15.0f, 9.0f, false }, { 21.0f, 9.0f, false },
+        { -27.0f, 3.0f, false }, { -21.0f, 3.0f, false }, { -15.0f, 3.0f, false }, { -9.0f, 3.0f, false }, { -3.0f, 3.0f, false }, { 3.0f, 3.0f, false }, { 9.0f, 3.0f, false }, { 15.0f, 3.0f, true }, { 21.0f, 3.0f, false },
+        { -27.0f, -3.0f, false }, { -21.0f, -3.0f, false }, { -15.0f, -3.0f, false }, { -9.0f, -3.0f, false }, { -3.0f, -3.0f, false }, { 3.0f, -3.0f, false }, { 9.0f, -3.0f, false }, { 15.0f, -3.0f, true }, { 21.0f, -3.0f, false },
+        { -21.0f, -9.0f, false }, { -15.0f, -9.0f, false }, { -9.0f, -9.0f, false }, { -3.0f, -9.0f, false }, { 3.0f, -9.0f, false }, { 9.0f, -9.0f, false }, { 15.0f, -9.0f, false }, { 21.0f, -9.0f, false },
+        { -15.0f, -15.0f, false }, { -9.0f, -15.0f, false }, { -3.0f, -15.0f, false }, { 3.0f, -15.0f, false }, { 9.0f, -15.0f, false }, { 15.0f, -15.0f, false },
+        { -9.0f, -21.0f, false }, { -3.0f, -21.0f, false }, { 3.0f, -21.0f, false }, { 9.0f, -21.0f, false },
+    };
+
+    // 30-2: 6 degree grid offset 3 degrees from the meridians, out to 30 degrees
+    constexpr FTestPatternPoint Pattern30_2[] =
+    {
+        { -9.0f, 27.0f, false }, { -3.0f, 27.0f, false }, { 3.0f, 27.0f, false }, { 9.0f, 27.0f, false },
+        { -15.0f, 21.0f, false }, { -9.0f, 21.0f, false }, { -3.0f, 21.0f, false }, { 3.0f, 21.0f, false }, { 9.0f, 21.0f, false }, { 15.0f, 21.0f, false },
+        { -21.0f, 15.0f, false }, { -15.0f, 15.0f, false }, { -9.0f, 15.0f, false }, { -3.0f, 15.0f, false }, { 3.0f, 15.0f, false }, { 9.0f, 15.0f, false }, { 15.0f, 15.0f, false }, { 21.0f, 15.0f, false },
+        { -27.0f, 9.0f, false }, { -21.0f, 9.0f, false }, { -15.0f, 9.0f, false }, { -9.0f, 9.0f, false }, { -3.0f, 9.0f, false }, { 3.0f, 9.0f, false }, { 9.0f, 9.0f, false }, { 15.0f, 9.0f, false }, { 21.0f, 9.0f, false }, { 27.0f, 9.0f, false },
+        { -27.0f, 3.0f, false }, { -21.0f, 3.0f, false }, { -15.0f, 3.0f, false }, { -9.0f, 3.0f, false }, { -3.0f, 3.0f, false }, { 3.0f, 3.0f, false }, { 9.0f, 3.0f, false }, { 15.0f, 3.0f, true }, { 21.0f, 3.0f, false }, { 27.0f, 3.0f, false },
+        { -27.0f, -3.0f, false }, { -21.0f, -3.0f, false }, { -15.0f, -3.0f, false }, { -9.0f, -3.0f, false }, { -3.0f, -3.0f, false }, { 3.0f, -3.0f, false }, { 9.0f, -3.0f, false }, { 15.0f, -3.0f, true }, { 21.0f, -3.0f, false }, { 27.0f, -3.0f, false },
+        { -27.0f, -9.0f, false }, { -21.0f, -9.0f, false }, { -15.0f, -9.0f, false }, { -9.0f, -9.0f, false }, { -3.0f, -9.0f, false }, { 3.0f, -9.0f, false }, { 9.0f, -9.0f, false }, { 15.0f, -9.0f, false }, { 21.0f, -9.0f, false }, { 27.0f, -9.0f, false },
+        { -21.0f, -15.0f, false }, { -15.0f, -15.0f, false }, { -9.0f, -15.0f, false }, { -3.0f, -15.0f, false }, { 3.0f, -15.0f, false }, { 9.0f, -15.0f, false }, { 15.0f, -15.0f, false }, { 21.0f, -15.0f, false },
+        { -15.0f, -21.0f, false }, { -9.0f, -21.0f, false }, { -3.0f, -21.0f, false }, { 3.0f, -21.0f, false }, { 9.0f, -21.0f, false }, { 15.0f, -21.0f, false },
+        { -9.0f, -27.0f, false }, { -3.0f, -27.0f, false }, { 3.0f, -27.0f, false }, { 9.0f, -27.0f, false },
+    };
+
+    // 60-4: 12 degree grid offset 6 degrees from the meridians, between 30 and 60 degrees
+    constexpr FTestPatternPoint Pattern60_4[] =
+    {
+        { -18.0f, 54.0f, false }, { -6.0f, 54.0f, false }, { 6.0f, 54.0f, false }, { 18.0f, 54.0f, false },
+        { -30.0f, 42.0f, false }, { -18.0f, 42.0f, false }, { -6.0f, 42.0f, false }, { 6.0f, 42.0f, false }, { 18.0f, 42.0f, false }, { 30.0f, 42.0f, false },
+        { -42.0f, 30.0f, false }, { -30.0f, 30.0f, false }, { -18.0f, 30.0f, false }, { -6.0f, 30.0f, false }, { 6.0f, 30.0f, false }, { 18.0f, 30.0f, false }, { 30.0f, 30.0f, false }, { 42.0f, 30.0f, false },
+        { -54.0f, 18.0f, false }, { -42.0f, 18.0f, false }, { -30.0f, 18.0f, false }, { 30.0f, 18.0f, false }, { 42.0f, 18.0f, false }, { 54.0f, 18.0f, false },
+        { -54.0f, 6.0f, false }, { -42.0f, 6.0f, false }, { -30.0f, 6.0f, false }, { 30.0f, 6.0f, false }, { 42.0f, 6.0f, false }, { 54.0f, 6.0f, false },
+        { -54.0f, -6.0f, false }, { -42.0f, -6.0f, false }, { -30.0f, -6.0f, false }, { 30.0f, -6.0f, false }, { 42.0f, -6.0f, false }, { 54.0f, -6.0f, false },
+        { -54.0f, -18.0f, false }, { -42.0f, -18.0f, false }, { -30.0f, -18.0f, false }, { 30.0f, -18.0f, false }, { 42.0f, -18.0f, false }, { 54.0f, -18.0f, false },
+        { -42.0f, -30.0f, false }, { -30.0f, -30.0f, false }, { -18.0f, -30.0f, false }, { -6.0f, -30.0f, false }, { 6.0f, -30.0f, false }, { 18.0f, -30.0f, false }, { 30.0f, -30.0f, false }, { 42.0f, -30.0f, false },
+        { -30.0f, -42.0f, false }, { -18.0f, -42.0f, false }, { -6.0f, -42.0f, false }, { 6.0f, -42.0f, false }, { 18.0f, -42.0f, false }, { 30.0f, -42.0f, false },
+        { -18.0f, -54.0f, false }, { -6.0f, -54.0f, false }, { 6.0f, -54.0f, false }, { 18.0f, -54.0f, false },
+    };
+
+    static_assert(UE_ARRAY_COUNT(Pattern10_2) == 68, "The 10-2 grid has 68 points");
+    static_assert(UE_ARRAY_COUNT(Pattern24_2) == 54, "The 24-2 grid has 54 points");
+    static_assert(UE_ARRAY_COUNT(Pattern30_2) == 76, "The 30-2 grid has 76 points");
+    static_assert(UE_ARRAY_COUNT(Pattern60_4) == 60, "The 60-4 grid has 60 points");
+
+    struct FPatternTable
+    {
+        const TCHAR* Name;
+        const FTestPatternPoint* Points;
+        int32 Num;
+    };
+
+    // Indexed by ETestType
+    constexpr FPatternTable PatternTables[] =
+    {
+        { TEXT("10-2"), Pattern10_2, UE_ARRAY_COUNT(Pattern10_2) },
+        { TEXT("24-2"), Pattern24_2, UE_ARRAY_COUNT(Pattern24_2) },
+        { TEXT("30-2"), Pattern30_2, UE_ARRAY_COUNT(Pattern30_2) },
+        { TEXT("60-4"), Pattern60_4, UE_ARRAY_COUNT(Pattern60_4) },
+    };
+    static_assert(UE_ARRAY_COUNT(PatternTables) == static_cast<int32>(ETestType::TEST_60_4) + 1, "Every ETestType needs a pattern table");
+
+    // Cached positions, keyed by pattern, eye and radius in 0.01 cm; entries are never removed
+    FCriticalSection LocationCacheLock;
+    TMap<FIntVector, TUniquePtr<TArray<FVector>>> LocationCache;
+}
+
+TArrayView<const FTestPatternPoint> FTestPatternLibrary::GetPoints(ETestType TestType)
+{
+    const int32 Index = static_cast<int32>(TestType);
+    if (Index < 0 || Index >= UE_ARRAY_COUNT(PatternTables))
+    {
+        return TArrayView<const FTestPatternPoint>();
+    }
+    return TArrayView<const FTestPatternPoint>(PatternTables[Index].Points, PatternTables[Index].Num);
+}
+
+const TCHAR* FTestPatternLibrary::GetName(ETestType TestType)
+{
+    const int32 Index = static_cast<int32>(TestType);
+    return Index >= 0 && Index < UE_ARRAY_COUNT(PatternTables) ? PatternTables[Index].Name : TEXT("");
+}
+
+bool FTestPatternLibrary::FindByName(const FString& Name, ETestType& OutTestType)
+{
+    for (int32 Index = 0; Index < UE_ARRAY_COUNT(PatternTables); ++Index)
+    {
+        if (Name == PatternTables[Index].Name)
+        {
+            OutTestType = static_cast<ETestType>(Index);
+            return true;
+        }
+    }
+    return false;
+}
+
+const TArray<FVector>& FTestPatternLibrary::GetLocations(ETestType TestType, bool bLeftEye, float Radius)
+{
+    const FIntVector Key(static_cast<int32>(TestType), bLeftEye ? 1 : 0, FMath::RoundToInt(Radius * 100.0f));
+
+    FScopeLock Lock(&LocationCacheLock);
+    if (const TUniquePtr<TArray<FVector>>* Cached = LocationCache.Find(Key))
+    {
+        return **Cached;
+    }
+
+    // Mirror the table for the left eye so positive horizontal is always temporal in the table
+    const float HorizontalSign = bLeftEye ? -1.0f : 1.0f;
+    const TArrayView<const FTestPatternPoint> Points = GetPoints(TestType);
+
+    TUniquePtr<TArray<FVector>> Locations = MakeUnique<TArray<FVector>>();
+    Locations->Reserve(Points.Num());
+    for (const FTestPatternPoint& Point : Points)
+    {
+        // Same placement as ATestStimuli::PolarToCartesian, so FNormativePriorDatabase::ToFieldDegrees inverts it
+        const float VerticalRadians = FMath::DegreesToRadians(Point.VerticalDegrees);
+        const float HorizontalRadians = FMath::DegreesToRadians(HorizontalSign * Point.HorizontalDegrees);
+        Locations->Add(FVector(
+            Radius * FMath::Cos(VerticalRadians) * FMath::Sin(HorizontalRadians),
+            Radius * FMath::Sin(VerticalRadians),
+            Radius * FMath::Cos(VerticalRadians) * FMath::Cos(HorizontalRadians)));
+    }
+
+    return *LocationCache.Add(Key, MoveTemp(Locations));
+}
@@ -0,0 +1,170 @@
+// FTrialScheduler.cpp
+
+#include "FTrialScheduler.h"
+
+FTrialScheduler::FTrialScheduler()
+    : MinSeparationCosine(1.0f)
+    , InFlightIndex(INDEX_NONE)
+    , LastPresentedIndex(INDEX_NONE)
+    , NumActive(0)
+    , NumPresentations(0)
+    , bLastWasCatchTrial(false)
+{
+}
+
+void FTrialScheduler::Reset(const TArray<FVector>& InLocations, const FTrialSchedulerSettings& InSettings)
+{
+    Settings = InSettings;
+    MinSeparationCosine = FMath::Cos(FMath::DegreesToRadians(Settings.MinSeparationDegrees));
+    RandomStream.Initialize(Settings.RandomSeed != 0 ? Settings.RandomSeed : static_cast<int32>(FPlatformTime::Cycles()));
+
+    const int32 NumLocations = InLocations.Num();
+    Directions.Reset(NumLocations);
+    for (const FVector& Location : InLocations)
+    {
+        Directions.Add(Location.GetSafeNormal());
+    }
+    Versions.Init(0, NumLocations);
+    LastUncertaintiesInDb.Init(TNumericLimits<float>::Max(), NumLocations);
+    PresentationCounts.Init(0, NumLocations);
+    RejectionCounts.Init(0, NumLocations);
+    ActiveFlags.Init(true, NumLocations);
+
+    InFlightIndex = INDEX_NONE;
+    LastPresentedIndex = INDEX_NONE;
+    NumActive = NumLocations;
+    NumPresentations = 0;
+    bLastWasCatchTrial = false;
+
+    // Nothing is known yet, so every location starts at maximum uncertainty and the tie-break sets the first sweep
+    Heap.Reset(NumLocations);
+    for (int32 LocationIndex = 0; LocationIndex < NumLocations; ++LocationIndex)
+    {
+        Push(LocationIndex, LastUncertaintiesInDb[LocationIndex]);
+    }
+}
+
+int32 FTrialScheduler::PopNext()
+{
+    // A trial that was handed out but never reported (e.g. the test was paused) goes back in the queue
+    if (InFlightIndex != INDEX_NONE)
+    {
+        Push(InFlightIndex, LastUncertaintiesInDb[InFlightIndex]);
+        InFlightIndex = INDEX_NONE;
+    }
+
+    int32 Selected = INDEX_NONE;
+    Deferred.Reset();
+    while (Heap.Num() > 0)
+    {
+        FEntry Entry;
+        Heap.HeapPop(Entry, FEntryPredicate(), false);
+        if (IsStale(Entry))
+        {
+            continue;
+        }
+        if (IsTooCloseToLast(Entry.LocationIndex))
+        {
+            Deferred.Add(Entry);
+            continue;
+        }
+        Selected = Entry.LocationIndex;
+        break;
+    }
+
+    // If every remaining location is too close to the last one, take the most uncertain of them anyway
+    int32 FirstDeferred = 0;
+    if (Selected == INDEX_NONE && Deferred.Num() > 0)
+    {
+        Selected = Deferred[0].LocationIndex;
+        FirstDeferred = 1;
+    }
+    for (int32 i = FirstDeferred; i < Deferred.Num(); ++i)
+    {
+        Heap.HeapPush(Deferred[i], FEntryPredicate());
+    }
+
+    if (Selected != INDEX_NONE)
+    {
+        // The location stays out of the heap until its result is reported
+        ++Versions[Selected];
+        InFlightIndex = Selected;
+    }
+    return Selected;
+}
+
+void FTrialScheduler::ReportResult(int32 LocationIndex, float UncertaintyInDb, bool bComplete)
+{
+    if (!ActiveFlags.IsValidIndex(LocationIndex) || !ActiveFlags[LocationIndex])
+    {
+        return;
+    }
+
+    if (InFlightIndex == LocationIndex)
+    {
+        InFlightIndex = INDEX_NONE;
+    }
+    LastPresentedIndex = LocationIndex;
+    LastUncertaintiesInDb[LocationIndex] = UncertaintyInDb;
+    ++NumPresentations;
+    bLastWasCatchTrial = false;
+
+    if (bComplete || ++PresentationCounts[LocationIndex] >= Settings.MaxPresentationsPerLocation)
+    {
+        // Retired: invalidate any entry still in the heap
+        ActiveFlags[LocationIndex] = false;
+        ++Versions[LocationIndex];
+        --NumActive;
+        return;
+    }
+
+    Push(LocationIndex, UncertaintyInDb);
+}
+
+bool FTrialScheduler::RejectTrial(int32 LocationIndex)
+{
+    if (!ActiveFlags.IsValidIndex(LocationIndex) || !ActiveFlags[LocationIndex] || RejectionCounts[LocationIndex] >= Settings.MaxRejectionsPerLocation)
+    {
+        return false;
+    }
+
+    // Not a presentation: the location goes back at the uncertainty it had, without counting toward its cap
+    if (InFlightIndex == LocationIndex)
+    {
+        InFlightIndex = INDEX_NONE;
+    }
+    LastPresentedIndex = LocationIndex;
+    ++RejectionCounts[LocationIndex];
+    Push(LocationIndex, LastUncertaintiesInDb[LocationIndex]);
+    return true;
+}
+
+bool FTrialScheduler::ShouldRunCatchTrial()
+{
+    if (NumPresentations == 0 || bLastWasCatchTrial || IsFinished())
+    {
+        return false;
+    }
+
+    bLastWasCatchTrial = RandomStream.FRand() < Settings.CatchTrialProbability;
+    return bLastWasCatchTrial;
+}
+
+void FTrialScheduler::Push(int32 LocationIndex, float UncertaintyInDb)
+{
+    FEntry Entry;
+    Entry.UncertaintyInDb = UncertaintyInDb;
+    Entry.TieBreak = RandomStream.FRand();
+    Entry.LocationIndex = LocationIndex;
+    Entry.Version = ++Versions[LocationIndex];
+    Heap.HeapPush(Entry, FEntryPredicate());
+}
+
+bool FTrialScheduler::IsTooCloseToLast(int32 LocationIndex) const
+{
+    if (LastPresentedIndex == INDEX_NONE)
+    {
+        return false;
+    }
+    return FVector::DotProduct(Directions[LocationIndex], Directions[LastPresentedIndex]) > MinSeparationCosine;
+}
\ No newline at end of file
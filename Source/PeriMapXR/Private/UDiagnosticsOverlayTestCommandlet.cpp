@@ -0,0 +1,153 @@
+// UDiagnosticsOverlayTestCommandlet.cpp
+
+#include "UDiagnosticsOverlayTestCommandlet.h"
+#include "FLogManager.h"
+#include "UPeriMapXRLogSubsystem.h"
+#include "Containers/Ticker.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/Parse.h"
+#include <atomic>
+
+namespace
+{
+    // Forwards to the engine allocator and counts allocations made on one thread while enabled
+    class FAllocationCountingMalloc : public FMalloc
+    {
+    public:
+        FAllocationCountingMalloc(FMalloc* InInner)
+            : Inner(InInner)
+            , ThreadId(FPlatformTLS::GetCurrentThreadId())
+            , Count(0)
+        {
+        }
+
+        virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+        {
+            CountAllocation();
+            return Inner->Malloc(Size, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+        {
+            if (Size > 0)
+            {
+                CountAllocation();
+            }
+            return Inner->Realloc(Original, Size, Alignment);
+        }
+
+        virtual void Free(void* Original) override { Inner->Free(Original); }
+        virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+        virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+        virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+        virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+        virtual const TCHAR* GetDescriptiveName() override { return TEXT("AllocationCounting"); }
+
+        // Allocations counted since the last call
+        int64 TakeCount() { return Count.exchange(0, std::memory_order_relaxed); }
+
+    private:
+        void CountAllocation()
+        {
+            if (FPlatformTLS::GetCurrentThreadId() == ThreadId)
+            {
+                Count.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        FMalloc* Inner;
+        uint32 ThreadId;
+        std::atomic<int64> Count;
+    };
+}
+
+UDiagnosticsOverlayTestCommandlet::UDiagnosticsOverlayTestCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UDiagnosticsOverlayTestCommandlet::Main(const FString& Params)
+{
+    FLogManager LogManager(TEXT("Simulation"));
+
+    int32 NumFrames = 900;
+    int32 WarmupFrames = 90;
+    int32 MessagesPerFrame = 20;
+    int32 MaxAllocationsPerFrame = 0;
+    FParse::Value(*Params, TEXT("Frames="), NumFrames);
+    FParse::Value(*Params, TEXT("WarmupFrames="), WarmupFrames);
+    FParse::Value(*Params, TEXT("MessagesPerFrame="), MessagesPerFrame);
+    FParse::Value(*Params, TEXT("MaxAllocationsPerFrame="), MaxAllocationsPerFrame);
+
+    UPeriMapXRLogSubsystem* LogSubsystem = UPeriMapXRLogSubsystem::Get();
+    if (!LogSubsystem || !LogSubsystem->GetOverlay())
+    {
+        LogManager.LogMessage(TEXT("The PeriMapXR log service is not running."), ELogVerbosity::Error, 0.0f, true, false, true);
+        return 1;
+    }
+
+    // The messages ATestStimuli logs on its per-trial and per-frame paths, on screen only
+    FLogManager TestLog(TEXT("DiagnosticsOverlayTest"));
+    LogSubsystem->SetCategoryVerbosity(TestLog.GetCategory(), ELogVerbosity::Log);
+    const float DeltaSeconds = 1.0f / 90.0f;
+
+    FAllocationCountingMalloc CountingMalloc(GMalloc);
+    FMalloc* PreviousMalloc = GMalloc;
+    GMalloc = &CountingMalloc;
+
+    int64 LoggingAllocations = 0;
+    int64 MaxLoggingAllocations = 0;
+    int64 TickAllocations = 0;
+    int32 FramesOverBudget = 0;
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        CountingMalloc.TakeCount();
+        for (int32 Message = 0; Message < MessagesPerFrame; ++Message)
+        {
+            const int32 StimulusIndex = (Frame * MessagesPerFrame + Message) % 54;
+            switch (Message % 3)
+            {
+            case 0:
+                TestLog.LogMessagef(ELogVerbosity::Warning, 5.0f, false, true, false, TEXT("Stimulus %d was on screen for %.1f ms instead of %.1f ms."), StimulusIndex, 211.1 + Frame % 7, 200.0);
+                break;
+            case 1:
+                TestLog.LogMessagef(ELogVerbosity::Warning, 5.0f, false, true, false, TEXT("Stimulus %d rejected: %s during presentation."), StimulusIndex, Frame % 2 ? TEXT("saccade") : TEXT("blink"));
+                break;
+            default:
+                TestLog.LogMessagef(ELogVerbosity::Log, 5.0f, false, true, false, TEXT("Latency spike detected: %f seconds."), 0.05 + Frame * 1.0e-4);
+                break;
+            }
+        }
+        const int64 FrameAllocations = CountingMalloc.TakeCount();
+
+        FTSTicker::GetCoreTicker().Tick(DeltaSeconds);
+        TickAllocations += CountingMalloc.TakeCount();
+
+        if (Frame >= WarmupFrames)
+        {
+            LoggingAllocations += FrameAllocations;
+            MaxLoggingAllocations = FMath::Max(MaxLoggingAllocations, FrameAllocations);
+            FramesOverBudget += FrameAllocations > MaxAllocationsPerFrame ? 1 : 0;
+        }
+    }
+
+    GMalloc = PreviousMalloc;
+
+    const int32 MeasuredFrames = FMath::Max(NumFrames - WarmupFrames, 1);
+    LogManager.LogMessagef(ELogVerbosity::Display, 0.0f, true, false, true, TEXT("%d frames, %d on-screen messages per frame, %d overlay slots in use"),
+        NumFrames, MessagesPerFrame, LogSubsystem->GetOverlay()->GetActiveSlotCount());
+    LogManager.LogMessagef(ELogVerbosity::Display, 0.0f, true, false, true, TEXT("Logging: %.2f allocations per frame, at most %lld in one frame; ticker and overlay flushes: %.2f per frame"),
+        LoggingAllocations / static_cast<double>(MeasuredFrames), MaxLoggingAllocations, TickAllocations / static_cast<double>(FMath::Max(NumFrames, 1)));
+
+    if (FramesOverBudget > 0)
+    {
+        LogManager.LogMessagef(ELogVerbosity::Error, 0.0f, true, false, true, TEXT("%d frames allocated more than %d times while logging."), FramesOverBudget, MaxAllocationsPerFrame);
+        return 1;
+    }
+    return 0;
+}
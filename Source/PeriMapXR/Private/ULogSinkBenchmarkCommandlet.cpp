@@ -0,0 +1,100 @@
+// ULogSinkBenchmarkCommandlet.cpp
+
+#include "ULogSinkBenchmarkCommandlet.h"
+#include "FLogFileSink.h"
+#include "FLogManager.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/DateTime.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    // One log line in the format FLogManager writes
+    FString MakeRecord(int32 Producer, int32 Message)
+    {
+        return FString::Printf(TEXT("[%s][PeriMapXR][Display] Producer %d message %d: stimulus 12 at 27.5 dB\n"), *FDateTime::Now().ToString(), Producer, Message);
+    }
+
+    // The path FLogManager::LogMessage took before the sink: open, append and close per message
+    double RunAppendBenchmark(const FString& Directory, int32 NumMessages)
+    {
+        const FString FilePath = FPaths::Combine(Directory, TEXT("Append.txt"));
+        FFileHelper::SaveStringToFile(TEXT("Log Initialized\n"), *FilePath);
+
+        const double Start = FPlatformTime::Seconds();
+        for (int32 Message = 0; Message < NumMessages; ++Message)
+        {
+            FFileHelper::SaveStringToFile(MakeRecord(0, Message), *FilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+        }
+        return FPlatformTime::Seconds() - Start;
+    }
+
+    // Several producers logging through one sink; the sink is destroyed at the end, which drains it to disk
+    void RunSinkBenchmark(const FString& Directory, int32 NumMessages, int32 NumProducers, double& OutEnqueueSeconds, double& OutTotalSeconds, int64& OutDropped)
+    {
+        TUniquePtr<FLogFileSink> Sink = MakeUnique<FLogFileSink>(Directory, TEXT("Sink"), TEXT("txt"));
+
+        const int32 MessagesPerProducer = FMath::DivideAndRoundUp(NumMessages, NumProducers);
+        const double Start = FPlatformTime::Seconds();
+        ParallelFor(NumProducers, [&](int32 Producer)
+        {
+            const int32 End = FMath::Min(NumMessages, (Producer + 1) * MessagesPerProducer);
+            for (int32 Message = Producer * MessagesPerProducer; Message < End; ++Message)
+            {
+                Sink->Enqueue(MakeRecord(Producer, Message));
+            }
+        });
+        OutEnqueueSeconds = FPlatformTime::Seconds() - Start;
+
+        OutDropped = Sink->GetDroppedCount();
+        Sink.Reset();
+        OutTotalSeconds = FPlatformTime::Seconds() - Start;
+    }
+
+    double MessagesPerSecond(int32 NumMessages, double Seconds)
+    {
+        return Seconds > 0.0 ? NumMessages / Seconds : 0.0;
+    }
+}
+
+ULogSinkBenchmarkCommandlet::ULogSinkBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 ULogSinkBenchmarkCommandlet::Main(const FString& Params)
+{
+    FLogManager LogManager;
+
+    int32 NumMessages = 100000;
+    int32 NumProducers = 4;
+    FParse::Value(*Params, TEXT("Messages="), NumMessages);
+    FParse::Value(*Params, TEXT("Producers="), NumProducers);
+    NumMessages = FMath::Max(NumMessages, 1);
+    NumProducers = FMath::Clamp(NumProducers, 1, NumMessages);
+
+    const FString Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LogSinkBenchmark"));
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    const double AppendSeconds = RunAppendBenchmark(Directory, NumMessages);
+
+    double EnqueueSeconds = 0.0;
+    double SinkSeconds = 0.0;
+    int64 Dropped = 0;
+    RunSinkBenchmark(Directory, NumMessages, NumProducers, EnqueueSeconds, SinkSeconds, Dropped);
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+    LogManager.LogMessage(FString::Printf(TEXT("%d messages, %d sink producers"), NumMessages, NumProducers), ELogVerbosity::Display, 0.0f, true, false, true);
+    LogManager.LogMessage(FString::Printf(TEXT("Append per message: %.0f messages/s (%.3f s)"), MessagesPerSecond(NumMessages, AppendSeconds), AppendSeconds), ELogVerbosity::Display, 0.0f, true, false, true);
+    LogManager.LogMessage(FString::Printf(TEXT("Log file sink: %.0f messages/s enqueued (%.3f s), %.0f messages/s to disk (%.3f s), %lld dropped"),
+        MessagesPerSecond(NumMessages, EnqueueSeconds), EnqueueSeconds, MessagesPerSecond(NumMessages, SinkSeconds), SinkSeconds, Dropped), ELogVerbosity::Display, 0.0f, true, false, true);
+    return 0;
+}
@@ -0,0 +1,111 @@
+// UPeriMapXRLogSubsystem.cpp
+
+#include "UPeriMapXRLogSubsystem.h"
+#include "FStructuredLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+UPeriMapXRLogSubsystem* UPeriMapXRLogSubsystem::Instance = nullptr;
+
+namespace
+{
+    // PeriMapXR.LogVerbosity <Category> <Verbosity> sets a category; with no arguments it lists the current settings
+    FAutoConsoleCommand LogVerbosityCommand(
+        TEXT("PeriMapXR.LogVerbosity"),
+        TEXT("PeriMapXR.LogVerbosity <Category|Default> <NoLogging|Fatal|Error|Warning|Display|Log|Verbose|VeryVerbose>. No arguments lists the current settings."),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            UPeriMapXRLogSubsystem* LogSubsystem = UPeriMapXRLogSubsystem::Get();
+            if (!LogSubsystem)
+            {
+                return;
+            }
+
+            if (Args.Num() >= 2)
+            {
+                LogSubsystem->SetCategoryVerbosity(FName(*Args[0]), ParseLogVerbosityFromString(Args[1]));
+            }
+            LogSubsystem->DumpCategories();
+        }));
+}
+
+void UPeriMapXRLogSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    DefaultVerbosity.store(ParseLogVerbosityFromString(DefaultVerbosityName), std::memory_order_relaxed);
+
+    FLogFileSinkSettings Settings;
+    Settings.MaxFileSizeBytes = static_cast<int64>(FMath::Max(MaxLogFileSizeMB, 1)) * 1024 * 1024;
+    Settings.MaxTotalBytes = static_cast<int64>(FMath::Max(MaxLogFolderSizeMB, MaxLogFileSizeMB)) * 1024 * 1024;
+
+    // The text and structured logs share the folder budget, rather than each being allowed the whole of it
+    Settings.SharedBudgetPatterns = { TEXT("Log_*.txt"), TEXT("StructuredLog_*.plog") };
+
+    // One text log per run, rotated by size, instead of one file per FLogManager
+    TextSink = MakeUnique<FLogFileSink>(FPaths::ProjectLogDir(), TEXT("Log"), TEXT("txt"), Settings);
+    TextSink->Enqueue(FString::Printf(TEXT("[%s] Log Initialized\n"), *FDateTime::Now().ToString()));
+
+    FStructuredLog::Get().Open(FPaths::ProjectLogDir(), Settings);
+
+    Overlay = MakeUnique<FDiagnosticsOverlay>(OverlayUpdateRateHz, OverlayMaxSlots);
+
+    Instance = this;
+}
+
+void UPeriMapXRLogSubsystem::Deinitialize()
+{
+    Instance = nullptr;
+
+    // Destroying the sinks drains whatever is still queued
+    Overlay.Reset();
+    FStructuredLog::Get().Close();
+    TextSink.Reset();
+
+    Super::Deinitialize();
+}
+
+bool UPeriMapXRLogSubsystem::IsEnabled(FName Category, ELogVerbosity::Type Verbosity) const
+{
+    return (Verbosity & ELogVerbosity::VerbosityMask) <= GetCategoryVerbosity(Category);
+}
+
+void UPeriMapXRLogSubsystem::WriteToFile(FName Category, ELogVerbosity::Type Verbosity, const FString& Message)
+{
+    if (TextSink)
+    {
+        TextSink->Enqueue(FString::Printf(TEXT("[%s][%s][%s] %s\n"), *FDateTime::Now().ToString(), *Category.ToString(), ToString(Verbosity), *Message));
+    }
+}
+
+void UPeriMapXRLogSubsystem::SetCategoryVerbosity(FName Category, ELogVerbosity::Type Verbosity)
+{
+    // "Default" changes the fallback for every category without its own setting
+    if (Category == TEXT("Default"))
+    {
+        DefaultVerbosity.store(Verbosity, std::memory_order_relaxed);
+        return;
+    }
+
+    FRWScopeLock Lock(CategoryLock, SLT_Write);
+    CategoryVerbosity.Add(Category, Verbosity);
+}
+
+ELogVerbosity::Type UPeriMapXRLogSubsystem::GetCategoryVerbosity(FName Category) const
+{
+    FRWScopeLock Lock(CategoryLock, SLT_ReadOnly);
+    const ELogVerbosity::Type* Verbosity = CategoryVerbosity.Find(Category);
+    return Verbosity ? *Verbosity : DefaultVerbosity.load(std::memory_order_relaxed);
+}
+
+void UPeriMapXRLogSubsystem::DumpCategories() const
+{
+    UE_LOG(LogTemp, Display, TEXT("PeriMapXR log verbosity: Default = %s"), ToString(DefaultVerbosity.load(std::memory_order_relaxed)));
+
+    FRWScopeLock Lock(CategoryLock, SLT_ReadOnly);
+    for (const TPair<FName, ELogVerbosity::Type>& Entry : CategoryVerbosity)
+    {
+        UE_LOG(LogTemp, Display, TEXT("PeriMapXR log verbosity: %s = %s"), *Entry.Key.ToString(), ToString(Entry.Value));
+    }
+}
@@ -0,0 +1,111 @@
+// UPerimetrySimulationCommandlet.cpp
+
+#include "UPerimetrySimulationCommandlet.h"
+#include "FPerimetrySimulation.h"
+#include "FStructuredLog.h"
+#include "FLogManager.h"
+#include "FTestPatternLibrary.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    // Square grid of test points offset half a step from the meridians, like the 24-2 and 10-2 patterns,
+    // placed on the stimulus sphere the same way ATestStimuli::PolarToCartesian does
+    TArray<FVector> BuildGrid(float ExtentDegrees, float SpacingDegrees, float Radius)
+    {
+        TArray<FVector> Locations;
+        const float HalfStep = SpacingDegrees * 0.5f;
+        for (float Vertical = -ExtentDegrees + HalfStep; Vertical <= ExtentDegrees; Vertical += SpacingDegrees)
+        {
+            for (float Horizontal = -ExtentDegrees + HalfStep; Horizontal <= ExtentDegrees; Horizontal += SpacingDegrees)
+            {
+                if (FMath::Sqrt(Vertical * Vertical + Horizontal * Horizontal) > ExtentDegrees)
+                {
+                    continue;
+                }
+                const float VerticalRadians = FMath::DegreesToRadians(Vertical);
+                const float HorizontalRadians = FMath::DegreesToRadians(Horizontal);
+                Locations.Add(FVector(
+                    Radius * FMath::Cos(VerticalRadians) * FMath::Sin(HorizontalRadians),
+                    Radius * FMath::Sin(VerticalRadians),
+                    Radius * FMath::Cos(VerticalRadians) * FMath::Cos(HorizontalRadians)));
+            }
+        }
+        return Locations;
+    }
+}
+
+UPerimetrySimulationCommandlet::UPerimetrySimulationCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UPerimetrySimulationCommandlet::Main(const FString& Params)
+{
+    FLogManager LogManager(TEXT("Simulation"));
+
+    FPerimetrySimulationSettings Settings;
+    float ExtentDegrees = 24.0f;
+    float SpacingDegrees = 6.0f;
+    FParse::Value(*Params, TEXT("Sessions="), Settings.NumSessions);
+    FParse::Value(*Params, TEXT("Seed="), Settings.RandomSeed);
+    FParse::Value(*Params, TEXT("Extent="), ExtentDegrees);
+    FParse::Value(*Params, TEXT("Spacing="), SpacingDegrees);
+    FParse::Value(*Params, TEXT("MinThreshold="), Settings.MinTrueThresholdInDb);
+    FParse::Value(*Params, TEXT("MaxThreshold="), Settings.MaxTrueThresholdInDb);
+    FParse::Value(*Params, TEXT("FalsePositive="), Settings.Observer.FalsePositiveRate);
+    FParse::Value(*Params, TEXT("FalseNegative="), Settings.Observer.FalseNegativeRate);
+    FParse::Value(*Params, TEXT("FixationLoss="), Settings.Observer.FixationLossRate);
+    FParse::Value(*Params, TEXT("Slope="), Settings.Observer.Psychometric.Slope);
+    FParse::Value(*Params, TEXT("Lapse="), Settings.Observer.Psychometric.LapseRate);
+    Settings.bEstimatePatientPsychometrics = !FParse::Param(*Params, TEXT("FixedPsychometrics"));
+    FParse::Value(*Params, TEXT("CatchTrials="), Settings.Scheduler.CatchTrialProbability);
+    FParse::Value(*Params, TEXT("MaxPresentations="), Settings.Scheduler.MaxPresentationsPerLocation);
+    FParse::Value(*Params, TEXT("MaxRejections="), Settings.Scheduler.MaxRejectionsPerLocation);
+
+    // Same radius as the 24-2 settings in ATestStimuli; only the directions matter to the scheduler
+    FString PatternName;
+    if (FParse::Value(*Params, TEXT("Pattern="), PatternName))
+    {
+        if (!FTestPatternLibrary::FindByName(PatternName, Settings.TestType))
+        {
+            LogManager.LogMessage(FString::Printf(TEXT("Unknown pattern '%s'."), *PatternName), ELogVerbosity::Error, 0.0f, true, false, true);
+            return 1;
+        }
+        Settings.Locations = FTestPatternLibrary::GetLocations(Settings.TestType, false, 133.5f);
+    }
+    else
+    {
+        Settings.Locations = BuildGrid(ExtentDegrees, FMath::Max(SpacingDegrees, 1.0f), 133.5f);
+    }
+
+    FString StrategyName = TEXT("Mean");
+    FParse::Value(*Params, TEXT("Strategy="), StrategyName);
+    TArray<EStimulusSelectionStrategy> Strategies;
+    if (StrategyName == TEXT("Entropy") || StrategyName == TEXT("Both"))
+    {
+        Strategies.Add(EStimulusSelectionStrategy::MinimumExpectedEntropy);
+    }
+    if (StrategyName != TEXT("Entropy"))
+    {
+        Strategies.Insert(EStimulusSelectionStrategy::PosteriorMean, 0);
+    }
+
+    // Thousands of sessions would flood the structured log; nothing simulated is written there
+    FStructuredLog::Get().SetEnabled(false);
+
+    for (const EStimulusSelectionStrategy Strategy : Strategies)
+    {
+        Settings.SelectionStrategy = Strategy;
+        const FPerimetrySimulationReport Report = FPerimetrySimulation::Run(Settings);
+
+        const TCHAR* Name = Strategy == EStimulusSelectionStrategy::PosteriorMean ? TEXT("PosteriorMean") : TEXT("MinimumExpectedEntropy");
+        LogManager.LogMessage(FString::Printf(TEXT("%s: %s"), Name, *Report.ToString()), ELogVerbosity::Display, 0.0f, true, false, true);
+    }
+
+    FStructuredLog::Get().SetEnabled(true);
+    return 0;
+}
\ No newline at end of file
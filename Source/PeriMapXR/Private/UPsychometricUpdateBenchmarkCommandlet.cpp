@@ -0,0 +1,193 @@
+// UPsychometricUpdateBenchmarkCommandlet.cpp
+
+#include "UPsychometricUpdateBenchmarkCommandlet.h"
+#include "FPsychometricTable.h"
+#include "FPosteriorStore.h"
+#include "FLogManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    // One response, drawn before timing starts
+    struct FBenchmarkResponse
+    {
+        int32 LocationIndex;
+        float IntensityInDb;
+        bool bSeen;
+    };
+
+    // Posterior mean of a normalized row; summed into a checksum so no variant can be optimized away
+    float RowMean(const TArray<float>& Row, const TArray<float>& Levels)
+    {
+        float Mean = 0.0f;
+        for (int32 Index = 0; Index < Levels.Num(); ++Index)
+        {
+            Mean += Row[Index] * Levels[Index];
+        }
+        return Mean;
+    }
+
+    void Normalize(TArray<float>& Row)
+    {
+        float Sum = 0.0f;
+        for (const float Value : Row)
+        {
+            Sum += Value;
+        }
+        const float Scale = Sum > 0.0f ? 1.0f / Sum : 0.0f;
+        for (float& Value : Row)
+        {
+            Value *= Scale;
+        }
+    }
+
+    // The estimator before the tables: the psychometric function for every bin, then multiply and normalize
+    double RunDirect(const FPsychometricParams& Params, const TArray<float>& Levels, const TArray<FBenchmarkResponse>& Responses, int32 NumLocations, int32 UpdatesPerLocation, double& OutChecksum)
+    {
+        TArray<TArray<float>> Posteriors;
+        Posteriors.SetNum(NumLocations);
+        const int32 SessionLength = NumLocations * UpdatesPerLocation;
+
+        const double Start = FPlatformTime::Seconds();
+        for (int32 Update = 0; Update < Responses.Num(); ++Update)
+        {
+            if (Update % SessionLength == 0)
+            {
+                for (TArray<float>& Posterior : Posteriors)
+                {
+                    Posterior.Init(1.0f / Levels.Num(), Levels.Num());
+                }
+            }
+            const FBenchmarkResponse& Response = Responses[Update];
+            TArray<float>& Row = Posteriors[Response.LocationIndex];
+            for (int32 Index = 0; Index < Levels.Num(); ++Index)
+            {
+                const float Probability = FPsychometricTable::Evaluate(Params, Response.IntensityInDb, Levels[Index]);
+                Row[Index] *= Response.bSeen ? Probability : 1.0f - Probability;
+            }
+            Normalize(Row);
+            OutChecksum += RowMean(Row, Levels);
+        }
+        return FPlatformTime::Seconds() - Start;
+    }
+
+    // The same linear posterior, multiplied by a precomputed table row instead
+    double RunTable(const FPsychometricTable& Table, const TArray<float>& Levels, const TArray<FBenchmarkResponse>& Responses, int32 NumLocations, int32 UpdatesPerLocation, double& OutChecksum)
+    {
+        TArray<TArray<float>> Posteriors;
+        Posteriors.SetNum(NumLocations);
+        const int32 SessionLength = NumLocations * UpdatesPerLocation;
+
+        const double Start = FPlatformTime::Seconds();
+        for (int32 Update = 0; Update < Responses.Num(); ++Update)
+        {
+            if (Update % SessionLength == 0)
+            {
+                for (TArray<float>& Posterior : Posteriors)
+                {
+                    Posterior.Init(1.0f / Levels.Num(), Levels.Num());
+                }
+            }
+            const FBenchmarkResponse& Response = Responses[Update];
+            TArray<float>& Row = Posteriors[Response.LocationIndex];
+            const float* Likelihoods = Table.GetLikelihoodRow(Response.IntensityInDb, Response.bSeen);
+            for (int32 Index = 0; Index < Levels.Num(); ++Index)
+            {
+                Row[Index] *= Likelihoods[Index];
+            }
+            Normalize(Row);
+            OutChecksum += RowMean(Row, Levels);
+        }
+        return FPlatformTime::Seconds() - Start;
+    }
+
+    // The store the estimator uses now: log-domain rows, vector kernels and cached moments
+    double RunStore(const TSharedRef<const FPsychometricTable>& Table, const TArray<FBenchmarkResponse>& Responses, int32 NumLocations, int32 UpdatesPerLocation, double& OutChecksum)
+    {
+        FPosteriorStore Store;
+        const int32 SessionLength = NumLocations * UpdatesPerLocation;
+
+        const double Start = FPlatformTime::Seconds();
+        for (int32 Update = 0; Update < Responses.Num(); ++Update)
+        {
+            if (Update % SessionLength == 0)
+            {
+                Store.Initialize(Table);
+                for (int32 LocationIndex = 0; LocationIndex < NumLocations; ++LocationIndex)
+                {
+                    Store.AddLocation();
+                }
+            }
+            const FBenchmarkResponse& Response = Responses[Update];
+            Store.Update(Response.LocationIndex, Response.IntensityInDb, Response.bSeen);
+            OutChecksum += Store.GetMean(Response.LocationIndex);
+        }
+        return FPlatformTime::Seconds() - Start;
+    }
+
+    double UpdatesPerSecond(int32 NumUpdates, double Seconds)
+    {
+        return Seconds > 0.0 ? NumUpdates / Seconds : 0.0;
+    }
+}
+
+UPsychometricUpdateBenchmarkCommandlet::UPsychometricUpdateBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UPsychometricUpdateBenchmarkCommandlet::Main(const FString& Params)
+{
+    FLogManager LogManager(TEXT("Simulation"));
+
+    int32 NumUpdates = 1000000;
+    int32 NumLocations = 54;
+    int32 UpdatesPerLocation = 12;
+    int32 Seed = 1;
+    FParse::Value(*Params, TEXT("Updates="), NumUpdates);
+    FParse::Value(*Params, TEXT("Locations="), NumLocations);
+    FParse::Value(*Params, TEXT("UpdatesPerLocation="), UpdatesPerLocation);
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+    NumUpdates = FMath::Max(NumUpdates, 1);
+    NumLocations = FMath::Max(NumLocations, 1);
+    UpdatesPerLocation = FMath::Max(UpdatesPerLocation, 1);
+
+    const FPsychometricParams Psychometric;
+    const TSharedRef<const FPsychometricTable> Table = FPsychometricTable::GetOrCreate(Psychometric);
+    const TArray<float>& Levels = Table->GetThresholdLevels();
+
+    // Locations are visited in turn, as the scheduler sweeps the field; intensities straddle each true threshold
+    FRandomStream RandomStream(Seed);
+    TArray<float> TrueThresholdsInDb;
+    for (int32 LocationIndex = 0; LocationIndex < NumLocations; ++LocationIndex)
+    {
+        TrueThresholdsInDb.Add(RandomStream.FRandRange(15.0f, 35.0f));
+    }
+    TArray<FBenchmarkResponse> Responses;
+    Responses.Reserve(NumUpdates);
+    for (int32 Update = 0; Update < NumUpdates; ++Update)
+    {
+        FBenchmarkResponse& Response = Responses.AddDefaulted_GetRef();
+        Response.LocationIndex = Update % NumLocations;
+        const float TrueThreshold = TrueThresholdsInDb[Response.LocationIndex];
+        Response.IntensityInDb = FMath::Clamp(TrueThreshold + RandomStream.FRandRange(-6.0f, 6.0f), Psychometric.MinThresholdInDb, Psychometric.MaxThresholdInDb);
+        Response.bSeen = RandomStream.FRand() < FPsychometricTable::Evaluate(Psychometric, Response.IntensityInDb, TrueThreshold);
+    }
+
+    double DirectChecksum = 0.0;
+    double TableChecksum = 0.0;
+    double StoreChecksum = 0.0;
+    const double DirectSeconds = RunDirect(Psychometric, Levels, Responses, NumLocations, UpdatesPerLocation, DirectChecksum);
+    const double TableSeconds = RunTable(*Table, Levels, Responses, NumLocations, UpdatesPerLocation, TableChecksum);
+    const double StoreSeconds = RunStore(Table, Responses, NumLocations, UpdatesPerLocation, StoreChecksum);
+
+    LogManager.LogMessagef(ELogVerbosity::Display, 0.0f, true, false, true, TEXT("%d updates over %d locations, %d threshold bins"), NumUpdates, NumLocations, Levels.Num());
+    LogManager.LogMessagef(ELogVerbosity::Display, 0.0f, true, false, true, TEXT("Direct evaluation: %.0f updates/s (mean of means %.3f dB)"), UpdatesPerSecond(NumUpdates, DirectSeconds), DirectChecksum / NumUpdates);
+    LogManager.LogMessagef(ELogVerbosity::Display, 0.0f, true, false, true, TEXT("Likelihood table: %.0f updates/s (mean of means %.3f dB)"), UpdatesPerSecond(NumUpdates, TableSeconds), TableChecksum / NumUpdates);
+    LogManager.LogMessagef(ELogVerbosity::Display, 0.0f, true, false, true, TEXT("Posterior store: %.0f updates/s (mean of means %.3f dB)"), UpdatesPerSecond(NumUpdates, StoreSeconds), StoreChecksum / NumUpdates);
+    return 0;
+}
@@ -0,0 +1,149 @@
+// UStimulusFieldBenchmarkCommandlet.cpp
+
+#include "UStimulusFieldBenchmarkCommandlet.h"
+#include "UStimulusFieldComponent.h"
+#include "AStimuli.h"
+#include "FTestPatternLibrary.h"
+#include "FLogManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    // Timings for one way of drawing the stimuli
+    struct FStimulusBenchmarkResult
+    {
+        int32 ActorsAdded = 0;
+        double SetupMilliseconds = 0.0;
+        double MicrosecondsPerFlash = 0.0;
+
+        FString ToString(const TCHAR* Name) const
+        {
+            return FString::Printf(TEXT("%s: %d actors added, setup %.3f ms, %.3f us per flash"), Name, ActorsAdded, SetupMilliseconds, MicrosecondsPerFlash);
+        }
+    };
+
+    // One AStimuli actor per location, set up and flashed the way ATestStimuli used to
+    FStimulusBenchmarkResult RunActorBenchmark(UWorld* World, const TArray<FVector>& Locations, float Diameter, int32 NumFlashes)
+    {
+        FStimulusBenchmarkResult Result;
+        const int32 ActorsBefore = World->PersistentLevel->Actors.Num();
+
+        TArray<AStimuli*> Actors;
+        const double SetupStart = FPlatformTime::Seconds();
+        for (const FVector& Location : Locations)
+        {
+            AStimuli* Stimulus = World->SpawnActor<AStimuli>(AStimuli::StaticClass(), Location, FRotator::ZeroRotator);
+            if (Stimulus)
+            {
+                Stimulus->bEnableConsoleMessages = false;
+                Stimulus->bEnableOnScreenMessages = false;
+                Stimulus->bEnableSaveToLog = false;
+                Stimulus->SetVisibility(false);
+                Stimulus->SetScale(Diameter);
+                Actors.Add(Stimulus);
+            }
+        }
+        Result.SetupMilliseconds = (FPlatformTime::Seconds() - SetupStart) * 1000.0;
+        Result.ActorsAdded = World->PersistentLevel->Actors.Num() - ActorsBefore;
+
+        if (Actors.Num() > 0)
+        {
+            const double FlashStart = FPlatformTime::Seconds();
+            for (int32 Flash = 0; Flash < NumFlashes; ++Flash)
+            {
+                AStimuli* Stimulus = Actors[Flash % Actors.Num()];
+                Stimulus->SetBrightnessFromDb(static_cast<float>(Flash % 40));
+                Stimulus->SetVisibility(true);
+                Stimulus->SetVisibility(false);
+            }
+            Result.MicrosecondsPerFlash = (FPlatformTime::Seconds() - FlashStart) * 1.0e6 / FMath::Max(NumFlashes, 1);
+        }
+
+        for (AStimuli* Stimulus : Actors)
+        {
+            Stimulus->Destroy();
+        }
+        return Result;
+    }
+
+    // A single stimulus field on one host actor, as ATestStimuli now uses it
+    FStimulusBenchmarkResult RunFieldBenchmark(UWorld* World, const TArray<FVector>& Locations, float Diameter, int32 NumFlashes)
+    {
+        FStimulusBenchmarkResult Result;
+        const int32 ActorsBefore = World->PersistentLevel->Actors.Num();
+
+        const double SetupStart = FPlatformTime::Seconds();
+        AActor* Host = World->SpawnActor<AActor>();
+        UStimulusFieldComponent* Field = NewObject<UStimulusFieldComponent>(Host);
+        Host->SetRootComponent(Field);
+        Field->RegisterComponent();
+        Field->SetStimuli(Locations, Diameter);
+        Result.SetupMilliseconds = (FPlatformTime::Seconds() - SetupStart) * 1000.0;
+        Result.ActorsAdded = World->PersistentLevel->Actors.Num() - ActorsBefore;
+
+        if (Field->GetNumStimuli() > 0)
+        {
+            const double FlashStart = FPlatformTime::Seconds();
+            for (int32 Flash = 0; Flash < NumFlashes; ++Flash)
+            {
+                const int32 StimulusIndex = Flash % Field->GetNumStimuli();
+                Field->ShowStimulus(StimulusIndex, static_cast<float>(Flash % 40));
+                Field->HideStimulus(StimulusIndex);
+            }
+            Result.MicrosecondsPerFlash = (FPlatformTime::Seconds() - FlashStart) * 1.0e6 / FMath::Max(NumFlashes, 1);
+        }
+
+        Host->Destroy();
+        return Result;
+    }
+}
+
+UStimulusFieldBenchmarkCommandlet::UStimulusFieldBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UStimulusFieldBenchmarkCommandlet::Main(const FString& Params)
+{
+    FLogManager LogManager(TEXT("Simulation"));
+
+    FString PatternName = TEXT("24-2");
+    int32 NumFlashes = 10000;
+    FParse::Value(*Params, TEXT("Pattern="), PatternName);
+    FParse::Value(*Params, TEXT("Flashes="), NumFlashes);
+
+    ETestType TestType = ETestType::TEST_24_2;
+    if (!FTestPatternLibrary::FindByName(PatternName, TestType))
+    {
+        LogManager.LogMessage(FString::Printf(TEXT("Unknown pattern '%s'."), *PatternName), ELogVerbosity::Error, 0.0f, true, false, true);
+        return 1;
+    }
+
+    // Same radius and diameter as the 24-2 settings in ATestStimuli
+    const TArray<FVector>& Locations = FTestPatternLibrary::GetLocations(TestType, false, 133.5f);
+    const float Diameter = 2.0f;
+
+    // A bare game world with nothing in it but what each benchmark spawns
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("StimulusFieldBenchmark"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+    World->InitializeActorsForPlay(FURL());
+    World->BeginPlay();
+
+    const FStimulusBenchmarkResult ActorResult = RunActorBenchmark(World, Locations, Diameter, NumFlashes);
+    const FStimulusBenchmarkResult FieldResult = RunFieldBenchmark(World, Locations, Diameter, NumFlashes);
+
+    LogManager.LogMessage(FString::Printf(TEXT("%s pattern, %d stimuli, %d flashes"), *PatternName, Locations.Num(), NumFlashes), ELogVerbosity::Display, 0.0f, true, false, true);
+    LogManager.LogMessage(ActorResult.ToString(TEXT("AStimuli actors")), ELogVerbosity::Display, 0.0f, true, false, true);
+    LogManager.LogMessage(FieldResult.ToString(TEXT("Stimulus field")), ELogVerbosity::Display, 0.0f, true, false, true);
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    return 0;
+}
@@ -0,0 +1,137 @@
+// UStimulusFieldComponent.cpp
+
+#include "UStimulusFieldComponent.h"
+#include "UObject/ConstructorHelpers.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/Material.h"
+
+// Sets default values
+UStimulusFieldComponent::UStimulusFieldComponent()
+{
+    // Stimuli only change when the test asks them to
+    PrimaryComponentTick.bCanEverTick = false;
+
+    // Initialize max luminance and brightness values
+    MaxLuminanceNits = 60.0f; // Max luminance of the Pico 4 in nits
+    MaxBrightness = 1.0f; // Max brightness for Unreal Engine material (0-1 range)
+
+    // Brightness and visibility per instance
+    NumCustomDataFloats = 2;
+
+    // Stimuli are points of light: they neither collide nor cast shadows
+    SetMobility(EComponentMobility::Movable);
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SetCastShadow(false);
+
+    // Same sphere mesh and stimulus material as AStimuli
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> SphereMeshAsset(TEXT("/Game/Mesh/Sphere.Sphere"));
+    if (SphereMeshAsset.Succeeded())
+    {
+        SetStaticMesh(SphereMeshAsset.Object);
+    }
+    else
+    {
+        LogManager.LogMessage(TEXT("UStimulusFieldComponent::Failed to find mesh for stimuli."), ELogVerbosity::Error, 5.0f, true, false, true);
+    }
+
+    static ConstructorHelpers::FObjectFinder<UMaterial> MaterialAsset(TEXT("/Game/Material/M_Stimuli.M_Stimuli"));
+    if (MaterialAsset.Succeeded())
+    {
+        SetMaterial(0, MaterialAsset.Object);
+    }
+    else
+    {
+        LogManager.LogMessage(TEXT("UStimulusFieldComponent::Failed to find M_Stimuli material."), ELogVerbosity::Error, 5.0f, true, false, true);
+    }
+}
+
+// Function to replace all stimuli with one hidden instance per location, scaled to a diameter
+void UStimulusFieldComponent::SetStimuli(const TArray<FVector>& RelativeLocations, float DesiredDiameter)
+{
+    // Original diameter of UE sphere mesh is 100 units
+    ShownScale = FVector(DesiredDiameter / 100.0f);
+    StimulusLocations = RelativeLocations;
+
+    // Every stimulus starts hidden: at zero scale, and with zeroed custom data
+    TArray<FTransform> Transforms;
+    Transforms.Reserve(RelativeLocations.Num());
+    for (const FVector& RelativeLocation : RelativeLocations)
+    {
+        Transforms.Emplace(FQuat::Identity, RelativeLocation, FVector::ZeroVector);
+    }
+
+    ClearInstances();
+    AddInstances(Transforms, false);
+}
+
+// Function to remove all stimuli
+void UStimulusFieldComponent::ClearStimuli()
+{
+    StimulusLocations.Reset();
+    ClearInstances();
+}
+
+// Function to show a stimulus at an intensity in decibels
+void UStimulusFieldComponent::ShowStimulus(int32 StimulusIndex, float StimulusIntensityInDb)
+{
+    if (!IsValidInstance(StimulusIndex))
+    {
+        LogManager.LogMessagef(ELogVerbosity::Error, 5.0f, true, false, true, TEXT("UStimulusFieldComponent::No stimulus at index %d."), StimulusIndex);
+        return;
+    }
+
+    const float Brightness = GetBrightnessFromDb(StimulusIntensityInDb);
+    if (!DynamicMaterial)
+    {
+        DynamicMaterial = CreateDynamicMaterialInstance(0);
+    }
+    if (DynamicMaterial)
+    {
+        DynamicMaterial->SetScalarParameterValue(TEXT("Brightness"), Brightness);
+    }
+
+    SetCustomDataValue(StimulusIndex, BrightnessDataIndex, Brightness, false);
+    SetCustomDataValue(StimulusIndex, VisibilityDataIndex, 1.0f, false);
+    SetStimulusScale(StimulusIndex, ShownScale, true);
+}
+
+// Function to hide a stimulus
+void UStimulusFieldComponent::HideStimulus(int32 StimulusIndex)
+{
+    if (IsValidInstance(StimulusIndex))
+    {
+        SetCustomDataValue(StimulusIndex, VisibilityDataIndex, 0.0f, false);
+        SetStimulusScale(StimulusIndex, FVector::ZeroVector, true);
+    }
+}
+
+// Function to hide every stimulus
+void UStimulusFieldComponent::HideAllStimuli()
+{
+    const int32 NumStimuli = GetInstanceCount();
+    for (int32 StimulusIndex = 0; StimulusIndex < NumStimuli; ++StimulusIndex)
+    {
+        SetCustomDataValue(StimulusIndex, VisibilityDataIndex, 0.0f, false);
+        SetStimulusScale(StimulusIndex, FVector::ZeroVector, false);
+    }
+    MarkRenderStateDirty();
+}
+
+// Function to move an instance between its shown and hidden (zero) scale
+void UStimulusFieldComponent::SetStimulusScale(int32 StimulusIndex, const FVector& Scale, bool bMarkRenderStateDirty)
+{
+    if (StimulusLocations.IsValidIndex(StimulusIndex))
+    {
+        UpdateInstanceTransform(StimulusIndex, FTransform(FQuat::Identity, StimulusLocations[StimulusIndex], Scale), false, bMarkRenderStateDirty);
+    }
+}
+
+// Function to convert an intensity in decibels to material brightness
+float UStimulusFieldComponent::GetBrightnessFromDb(float dBValue) const
+{
+    // Calculate luminance from dB value using the formula: Luminance = L_max * 10^(-dB/10)
+    const float Luminance = MaxLuminanceNits * FMath::Pow(10.0f, -dBValue / 10.0f);
+
+    // Normalize luminance to the 0-1 range for material brightness (0 = black, MaxLuminanceNits = full brightness)
+    return FMath::Clamp(Luminance / MaxLuminanceNits, 0.0f, MaxBrightness);
+}
@@ -4,7 +4,7 @@
 #include "Math/UnrealMathUtility.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
-#include <cmath>
+#include "FStructuredLog.h"
 
 // Constructor
 UThresholdEstimator::UThresholdEstimator()
@@ -15,6 +15,33 @@ UThresholdEstimator::UThresholdEstimator()
     ThresholdStepSizeInDb = 1.0f;
     StoppingCriterionInDb = 1.0f; // Standard deviation threshold for stopping
     bIsLeftEye = true;
+    StateVersion = 0;
+    LayoutVersion = 0;
+    SelectionStrategy = EStimulusSelectionStrategy::PosteriorMean;
+
+    // Spatial priors: neighbours within about two grid steps of the 24-2 and 10-2 patterns
+    bUseSpatialPriors = true;
+    NeighborRadiusDegrees = 10.0f;
+    MaxNeighborsPerLocation = 8;
+    SpatialPriorStandardDeviationInDb = 4.0f;
+
+    // Normative priors need the patient's age, which the caller provides
+    bUseNormativePriors = true;
+    PatientAgeYears = 0;
+
+    // Previous visits are supplied by the caller; allow for a few dB of change since then
+    bUsePreviousVisitPriors = true;
+    PreviousVisitDriftInDb = 3.0f;
+
+    // Parameters for the psychometric function; the likelihood table is built on first use
+    PsychometricParams.Slope = 3.0f;
+    PsychometricParams.GuessRate = 0.5f;
+    PsychometricParams.LapseRate = 0.01f;
+
+    // Patient model: slopes around the fixed default, and lapse rates from attentive to distracted
+    bEstimatePatientPsychometrics = true;
+    PatientSlopeHypotheses = { 1.0f, 2.0f, 3.0f, 4.5f, 6.0f };
+    PatientLapseRateHypotheses = { 0.01f, 0.03f, 0.08f };
 }
 
 // Destructor
@@ -26,125 +53,359 @@ UThresholdEstimator::~UThresholdEstimator()
 // Initializes the estimator for a new test
 void UThresholdEstimator::Initialize(const FTestSettings& TestSettings, ETestType TestType, bool bLeftEye)
 {
-    bLeftEye = bIsLeftEye;
+    bIsLeftEye = bLeftEye;
     CurrentTestSettings = TestSettings;
     CurrentTestType = TestType;
 
-    // Cleanup any existing estimators
+    // Cleanup any existing estimators, carrying what the other eye learned about the patient into this one
+    const FHierarchicalPosteriorStore& OtherEyePosteriors = (bIsLeftEye ? RightEye : LeftEye).Posteriors;
+    const TArray<float> PatientLogPrior = OtherEyePosteriors.Num() > 0 ? OtherEyePosteriors.GetHypothesisLogPosterior() : TArray<float>();
     CleanupEstimators();
+    ++StateVersion;
+    FEyeState& Eye = GetCurrentEye();
+    Eye.Posteriors.Initialize(GetLikelihoodTables());
+    Eye.Posteriors.SetHypothesisLogPrior(PatientLogPrior);
+
+    // Pick the normative pattern and age band once; per-location lookups are then a single grid read
+    NormativePriors = (bUseNormativePriors && PatientAgeYears > 0) ? FNormativePriorDatabase::Get().Select(TestType, PatientAgeYears) : FNormativePriorSelection();
+
+    // Parse the previous visit once per file, then resolve every registered location for this eye up front
+    if (!bUsePreviousVisitPriors || PreviousVisitResultsFile.IsEmpty())
+    {
+        PreviousVisit.Reset();
+    }
+    else if (PreviousVisit.GetPath() != PreviousVisitResultsFile && !PreviousVisit.Load(PreviousVisitResultsFile))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No usable previous visit in %s; starting without it."), *PreviousVisitResultsFile);
+    }
+    ResolvePreviousVisitPriors(Eye, bIsLeftEye, 0);
 
     // Initialize estimation parameters if needed
     // MinThresholdInDb, MaxThresholdInDb, ThresholdStepSizeInDb can be set based on TestSettings or TestType
 }
 
-// Updates the estimator with a user's response at a location
+// Registers the test pattern so the trial loop can address locations by ID
+TArray<int32> UThresholdEstimator::RegisterLocations(const TArray<FVector>& Locations)
+{
+    const int32 FirstNewLocationId = LocationRegistry.Num();
+    TArray<int32> LocationIds;
+    LocationIds.Reserve(Locations.Num());
+    for (const FVector& Location : Locations)
+    {
+        LocationIds.Add(LocationRegistry.FindOrAdd(Location));
+    }
+
+    LeftEye.Grow(LocationRegistry.Num());
+    RightEye.Grow(LocationRegistry.Num());
+    ResolvePreviousVisitPriors(LeftEye, true, FirstNewLocationId);
+    ResolvePreviousVisitPriors(RightEye, false, FirstNewLocationId);
+
+    ++LayoutVersion;
+    ++StateVersion;
+
+    // The neighbour graph only links locations of this pattern
+    NeighborGraph.Build(LocationRegistry.GetLocations(), LocationIds, NeighborRadiusDegrees, MaxNeighborsPerLocation);
+    return LocationIds;
+}
+
+// Looks up the ID of a registered location
+int32 UThresholdEstimator::FindLocationId(const FVector& Location) const
+{
+    return LocationRegistry.Find(Location);
+}
+
+// Returns the location registered under an ID
+FVector UThresholdEstimator::GetLocationById(int32 LocationId) const
+{
+    return LocationRegistry.IsValidId(LocationId) ? LocationRegistry.GetLocation(LocationId) : FVector::ZeroVector;
+}
+
+// Updates the estimator with a user's response at a location; only RegisterLocations adds locations, so an
+// unregistered one is ignored like an unknown ID
 void UThresholdEstimator::UpdateWithResponse(const FVector& Location, float StimulusIntensity, bool bSeen)
 {
-    LocationEstimator* Estimator = GetOrCreateLocationEstimator(Location);
-    if (Estimator && !Estimator->bEstimationComplete)
+    UpdateWithResponseById(LocationRegistry.Find(Location), StimulusIntensity, bSeen);
+}
+
+void UThresholdEstimator::UpdateWithResponseById(int32 LocationId, float StimulusIntensity, bool bSeen)
+{
+    if (!LocationRegistry.IsValidId(LocationId))
     {
-        // Debugging: Log the response details before updating the probability distribution
-        UE_LOG(LogTemp, Warning, TEXT("Updating probability distribution for location %s with intensity %f dB, Seen: %s"), *Location.ToString(), StimulusIntensity, bSeen ? TEXT("True") : TEXT("False"));
+        return;
+    }
 
-        Estimator->UpdateProbabilityDistribution(StimulusIntensity, bSeen);
-        RecordStimulusResult(Location, bSeen, StimulusIntensity);
+    bool bCompleted = false;
+    if (ApplyResponseById(LocationId, StimulusIntensity, bSeen, bCompleted))
+    {
+        RecordAppliedResponse(LocationId, StimulusIntensity, bSeen, bCompleted);
+    }
+}
 
-        if (bSeen)
-        {
-            Estimator->ConsistentResponsesCount++;
-            ConsistencyMap.FindOrAdd(Location)++;
-        }
-        else
-        {
-            Estimator->ConsistentResponsesCount = 0;
-            ConsistencyMap.FindOrAdd(Location) = 0;
-        }
+// Applies a response to the current eye's state only; logging and recording are left to the caller
+bool UThresholdEstimator::ApplyResponseById(int32 LocationId, float StimulusIntensity, bool bSeen, bool& bOutCompleted)
+{
+    bOutCompleted = false;
+    FEyeState& Eye = GetCurrentEye();
+    const int32 Row = GetOrCreatePosteriorRow(LocationId);
+    if (Eye.Posteriors.IsComplete(Row))
+    {
+        return false;
+    }
 
-        if (Estimator->IsThresholdEstimationComplete(StoppingCriterionInDb))
-        {
-            float EstimatedThresholdInDb = Estimator->GetThresholdEstimateInDb();
-            GetCurrentThresholdMap().Add(Location, EstimatedThresholdInDb); // Use GetCurrentThresholdMap() here
-            Estimator->bEstimationComplete = true;
+    ++StateVersion;
+    Eye.Posteriors.Update(Row, StimulusIntensity, bSeen);
 
-            // Debugging: Log when the threshold estimation is completed
-            UE_LOG(LogTemp, Warning, TEXT("Threshold estimation complete for location %s. Estimated threshold: %f dB"), *Location.ToString(), EstimatedThresholdInDb);
-        }
+    if (bSeen)
+    {
+        Eye.ConsistentSeenCounts[LocationId]++;
+    }
+    else
+    {
+        Eye.ConsistentSeenCounts[LocationId] = 0;
+    }
+
+    // Check if the standard deviation of the posterior is below the stopping criterion; both are cached by the update
+    const float EstimatedThresholdInDb = Eye.Posteriors.GetMean(Row);
+    if (Eye.Posteriors.GetStandardDeviation(Row) <= StoppingCriterionInDb)
+    {
+        SetThreshold(LocationId, EstimatedThresholdInDb);
+        Eye.Posteriors.SetComplete(Row, true);
+        PropagateToNeighbors(LocationId, EstimatedThresholdInDb);
+        bOutCompleted = true;
+    }
+    return true;
+}
+
+// Logs a response that has been applied, along with the updated distribution, and records it
+void UThresholdEstimator::RecordAppliedResponse(int32 LocationId, float StimulusIntensity, bool bSeen, bool bCompleted)
+{
+    const FEyeState& Eye = GetCurrentEye();
+    const int32 Row = Eye.RowByLocationId[LocationId];
+    const FVector& Location = LocationRegistry.GetLocation(LocationId);
+
+    // Debugging: Record the response details and the updated distribution; formatting happens offline
+    FStructuredLog::Get().Log(EStructuredLogFormat::EstimatorUpdate, Location, StimulusIntensity, bSeen);
+    if (FStructuredLog::Get().IsEnabled())
+    {
+        TArray<float> Posterior;
+        Eye.Posteriors.GetPosterior(Row, Posterior);
+        FStructuredLog::Get().Log(EStructuredLogFormat::EstimatorPosterior, Location, MinThresholdInDb, ThresholdStepSizeInDb, TArrayView<const float>(Posterior));
+    }
+    RecordStimulusResult(Location, bSeen, StimulusIntensity);
+
+    // Debugging: Log when the threshold estimation is completed
+    if (bCompleted)
+    {
+        FStructuredLog::Get().Log(EStructuredLogFormat::EstimatorComplete, Location, Eye.ThresholdsInDb[LocationId]);
+    }
+}
+
+// Copies the layout (when it changed) and the current eye's state from another estimator
+void UThresholdEstimator::CopyStateFrom(const UThresholdEstimator& Other)
+{
+    if (LayoutVersion != Other.LayoutVersion)
+    {
+        LocationRegistry = Other.LocationRegistry;
+        NeighborGraph = Other.NeighborGraph;
+        LayoutVersion = Other.LayoutVersion;
+    }
+
+    // The whole configuration, so a branch estimator behaves exactly like the one it was copied from
+    SelectionStrategy = Other.SelectionStrategy;
+    bUseSpatialPriors = Other.bUseSpatialPriors;
+    NeighborRadiusDegrees = Other.NeighborRadiusDegrees;
+    MaxNeighborsPerLocation = Other.MaxNeighborsPerLocation;
+    SpatialPriorStandardDeviationInDb = Other.SpatialPriorStandardDeviationInDb;
+    bUseNormativePriors = Other.bUseNormativePriors;
+    PatientAgeYears = Other.PatientAgeYears;
+    bUsePreviousVisitPriors = Other.bUsePreviousVisitPriors;
+    PreviousVisitResultsFile = Other.PreviousVisitResultsFile;
+    PreviousVisitDriftInDb = Other.PreviousVisitDriftInDb;
+    bEstimatePatientPsychometrics = Other.bEstimatePatientPsychometrics;
+    PatientSlopeHypotheses = Other.PatientSlopeHypotheses;
+    PatientLapseRateHypotheses = Other.PatientLapseRateHypotheses;
+    NormativePriors = Other.NormativePriors;
+    CurrentTestSettings = Other.CurrentTestSettings;
+    CurrentTestType = Other.CurrentTestType;
+    MinThresholdInDb = Other.MinThresholdInDb;
+    MaxThresholdInDb = Other.MaxThresholdInDb;
+    ThresholdStepSizeInDb = Other.ThresholdStepSizeInDb;
+    StoppingCriterionInDb = Other.StoppingCriterionInDb;
+    PsychometricParams = Other.PsychometricParams;
+    LikelihoodTables = Other.LikelihoodTables;
+    bIsLeftEye = Other.bIsLeftEye;
+
+    GetCurrentEye() = Other.GetCurrentEye();
+    StateVersion = Other.StateVersion;
+}
+
+// Takes over the current eye's state from a branch that copied this estimator and applied one more response
+void UThresholdEstimator::CommitBranch(UThresholdEstimator& Branch, int32 LocationId, float StimulusIntensity, bool bSeen, bool bApplied, bool bCompleted)
+{
+    check(Branch.LayoutVersion == LayoutVersion && Branch.bIsLeftEye == bIsLeftEye);
+
+    Swap(GetCurrentEye(), Branch.GetCurrentEye());
+    ++StateVersion;
+    if (bApplied)
+    {
+        RecordAppliedResponse(LocationId, StimulusIntensity, bSeen, bCompleted);
     }
 }
 
 // Gets the next stimulus intensity for a location (in decibels)
 float UThresholdEstimator::GetNextStimulusIntensityInDb(const FVector& Location)
 {
-    LocationEstimator* Estimator = GetOrCreateLocationEstimator(Location);
-    if (Estimator)
+    return GetNextStimulusIntensityInDbById(LocationRegistry.Find(Location));
+}
+
+float UThresholdEstimator::GetNextStimulusIntensityInDbById(int32 LocationId)
+{
+    if (!LocationRegistry.IsValidId(LocationId))
+    {
+        return (MaxThresholdInDb - MinThresholdInDb) / 2.0f;  // Return default for unknown locations
+    }
+
+    const int32 Row = GetOrCreatePosteriorRow(LocationId);
+    const FHierarchicalPosteriorStore& Posteriors = GetCurrentEye().Posteriors;
+    if (SelectionStrategy == EStimulusSelectionStrategy::MinimumExpectedEntropy)
     {
-        return Estimator->SelectNextStimulusIntensityInDb();
+        // The candidate whose response is expected to be most informative (QUEST+ style)
+        return Posteriors.SelectMinimumEntropyIntensity(Row);
     }
-    return (MaxThresholdInDb - MinThresholdInDb) / 2.0f;  // Return default if no estimator
+
+    // The next intensity is the expected threshold (mean of the distribution), within the valid range
+    const TArray<float>& Levels = Posteriors.GetThresholdLevels();
+    return FMath::Clamp(Posteriors.GetMean(Row), Levels[0], Levels.Last());
 }
 
 // Gets the next luminance for a location (in nits)
 float UThresholdEstimator::GetNextLuminanceForLocation(const FVector& Location)
 {
-    LocationEstimator* Estimator = GetOrCreateLocationEstimator(Location);
-    if (Estimator)
-    {
-        return Estimator->SelectNextLuminance();
-    }
-    return 0.0f;  // Return 0 if no estimator
+    return ConvertDbToLuminance(GetNextStimulusIntensityInDb(Location));
+}
+
+float UThresholdEstimator::GetNextLuminanceById(int32 LocationId)
+{
+    return ConvertDbToLuminance(GetNextStimulusIntensityInDbById(LocationId));
 }
 
 // Checks if threshold estimation is complete for a location
 bool UThresholdEstimator::IsThresholdEstimationComplete(const FVector& Location)
 {
-    LocationEstimator* Estimator = GetOrCreateLocationEstimator(Location);
-    if (Estimator)
+    return IsThresholdEstimationCompleteById(LocationRegistry.Find(Location));
+}
+
+bool UThresholdEstimator::IsThresholdEstimationCompleteById(int32 LocationId) const
+{
+    if (!LocationRegistry.IsValidId(LocationId))
     {
-        return Estimator->bEstimationComplete;
+        return true;
     }
-    return true;
+
+    // A location that was never presented has not started; queries leave the estimation state untouched
+    const int32 Row = FindPosteriorRow(LocationId);
+    return Row != INDEX_NONE && GetCurrentEye().Posteriors.IsComplete(Row);
 }
 
 // Gets the estimated threshold for a location (in decibels)
 float UThresholdEstimator::GetThresholdEstimateInDb(const FVector& Location)
 {
-    if (GetCurrentThresholdMap().Contains(Location))
+    return GetThresholdEstimateInDbById(LocationRegistry.Find(Location));
+}
+
+float UThresholdEstimator::GetThresholdEstimateInDbById(int32 LocationId)
+{
+    const FEyeState& Eye = GetCurrentEye();
+    if (Eye.HasThreshold.IsValidIndex(LocationId) && Eye.HasThreshold[LocationId])
     {
-        return GetCurrentThresholdMap()[Location];
+        return Eye.ThresholdsInDb[LocationId];
     }
     return 0.0f;
 }
 
+// Gets the posterior standard deviation for a location (in decibels)
+float UThresholdEstimator::GetThresholdUncertaintyInDbById(int32 LocationId) const
+{
+    if (!LocationRegistry.IsValidId(LocationId))
+    {
+        return 0.0f;
+    }
+
+    const int32 Row = FindPosteriorRow(LocationId);
+    return Row != INDEX_NONE ? GetCurrentEye().Posteriors.GetStandardDeviation(Row) : GetPriorStandardDeviation(LocationId);
+}
+
+// Gets the threshold and posterior standard deviation of a location on either eye
+bool UThresholdEstimator::GetEyeResultById(bool bLeftEye, int32 LocationId, float& OutThresholdInDb, float& OutStandardDeviationInDb) const
+{
+    const FEyeState& Eye = bLeftEye ? LeftEye : RightEye;
+    if (!Eye.HasThreshold.IsValidIndex(LocationId) || !Eye.HasThreshold[LocationId])
+    {
+        return false;
+    }
+
+    const int32 Row = Eye.RowByLocationId[LocationId];
+    OutThresholdInDb = Eye.ThresholdsInDb[LocationId];
+    OutStandardDeviationInDb = Row != INDEX_NONE ? Eye.Posteriors.GetStandardDeviation(Row) : 0.0f;
+    return true;
+}
+
+// Gets the patient-level psychometric estimates for the current eye
+float UThresholdEstimator::GetPatientSlope() const
+{
+    const FHierarchicalPosteriorStore& Posteriors = GetCurrentEye().Posteriors;
+    return Posteriors.GetNumHypotheses() > 0 ? Posteriors.GetExpectedSlope() : PsychometricParams.Slope;
+}
+
+float UThresholdEstimator::GetPatientLapseRate() const
+{
+    const FHierarchicalPosteriorStore& Posteriors = GetCurrentEye().Posteriors;
+    return Posteriors.GetNumHypotheses() > 0 ? Posteriors.GetExpectedLapseRate() : PsychometricParams.LapseRate;
+}
+
 // Calculates final thresholds after the test is complete
 void UThresholdEstimator::CalculateFinalThresholds()
 {
-    // Thresholds are already calculated and stored in FinalThresholdsInDb
+    // Locations that reached the stopping criterion already have a threshold; the rest use their posterior mean
+    FEyeState& Eye = GetCurrentEye();
+    const TArray<float>& Means = Eye.Posteriors.GetMeans();
+
+    for (int32 LocationId = 0; LocationId < Eye.RowByLocationId.Num(); ++LocationId)
+    {
+        const int32 Row = Eye.RowByLocationId[LocationId];
+        if (Row != INDEX_NONE && !Eye.Posteriors.IsComplete(Row))
+        {
+            SetThreshold(LocationId, Means[Row]);
+        }
+    }
 }
 
 // Calculates sensitivities based on the final thresholds
 void UThresholdEstimator::CalculateFinalSensitivities()
 {
-    for (const auto& Pair : GetCurrentThresholdMap())
+    FEyeState& Eye = GetCurrentEye();
+    for (TConstSetBitIterator<> It(Eye.HasThreshold); It; ++It)
     {
-        FVector Location = Pair.Key;
-        float ThresholdInDb = Pair.Value;
+        const int32 LocationId = It.GetIndex();
+        const FVector& Location = LocationRegistry.GetLocation(LocationId);
+        float ThresholdInDb = Eye.ThresholdsInDb[LocationId];
         float Sensitivity = 1.0f / ThresholdInDb;  // Sensitivity is the inverse of the threshold
-        GetCurrentSensitivityMap().Add(Location, Sensitivity);
+        Eye.SensitivityMap.Add(Location, Sensitivity);
 
-        UE_LOG(LogTemp, Warning, TEXT("Sensitivity at location %s: %f"), *Location.ToString(), Sensitivity);
+        FStructuredLog::Get().Log(EStructuredLogFormat::EstimatorSensitivity, Location, Sensitivity);
     }
 }
 
 // Gets the final thresholds (in decibels)
 const TMap<FVector, float>& UThresholdEstimator::GetFinalThresholdsInDb() const
 {
-    return bIsLeftEye ? LeftEyeThresholds : RightEyeThresholds;
+    return GetCurrentEye().ThresholdMap;
 }
 
 // Gets the final sensitivities
 const TMap<FVector, float>& UThresholdEstimator::GetFinalSensitivities() const
 {
-    return bIsLeftEye ? LeftEyeSensitivities : RightEyeSensitivities;
+    return GetCurrentEye().SensitivityMap;
 }
 
 // Records a stimulus result
@@ -153,207 +414,292 @@ void UThresholdEstimator::RecordStimulusResult(const FVector& Location, bool bSe
     FTestResults NewResult(Location, bSeen, ThresholdLevel);
     TestResultsArray.Add(NewResult);
 
-    UE_LOG(LogTemp, Warning, TEXT("Recorded result at location %s: %s at %f dB"), *Location.ToString(), bSeen ? TEXT("Seen") : TEXT("Not Seen"), ThresholdLevel);
+    FStructuredLog::Get().Log(EStructuredLogFormat::EstimatorResultRecorded, Location, bSeen, ThresholdLevel);
 }
 
 // Checks if retesting can be skipped at a location
 bool UThresholdEstimator::ShouldSkipRetest(const FVector& Location)
 {
-    int32* ConsistencyCount = ConsistencyMap.Find(Location);
-    return ConsistencyCount && *ConsistencyCount >= 3;
+    return ShouldSkipRetestById(LocationRegistry.Find(Location));
 }
 
-// Helper function to get or create a LocationEstimator for a location
-UThresholdEstimator::LocationEstimator* UThresholdEstimator::GetOrCreateLocationEstimator(const FVector& Location)
+bool UThresholdEstimator::ShouldSkipRetestById(int32 LocationId)
 {
-    if (!LocationEstimators.Contains(Location))
-    {
-        TUniquePtr<LocationEstimator> NewEstimator = MakeUnique<LocationEstimator>(this);
-        NewEstimator->Initialize();
-        LocationEstimators.Add(Location, MoveTemp(NewEstimator));
-    }
-    return LocationEstimators[Location].Get();
+    const FEyeState& Eye = GetCurrentEye();
+    return Eye.ConsistentSeenCounts.IsValidIndex(LocationId) && Eye.ConsistentSeenCounts[LocationId] >= 3;
 }
 
-// Cleans up all location estimators
-void UThresholdEstimator::CleanupEstimators()
+// Checks if every location tested on the current eye has finished, without walking the location map
+bool UThresholdEstimator::AreAllLocationsComplete() const
 {
-    LocationEstimators.Empty();
-    FinalThresholdsInDb.Empty();
-    TestResultsArray.Empty();
-    ConsistencyMap.Empty();
+    return GetCurrentEye().Posteriors.AreAllComplete();
 }
 
-// Returns the current threshold map for the active eye
-TMap<FVector, float>& UThresholdEstimator::GetCurrentThresholdMap()
+// Helper function to get or add the posterior row for a location on the current eye
+int32 UThresholdEstimator::GetOrCreatePosteriorRow(int32 LocationId)
 {
-    return bIsLeftEye ? LeftEyeThresholds : RightEyeThresholds;
-}
+    FEyeState& Eye = GetCurrentEye();
+    Eye.Grow(LocationRegistry.Num());
 
-// Returns the current sensitivity map for the active eye
-TMap<FVector, float>& UThresholdEstimator::GetCurrentSensitivityMap()
-{
-    return bIsLeftEye ? LeftEyeSensitivities : RightEyeSensitivities;
-}
+    int32& Row = Eye.RowByLocationId[LocationId];
+    if (Row == INDEX_NONE)
+    {
+        if (Eye.Posteriors.GetStride() == 0)
+        {
+            Eye.Posteriors.Initialize(GetLikelihoodTables());
+        }
+        Row = Eye.Posteriors.AddLocation();
+        ++StateVersion;
 
-///////////////////////////////////////////////////////////
-// Implementation of LocationEstimator inner class
+        // Start from this patient's previous visit where it tested the location; that result already includes
+        // the normative prior, so the database is only used elsewhere (it is stored in right-eye orientation)
+        if (Eye.VisitPriorStandardDeviations[LocationId] > 0.0f)
+        {
+            Eye.Posteriors.ApplyGaussianPrior(Row, Eye.VisitPriorMeans[LocationId], Eye.VisitPriorStandardDeviations[LocationId]);
+        }
+        else if (NormativePriors.IsValid())
+        {
+            float HorizontalDegrees = 0.0f;
+            float VerticalDegrees = 0.0f;
+            FNormativePriorDatabase::ToFieldDegrees(LocationRegistry.GetLocation(LocationId), HorizontalDegrees, VerticalDegrees);
+            FNormativePrior Prior;
+            if (NormativePriors.Find(bIsLeftEye ? -HorizontalDegrees : HorizontalDegrees, VerticalDegrees, Prior))
+            {
+                Eye.Posteriors.ApplyGaussianPrior(Row, Prior.MeanInDb, Prior.StandardDeviationInDb);
+            }
+        }
 
-// Constructor
-UThresholdEstimator::LocationEstimator::LocationEstimator(UThresholdEstimator* InParentEstimator)
-    : ParentEstimator(InParentEstimator)  // Set the pointer to the parent
-{
-    this->Slope = 3.0f;  // Use 'this->' to access non-static members
-    this->GuessRate = 0.5f;
-    this->LapseRate = 0.01f;
-    this->ConsistentResponsesCount = 0;
-    this->bEstimationComplete = false;
+        // Then from whatever finished neighbours have already said about this location
+        const float PriorPrecision = Eye.PriorPrecisions[LocationId];
+        if (PriorPrecision > 0.0f)
+        {
+            Eye.Posteriors.ApplyGaussianPrior(Row, Eye.PriorWeightedMeans[LocationId] / PriorPrecision, FMath::InvSqrt(PriorPrecision));
+        }
+    }
+    return Row;
 }
 
-// Destructor
-UThresholdEstimator::LocationEstimator::~LocationEstimator()
+// Helper function to find the posterior row for a location on the current eye, without adding one
+int32 UThresholdEstimator::FindPosteriorRow(int32 LocationId) const
 {
+    const FEyeState& Eye = GetCurrentEye();
+    return Eye.RowByLocationId.IsValidIndex(LocationId) ? Eye.RowByLocationId[LocationId] : INDEX_NONE;
 }
 
-// Initializes the estimator for a location
-void UThresholdEstimator::LocationEstimator::Initialize()
+// Approximates the standard deviation a location's posterior row would start from, combining the same priors as
+// GetOrCreatePosteriorRow as Gaussians; with no prior it is the spread of the uniform prior over the threshold grid
+float UThresholdEstimator::GetPriorStandardDeviation(int32 LocationId) const
 {
-    PossibleThresholdLevelsInDb.Empty();
-    ProbabilityDistribution.Empty();
+    const FEyeState& Eye = GetCurrentEye();
+    float Precision = Eye.PriorPrecisions.IsValidIndex(LocationId) ? Eye.PriorPrecisions[LocationId] : 0.0f;
+
+    const float VisitDeviation = Eye.VisitPriorStandardDeviations.IsValidIndex(LocationId) ? Eye.VisitPriorStandardDeviations[LocationId] : 0.0f;
+    if (VisitDeviation > 0.0f)
+    {
+        Precision += 1.0f / FMath::Square(VisitDeviation);
+    }
+    else if (NormativePriors.IsValid())
+    {
+        float HorizontalDegrees = 0.0f;
+        float VerticalDegrees = 0.0f;
+        FNormativePriorDatabase::ToFieldDegrees(LocationRegistry.GetLocation(LocationId), HorizontalDegrees, VerticalDegrees);
+        FNormativePrior Prior;
+        if (NormativePriors.Find(bIsLeftEye ? -HorizontalDegrees : HorizontalDegrees, VerticalDegrees, Prior) && Prior.StandardDeviationInDb > 0.0f)
+        {
+            Precision += 1.0f / FMath::Square(Prior.StandardDeviationInDb);
+        }
+    }
 
-    for (float Level = ParentEstimator->MinThresholdInDb; Level <= ParentEstimator->MaxThresholdInDb; Level += ParentEstimator->ThresholdStepSizeInDb)
+    if (Precision > 0.0f)
     {
-        PossibleThresholdLevelsInDb.Add(Level);
-        ProbabilityDistribution.Add(1.0f); // Uniform prior
+        return FMath::InvSqrt(Precision);
     }
 
-    NormalizeProbabilityDistribution();
+    const FHierarchicalPosteriorStore& Posteriors = Eye.Posteriors;
+    if (Posteriors.GetNumThresholds() == 0)
+    {
+        return TNumericLimits<float>::Max();
+    }
+    const TArray<float>& Levels = Posteriors.GetThresholdLevels();
+    return (Levels.Last() - Levels[0]) / FMath::Sqrt(12.0f);
 }
 
-// Normalizes the probability distribution
-void UThresholdEstimator::LocationEstimator::NormalizeProbabilityDistribution()
+// Seeds unpresented neighbours and tightens unfinished ones around a finished location's threshold
+void UThresholdEstimator::PropagateToNeighbors(int32 LocationId, float ThresholdInDb)
 {
-    float Sum = 0.0f;
-
-    // Accumulate sum of probabilities
-    for (float Prob : ProbabilityDistribution)
+    if (!bUseSpatialPriors)
     {
-        Sum += Prob;
+        return;
     }
 
-    // Normalize if the sum is positive
-    if (Sum > 0.0f)
+    FEyeState& Eye = GetCurrentEye();
+    const float FullPrecision = 1.0f / FMath::Square(FMath::Max(SpatialPriorStandardDeviationInDb, KINDA_SMALL_NUMBER));
+    const TArrayView<const int32> Neighbors = NeighborGraph.GetNeighbors(LocationId);
+    const TArrayView<const float> Weights = NeighborGraph.GetWeights(LocationId);
+    for (int32 i = 0; i < Neighbors.Num(); ++i)
     {
-        const float InvSum = 1.0f / Sum;
-        for (float& Prob : ProbabilityDistribution)
+        const int32 NeighborId = Neighbors[i];
+        const float Precision = Weights[i] * FullPrecision;
+        if (Precision <= 0.0f)
+        {
+            continue;
+        }
+
+        const int32 Row = Eye.RowByLocationId[NeighborId];
+        if (Row == INDEX_NONE)
         {
-            Prob *= InvSum;
+            // Not presented yet on this eye; applied when its row is created
+            Eye.PriorPrecisions[NeighborId] += Precision;
+            Eye.PriorWeightedMeans[NeighborId] += Precision * ThresholdInDb;
+        }
+        else if (!Eye.Posteriors.IsComplete(Row))
+        {
+            Eye.Posteriors.ApplyGaussianPrior(Row, ThresholdInDb, FMath::InvSqrt(Precision));
         }
     }
-    else
+}
+
+// Resolves previous-visit priors by location ID so creating a posterior row costs no lookup
+void UThresholdEstimator::ResolvePreviousVisitPriors(FEyeState& Eye, bool bLeftEye, int32 FirstLocationId)
+{
+    if (!PreviousVisit.IsValid())
     {
-        // If all probabilities are zero, reset to a uniform distribution
-        const float UniformProb = 1.0f / ProbabilityDistribution.Num();
-        for (float& Prob : ProbabilityDistribution)
+        return;
+    }
+
+    // Widen the previous posterior by the expected drift, but never below one grid step
+    const float DriftVariance = FMath::Square(PreviousVisitDriftInDb);
+    for (int32 LocationId = FirstLocationId; LocationId < LocationRegistry.Num(); ++LocationId)
+    {
+        float HorizontalDegrees = 0.0f;
+        float VerticalDegrees = 0.0f;
+        FNormativePriorDatabase::ToFieldDegrees(LocationRegistry.GetLocation(LocationId), HorizontalDegrees, VerticalDegrees);
+
+        float MeanInDb = 0.0f;
+        float StandardDeviationInDb = 0.0f;
+        if (PreviousVisit.Find(bLeftEye, HorizontalDegrees, VerticalDegrees, MeanInDb, StandardDeviationInDb))
         {
-            Prob = UniformProb;
+            Eye.VisitPriorMeans[LocationId] = MeanInDb;
+            Eye.VisitPriorStandardDeviations[LocationId] = FMath::Max(FMath::Sqrt(FMath::Square(StandardDeviationInDb) + DriftVariance), ThresholdStepSizeInDb);
         }
     }
 }
 
-// Psychometric function (cumulative Gaussian)
-float UThresholdEstimator::LocationEstimator::PsychometricFunction(float StimulusIntensity, float ThresholdLevel)
+// Sets the threshold of a location for the current eye and mirrors it into the location-keyed results
+void UThresholdEstimator::SetThreshold(int32 LocationId, float ThresholdInDb)
 {
-    float Probability = GuessRate + (1.0f - GuessRate - LapseRate) * 0.5f * (1.0f + std::erf((StimulusIntensity - ThresholdLevel) / (Slope * FMath::Sqrt(2.0f))));
-    return Probability;
+    FEyeState& Eye = GetCurrentEye();
+    ++StateVersion;
+    Eye.ThresholdsInDb[LocationId] = ThresholdInDb;
+    Eye.HasThreshold[LocationId] = true;
+    Eye.ThresholdMap.Add(LocationRegistry.GetLocation(LocationId), ThresholdInDb);
 }
 
-// Updates the probability distribution based on user response
-void UThresholdEstimator::LocationEstimator::UpdateProbabilityDistribution(float StimulusIntensity, bool bSeen)
+// Returns the likelihood tables for the current parameters, shared with every other estimator using them
+const TArray<TSharedRef<const FPsychometricTable>>& UThresholdEstimator::GetLikelihoodTables()
 {
-    for (int32 i = 0; i < PossibleThresholdLevelsInDb.Num(); ++i)
-    {
-        float ThresholdLevel = PossibleThresholdLevelsInDb[i];
-        float ProbabilityOfSeeing = PsychometricFunction(StimulusIntensity, ThresholdLevel);
-
-        // Likelihood of the response given the threshold level
-        float Likelihood = bSeen ? ProbabilityOfSeeing : (1.0f - ProbabilityOfSeeing);
+    PsychometricParams.MinThresholdInDb = MinThresholdInDb;
+    PsychometricParams.MaxThresholdInDb = MaxThresholdInDb;
+    PsychometricParams.ThresholdStepSizeInDb = ThresholdStepSizeInDb;
 
-        // Update the probability
-        ProbabilityDistribution[i] *= Likelihood;
+    // One hypothesis per slope and lapse rate pair, or just the fixed parameters
+    TArray<FPsychometricParams> HypothesisParams;
+    if (bEstimatePatientPsychometrics && PatientSlopeHypotheses.Num() > 0 && PatientLapseRateHypotheses.Num() > 0)
+    {
+        for (const float Slope : PatientSlopeHypotheses)
+        {
+            for (const float LapseRate : PatientLapseRateHypotheses)
+            {
+                FPsychometricParams& Params = HypothesisParams.Add_GetRef(PsychometricParams);
+                Params.Slope = Slope;
+                Params.LapseRate = LapseRate;
+            }
+        }
     }
-
-    // Normalize the updated probability distribution
-    NormalizeProbabilityDistribution();
-
-    // Debugging: Log the updated probability distribution for analysis
-    FString ProbabilityLog = "Updated Probability Distribution: ";
-    for (int32 i = 0; i < ProbabilityDistribution.Num(); ++i)
+    else
     {
-        ProbabilityLog += FString::Printf(TEXT("[%f dB: %f] "), PossibleThresholdLevelsInDb[i], ProbabilityDistribution[i]);
+        HypothesisParams.Add(PsychometricParams);
     }
 
-    UE_LOG(LogTemp, Warning, TEXT("LocationEstimator - %s - Probability distribution after response: %s"), *ParentEstimator->GetName(), *ProbabilityLog);
-}
+    bool bUpToDate = LikelihoodTables.Num() == HypothesisParams.Num();
+    for (int32 Hypothesis = 0; bUpToDate && Hypothesis < HypothesisParams.Num(); ++Hypothesis)
+    {
+        bUpToDate = LikelihoodTables[Hypothesis]->GetParams() == HypothesisParams[Hypothesis];
+    }
 
-// Selects the next stimulus intensity to present (in dB)
-float UThresholdEstimator::LocationEstimator::SelectNextStimulusIntensityInDb()
-{
-    // Calculate the expected threshold (mean of the distribution)
-    float ExpectedThresholdInDb = 0.0f;
-    for (int32 i = 0; i < PossibleThresholdLevelsInDb.Num(); ++i)
+    if (!bUpToDate)
     {
-        ExpectedThresholdInDb += PossibleThresholdLevelsInDb[i] * ProbabilityDistribution[i];
+        LikelihoodTables.Reset();
+        for (const FPsychometricParams& Params : HypothesisParams)
+        {
+            LikelihoodTables.Add(FPsychometricTable::GetOrCreate(Params));
+        }
     }
+    return LikelihoodTables;
+}
 
-    // Ensure the intensity is within the valid range
-    ExpectedThresholdInDb = FMath::Clamp(ExpectedThresholdInDb, PossibleThresholdLevelsInDb[0], PossibleThresholdLevelsInDb.Last());
+// Cleans up all location estimators
+void UThresholdEstimator::CleanupEstimators()
+{
+    // Only the current eye's state is reset; the other eye's results stay available
+    GetCurrentEye().Reset(LocationRegistry.Num());
+    TestResultsArray.Empty();
+}
 
-    return ExpectedThresholdInDb;
+// Returns the state of the active eye
+UThresholdEstimator::FEyeState& UThresholdEstimator::GetCurrentEye()
+{
+    return bIsLeftEye ? LeftEye : RightEye;
 }
 
-// Selects the next luminance (in nits) based on the selected dB value
-float UThresholdEstimator::LocationEstimator::SelectNextLuminance()
+const UThresholdEstimator::FEyeState& UThresholdEstimator::GetCurrentEye() const
 {
-    float SelectedThresholdInDb = SelectNextStimulusIntensityInDb();
-    return ConvertDbToLuminance(SelectedThresholdInDb);
+    return bIsLeftEye ? LeftEye : RightEye;
 }
 
 // Helper function to convert dB to luminance (nits)
-float UThresholdEstimator::LocationEstimator::ConvertDbToLuminance(float dBValue)
+float UThresholdEstimator::ConvertDbToLuminance(float dBValue)
 {
     float MaxLuminanceInNits = 60.0f;  // Maximum luminance of the Pico 4 display
     float Luminance = MaxLuminanceInNits * FMath::Pow(10.0f, -dBValue / 10.0f);
     return Luminance;
 }
 
-// Checks if threshold estimation is complete for this location
-bool UThresholdEstimator::LocationEstimator::IsThresholdEstimationComplete(float StoppingCriterionValue)
-{
-    // Calculate the standard deviation of the probability distribution
-    float Mean = 0.0f;
-    float MeanSquare = 0.0f;
-    for (int32 i = 0; i < PossibleThresholdLevelsInDb.Num(); ++i)
-    {
-        float Level = PossibleThresholdLevelsInDb[i];
-        float Prob = ProbabilityDistribution[i];
-        Mean += Level * Prob;
-        MeanSquare += Level * Level * Prob;
-    }
-    float Variance = MeanSquare - Mean * Mean;
-    float StandardDeviation = FMath::Sqrt(FMath::Max(Variance, 0.0f));
+///////////////////////////////////////////////////////////
+// Implementation of FEyeState
 
-    // Check if standard deviation is below the stopping criterion
-    return StandardDeviation <= StoppingCriterionValue;
+void UThresholdEstimator::FEyeState::Reset(int32 NumLocations)
+{
+    Posteriors.Reset();
+    RowByLocationId.Reset();
+    ThresholdsInDb.Reset();
+    HasThreshold.Reset();
+    ConsistentSeenCounts.Reset();
+    PriorPrecisions.Reset();
+    PriorWeightedMeans.Reset();
+    VisitPriorMeans.Reset();
+    VisitPriorStandardDeviations.Reset();
+    ThresholdMap.Reset();
+    SensitivityMap.Reset();
+    Grow(NumLocations);
 }
 
-// Gets the estimated threshold for this location (in decibels)
-float UThresholdEstimator::LocationEstimator::GetThresholdEstimateInDb()
+void UThresholdEstimator::FEyeState::Grow(int32 NumLocations)
 {
-    float EstimatedThresholdInDb = 0.0f;
-    for (int32 i = 0; i < PossibleThresholdLevelsInDb.Num(); ++i)
+    const int32 NumToAdd = NumLocations - RowByLocationId.Num();
+    if (NumToAdd > 0)
     {
-        EstimatedThresholdInDb += PossibleThresholdLevelsInDb[i] * ProbabilityDistribution[i];
+        RowByLocationId.Reserve(NumLocations);
+        for (int32 i = 0; i < NumToAdd; ++i)
+        {
+            RowByLocationId.Add(INDEX_NONE);
+        }
+        ThresholdsInDb.AddZeroed(NumToAdd);
+        HasThreshold.Add(false, NumToAdd);
+        ConsistentSeenCounts.AddZeroed(NumToAdd);
+        PriorPrecisions.AddZeroed(NumToAdd);
+        PriorWeightedMeans.AddZeroed(NumToAdd);
+        VisitPriorMeans.AddZeroed(NumToAdd);
+        VisitPriorStandardDeviations.AddZeroed(NumToAdd);
     }
-    return EstimatedThresholdInDb;
-}
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "FLogManager.h"
 #include "AFixationPoint.generated.h"
 
 UCLASS()
@@ -20,9 +21,6 @@ protected:
 	virtual void BeginPlay() override;
 
 public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	// Function to set the scale of the fixation point
 	void SetScale(float Radius);
 
@@ -30,6 +28,9 @@ private:
 	UPROPERTY(VisibleAnywhere)
 	UStaticMeshComponent* MeshComponent;
 
+	// Log handle for this actor's category
+	FLogManager LogManager{ TEXT("FixationPoint") };
+
 	UPROPERTY(EditAnywhere)
 	float DistanceFromPlayer = 100.0f; // Distance in front of the player
 
@@ -21,9 +21,6 @@ protected:
     virtual void BeginPlay() override;
 
 public:
-    // Called every frame
-    virtual void Tick(float DeltaTime) override;
-
     // Function to set the scale of the visual stimulus
     void SetScale(float DesiredDiameter);
 
@@ -55,7 +52,7 @@ private:
     UPROPERTY(EditDefaultsOnly, Category = "Stimulus Settings")
     float MaxBrightness;
 
-    // Instance of FLogManager to call in this class, ensures initiation of GEngine
-    FLogManager LogManager;
+    // Log handle for the stimulus category; constructing it does not touch the filesystem
+    FLogManager LogManager{ TEXT("Stimuli") };
     FString LogMessage;
 };
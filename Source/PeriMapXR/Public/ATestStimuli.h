@@ -3,16 +3,22 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "PXR_MotionTracking.h"
 #include "GameFramework/Actor.h"
 #include "ABackgroundSphere.h"
 #include "AFixationPoint.h"
-#include "AStimuli.h"
+#include "UStimulusFieldComponent.h"
 #include "ETestState.h"
 #include "ETestType.h"
 #include "FTestSettings.h"
 #include "FTestResults.h"
 #include "FLogManager.h"
+#include "FTrialScheduler.h"
+#include "FSpeculativeTrialPlanner.h"
+#include "FStimulusPresentationScheduler.h"
+#include "FEyeSampleRing.h"
+#include "FGazeFilter.h"
+#include "FGazeEventClassifier.h"
+#include "FSessionRecording.h"
 #include "UThresholdEstimator.h"
 #include "ATestStimuli.generated.h"
 
@@ -29,7 +35,7 @@ protected:
     // Called once when the actor is first initialized, used to start the test and configure settings
     virtual void BeginPlay() override;
 
-    // Called every frame to update actors like the fixation point
+    // Called every frame to monitor frame latency; positioning is handled by the head-locked rig
     virtual void Tick(float DeltaTime) override;
 
     // Setup and Initialization
@@ -58,13 +64,13 @@ protected:
     /** Flashes a stimulus at a given index and records user interaction with the stimulus. */
     void FlashStimuli(int32 StimulusIndex, float StimulusIntensityInDb);
 
-    /** Update stimuli positions, used when the user moves their head position. */
-    void UpdateStimuliPositions();
+    /** Shows and hides the presented stimulus on frame boundaries, and starts the response handler once it is down. */
+    void AdvancePresentation();
 
-    /** Compares the current position of the fixation actor to the last stored position. */
-    bool FixationActorMoved() const;
+    /** Attaches a spawned actor to the head-locked rig at a location relative to the camera and disables its tick. */
+    void AttachToHeadLockedRig(AActor* Actor, const FVector& RelativeLocation);
 
-    /** Destroys any leftover stimuli actors and cleans up. */
+    /** Removes every stimulus from the stimulus field. */
     void CleanupStimuli();
 
     // Response and Data Management
@@ -90,13 +96,16 @@ protected:
     /** Checks if the user's gaze is focused on the fixation point and manages test state accordingly. */
     bool CheckGazeFocus();
 
+    /** Feeds every eye sample published since the last call to the gaze filter and the saccade classifier. */
+    void UpdateGazeStream();
+
     /** Adjusts the timing between stimuli based on the user's consistency in responding to stimuli. */
     void AdjustTimingBasedOnResponses();
 
-    /** Function to add data to the buffer and keep it within the BufferSize limit. */
-    void AddEyeTrackingDataToBuffer(const FPXREyeTrackingData& NewData);
+    /** Function to feed one tracker sample to the gaze filter, at constant cost per sample. */
+    void AddEyeTrackingDataToBuffer(const FEyeTrackingSample& NewData);
 
-    /** Function to compute a smoothed gaze direction by averaging the buffered data. */
+    /** Function to return the filtered gaze direction of the tested eye. */
     FVector GetSmoothedGazeDirection();
 
     /** Function to predict the user's gaze based on the angular velocity. */
@@ -105,6 +114,16 @@ protected:
     /** Function to interpolate gaze direction when data is delayed or unavailable. */
     FVector InterpolateGazeDirection(float DeltaTime, float InterpolationSpeed);
 
+    // Session recording and replay
+    /** Returns the HMD pose, from the headset or, when a session is replayed, from the recording. */
+    FHeadPoseSample GetHeadPose() const;
+
+    /** Adds this frame's timing and head pose to the session recording, if one is in progress. */
+    void RecordFrame(float DeltaTime);
+
+    /** Presses the detection button for every replayed press that is now due. */
+    void DispatchReplayedInputs();
+
     // Utility Methods
     /** Switches the eye being tested (left/right), resetting relevant data for the new test. */
     void SwitchEye();
@@ -125,9 +144,16 @@ protected:
     UPROPERTY(EditAnywhere, Category = "References")
     TSubclassOf<AActor> PICOXRPawnClass;
 
-    /** The class of the stimuli actors to spawn at various positions around the player. */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stimuli")
-    TSubclassOf<AStimuli> StimuliActorClass;
+    /** Scene root attached to the player's camera; the fixation point, background and stimuli hang off it and follow the head without ticking. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimuli")
+    USceneComponent* HeadLockedRig;
+
+    /** Draws every stimulus of the pattern as one instance of a single instanced mesh, placed at the fixation point. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimuli")
+    UStimulusFieldComponent* StimulusField;
+
+    /** Distance of the fixation point in front of the camera, in cm. */
+    static constexpr float FixationDistance = 30.0f;
 
     /** The class of the fixation point actor that appears at a fixed distance from the player. */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fixation")
@@ -151,23 +177,57 @@ protected:
     /** Holds the value of the HMD refresh rate to sync with eye tracking. */
     float RefreshRate;
 
-    /** Buffer for storing the last few frames of eye-tracking data. */
-    TArray<FPXREyeTrackingData> EyeTrackingDataBuffer;
+    /** Smooths the tested eye's gaze direction, updated once per tracker sample in O(1). */
+    FGazeFilter GazeFilter;
+
+    /** Most recent tracker sample, used for prediction and interpolation when no fresh data arrives. */
+    FEyeTrackingSample LatestGazeSample;
+
+    /** Whether LatestGazeSample holds a sample taken since eye tracking started or the eye was switched. */
+    bool bHasGazeSample = false;
+
+    /** Filter applied to the gaze stream before the fixation check. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eye Tracking")
+    EGazeFilterType GazeFilterType;
+
+    /** Number of tracker samples averaged by the moving-average filter. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eye Tracking", meta = (ClampMin = "1"))
+    int32 GazeFilterWindowSamples;
+
+    /** One Euro filter: cutoff frequency while the eye is still, in Hz. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eye Tracking")
+    float GazeFilterMinCutoffHz;
+
+    /** One Euro filter: how fast the cutoff rises with gaze speed (Hz per rad/s). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eye Tracking")
+    float GazeFilterBeta;
+
+    /** Exponential filter: time constant, in seconds. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eye Tracking")
+    float GazeFilterTimeConstant;
 
-	/** Size of the buffer for storing eye-tracking data frames. */
-    const int32 BufferSize = 5;
+    /** Labels the gaze stream as fixations, saccades and blinks; trials overlapping a saccade or blink are rejected. */
+    FGazeEventClassifier GazeClassifier;
 
-    /** Array of supported eye tracking modes on the device, populated during initialization. */
-    TArray<EPXREyeTrackingMode> SupportedModes;
+    /** Angular velocity above which the gaze classifier labels a sample as part of a saccade, in degrees per second. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eye Tracking")
+    float SaccadeVelocityThreshold;
 
-    /** Tracks the state of the eye tracker, used to detect if eye tracking is paused or disabled. */
-    FPXREyeTrackingState TrackingState;
+    /** How long gaze must stay off the fixation point before the test pauses, in seconds; shorter excursions only reject the trial they overlap. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eye Tracking")
+    float FixationLossPauseSeconds;
 
-    /** Holds the eye tracking data retrieved from the device, including gaze position and orientation. */
-    FPXREyeTrackingData EyeTrackingData;
+    /** Host time at which gaze last left the fixation point, or negative while it is on it. */
+    double FixationLostSince = -1.0;
 
-    /** Configuration for retrieving eye tracking data, including whether to query position and orientation. */
-    FPXREyeTrackingDataGetInfo GetInfo;
+    /** This test's cursor into the shared eye-tracking service; samples arrive at the tracker's rate, independent of the gaze check. */
+    FEyeTrackingReader GazeReader;
+
+    /** Samples drained from GazeReader by the latest gaze check, kept to reuse the allocation. */
+    TArray<FEyeTrackingSample> NewGazeSamples;
+
+    /** Oldest gaze sample, in seconds, that still counts when a check finds no new samples. */
+    static constexpr double MaxGazeSampleAgeSeconds = 0.25;
 
     // Test Configuration
     /** The current test type (e.g., 10-2 or 24-2), which determines the stimuli arrangement and behavior. */
@@ -178,6 +238,22 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Test Settings")
     TMap<ETestType, FTestSettings> TestSettingsMap;
 
+    /** How the threshold estimator chooses the intensity of each presentation. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Test Settings")
+    EStimulusSelectionStrategy StimulusSelectionStrategy;
+
+    /** The patient's age in years, used to pick age-matched normative priors (0 if unknown). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Test Settings")
+    int32 PatientAgeYears;
+
+    /** Results file of the patient's previous visual field, used to seed the estimator; asked of the game instance if left empty. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Test Settings")
+    FString PreviousVisitResultsFile;
+
+    /** Where this session's results are written; a new file per session, so a later visit can read it back. */
+    UPROPERTY(BlueprintReadOnly, Category = "Test Settings")
+    FString ResultsFilePath;
+
     // Timing and Randomization
     /** The duration (in seconds) that each stimulus is visible to the user. */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Timing")
@@ -187,6 +263,18 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Timing")
     float TimeBetweenStimuli;
 
+    /** Works out the next trial for both possible responses while a stimulus is showing, so responses are handled without estimator work. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Timing")
+    bool bSpeculateNextTrial;
+
+    /** Refresh rate of the headset display, in Hz; stimulus durations are rounded to whole frames at this rate. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Timing")
+    float DisplayRefreshRateHz;
+
+    /** How far (in frames) a stimulus's measured on-screen time may be from the requested time before the trial is flagged. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Timing")
+    float PresentationToleranceFrames;
+
     /** The number of times a stimulus may be retested if uncertainty is detected. */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Randomization")
     int32 RetestCount;
@@ -195,6 +283,32 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Randomization")
     float RetestProbability;
 
+    /** Minimum visual angle (in degrees) between two consecutive stimulus locations. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Randomization")
+    float MinStimulusSeparationDegrees;
+
+    /** The probability that a trial is a catch trial with no stimulus, used to detect false positives. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Randomization")
+    float CatchTrialProbability;
+
+    /** The maximum number of presentations at one location before it is retired without meeting the stopping rule. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Randomization")
+    int32 MaxPresentationsPerLocation;
+
+    /** How often a location is retested after a trial rejected for a saccade or blink; after that such trials are scored and flagged. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Randomization")
+    int32 MaxRejectionsPerLocation;
+
+    /** Seed of the presentation order; 0 draws a new one for each eye. Seeds are recorded with the session and reused on replay. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Randomization")
+    int32 RandomSeed;
+
+    /** Tests started so far; the index of the next seed taken from a replayed session. */
+    int32 TestsStarted = 0;
+
+    /** Index of the next replayed button press to dispatch. */
+    int32 NextReplayedInput = 0;
+
     // Settings for message toggling
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug Settings")
     bool bEnableConsoleMessages;
@@ -224,15 +338,33 @@ protected:
     /** Array of locations for each stimulus, stored in cartesian coordinates. */
     TArray<FVector> StimuliLocations;
 
+    /** Threshold estimator location ID for each entry in StimuliLocations, assigned once per setup. */
+    TArray<int32> StimuliLocationIds;
+
     /** Array of recorded results for each stimulus presentation. */
     TArray<FTestResults> TestResultsArray;
 
-    /** Array of active stimuli actors, stored so they can be destroyed when necessary. */
-    TArray<AStimuli*> StimuliActors;
-
     /** Index of the currently active stimulus in the test sequence. */
     int32 CurrentStimulusIndex;
 
+    /** Picks the next location by posterior uncertainty, interleaving presentations until every location is finished. */
+    FTrialScheduler TrialScheduler;
+
+    /** Computes the next trial on worker tasks during each presentation; committed when the response arrives. */
+    FSpeculativeTrialPlanner TrialPlanner;
+
+    /** The trial committed by TrialPlanner, presented by the next RunTest instead of asking the scheduler again. */
+    FPlannedTrial PlannedTrial;
+
+    /** Puts each stimulus up and takes it down on display frame boundaries, measuring how long it was actually shown. */
+    FStimulusPresentationScheduler PresentationScheduler;
+
+    /** Response handler for the trial being presented, started when its stimulus comes down. */
+    FTimerDelegate StimulusResponseDelegate;
+
+    /** Time from the start of the presentation until the response is checked, in seconds. */
+    float StimulusResponseWindow;
+
     /** Count of how many times the user has provided consistent responses in a row. */
     int32 ConsistentResponsesCount;
 
@@ -285,11 +417,8 @@ protected:
     /** Stores the latency value, initialized to 0. */
     float DetectedLatency;
 
-    /** Stores the last known position of the FixationActor. */
-    FVector LastFixationPosition;
-
-    /** Instance of FLogManager to call in this class, ensures ini */
-    FLogManager LogManager;
+    /** Log handle for this actor's category; files are owned by the shared log service. */
+    FLogManager LogManager{ TEXT("TestStimuli") };
 
     // Timing Constants
     const float MinStimuliDuration = 0.2f;  // Fixed stimulus duration
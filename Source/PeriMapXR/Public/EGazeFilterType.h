@@ -0,0 +1,14 @@
+// EGazeFilterType.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// How FGazeFilter smooths the gaze stream before the fixation check
+UENUM(BlueprintType)
+enum class EGazeFilterType : uint8
+{
+    MovingAverage UMETA(DisplayName = "Moving Average"),
+    OneEuro UMETA(DisplayName = "One Euro"),
+    Exponential UMETA(DisplayName = "Exponential")
+};
@@ -0,0 +1,13 @@
+// EStimulusSelectionStrategy.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// How UThresholdEstimator picks the next intensity to present at a location
+UENUM(BlueprintType)
+enum class EStimulusSelectionStrategy : uint8
+{
+    PosteriorMean UMETA(DisplayName = "Posterior Mean"),
+    MinimumExpectedEntropy UMETA(DisplayName = "Minimum Expected Entropy")
+};
\ No newline at end of file
@@ -4,8 +4,11 @@
 
 #include "CoreMinimal.h"
 
+// Values also index FTestPatternLibrary and the pattern table of the normative prior database, so new types are appended
 UENUM(BlueprintType)
 enum class ETestType : uint8 {
     TEST_10_2 UMETA(DisplayName = "10-2 Test"),
-    TEST_24_2 UMETA(DisplayName = "24-2 Test")
+    TEST_24_2 UMETA(DisplayName = "24-2 Test"),
+    TEST_30_2 UMETA(DisplayName = "30-2 Test"),
+    TEST_60_4 UMETA(DisplayName = "60-4 Test")
 };
\ No newline at end of file
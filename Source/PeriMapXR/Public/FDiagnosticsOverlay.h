@@ -0,0 +1,76 @@
+// FDiagnosticsOverlay.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Logging/LogVerbosity.h"
+
+/**
+ * Rate-limited on-screen diagnostics.
+ * Messages are aggregated into a fixed number of slots keyed by category, verbosity and the message text
+ * with its numbers ignored, so "Stimulus 3 spawned at X=..." and "Stimulus 4 spawned at X=..." share a slot.
+ * Each slot keeps a count and the latest message. The screen is refreshed from the core ticker at
+ * UpdateRateHz, and each slot reuses a stable on-screen message key so lines are replaced, not appended.
+ * Reporting copies the message into storage that is reused between updates; strings and Slate work only
+ * happen on the throttled flush.
+ */
+class PERIMAPXR_API FDiagnosticsOverlay
+{
+public:
+    FDiagnosticsOverlay(float InUpdateRateHz = 4.0f, int32 InMaxSlots = 32);
+    ~FDiagnosticsOverlay();
+
+    // Records a message; it reaches the screen on the next flush
+    void Report(FName Category, ELogVerbosity::Type Verbosity, const FString& Message, float DisplayTime);
+
+    // Pushes changed slots to the screen and frees slots whose display time has run out
+    void Flush();
+
+    // Clears every slot and the overflow count
+    void Reset();
+
+    // Number of slots currently holding a message
+    int32 GetActiveSlotCount() const;
+
+private:
+    struct FSlot
+    {
+        uint32 Key = 0;
+        FName Category;
+        ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+        FString LatestMessage;
+        int32 Count = 0;
+        float DisplayTime = 0.0f;
+        double LastReportTime = 0.0;
+        bool bInUse = false;
+        bool bDirty = false;
+    };
+
+    // Hashes category, verbosity and message text while skipping numbers, so changing values share a key
+    static uint32 MakeKey(FName Category, ELogVerbosity::Type Verbosity, const FString& Message);
+
+    // Colour used for each verbosity, matching the previous direct on-screen messages
+    static FColor GetColor(ELogVerbosity::Type Verbosity);
+
+    // Ticker callback, called at UpdateRateHz
+    bool Tick(float DeltaTime);
+
+    // Base for the on-screen message keys owned by the overlay; slot N uses base + N, the overflow line base + MaxSlots
+    static constexpr uint64 MessageKeyBase = 0x504D5800;
+
+    int32 MaxSlots;
+
+    mutable FCriticalSection Lock;
+    TArray<FSlot> Slots;
+    TMap<uint32, int32> SlotIndexByKey;
+
+    // Messages that arrived while every slot was busy, shown as one summary line
+    int32 OverflowCount;
+    bool bOverflowDirty;
+
+    // Reused when formatting lines on flush
+    FString Line;
+
+    FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,93 @@
+// FGazeEventClassifier.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Label FGazeEventClassifier gives each stretch of the gaze stream
+enum class EGazeEventType : uint8
+{
+    Fixation,
+    Saccade,
+    Blink
+};
+
+// One fixation, saccade or blink, on the host timeline of the eye samples
+struct PERIMAPXR_API FGazeEvent
+{
+    EGazeEventType Type = EGazeEventType::Fixation;
+    double StartSeconds = 0.0;
+    double EndSeconds = 0.0;
+
+    // Highest angular velocity seen during the event, in degrees per second
+    float PeakVelocity = 0.0f;
+};
+
+// Thresholds for FGazeEventClassifier
+struct PERIMAPXR_API FGazeClassifierSettings
+{
+    // Angular velocity above which a sample belongs to a saccade, in degrees per second
+    float SaccadeVelocityThreshold = 30.0f;
+
+    // Longest interval between samples before the gap itself counts as a blink (tracking lost)
+    float MaxSampleGapSeconds = 0.1f;
+
+    // Saccades and blinks remembered for window queries; the oldest are forgotten first
+    int32 MaxStoredEvents = 64;
+};
+
+/**
+ * Streaming velocity-threshold (I-VT) classifier over the gaze stream.
+ * Each sample is labelled from the angular velocity since the previous open-eye sample: above the threshold it
+ * is part of a saccade, below it part of a fixation, and samples with the eye closed or its pose lost are part
+ * of a blink, as is any gap longer than MaxSampleGapSeconds. Consecutive samples with the same label form one
+ * event. Saccades and blinks are kept in a small ring, so asking whether one overlapped a time window (such as
+ * a stimulus presentation) only looks at the last few events. Every update is O(1).
+ */
+class PERIMAPXR_API FGazeEventClassifier
+{
+public:
+    FGazeEventClassifier();
+
+    // Sets the thresholds and clears all state
+    void Configure(const FGazeClassifierSettings& InSettings);
+
+    // Forgets every sample and event, keeping the settings
+    void Reset();
+
+    // Labels one sample; bEyeOpen is false while the lid is closed or the tracker has no valid pose
+    EGazeEventType Update(const FVector& Direction, bool bEyeOpen, double TimeSeconds);
+
+    // The event the latest sample belongs to, which is still open
+    const FGazeEvent& GetCurrentEvent() const { return Current; }
+    EGazeEventType GetCurrentType() const { return Current.Type; }
+
+    // Finds the earliest saccade or blink that overlaps [StartSeconds, EndSeconds], including one still in progress
+    bool FindEventInWindow(double StartSeconds, double EndSeconds, FGazeEvent& OutEvent) const;
+
+    // Saccades and blinks since the last reset
+    int32 GetNumSaccades() const { return NumSaccades; }
+    int32 GetNumBlinks() const { return NumBlinks; }
+
+private:
+    // Closes the current event (storing it if it was a saccade or blink) and opens a new one
+    void BeginEvent(EGazeEventType Type, double StartSeconds);
+
+    FGazeClassifierSettings Settings;
+
+    FGazeEvent Current;
+    bool bHasSample;
+    double LastSampleTime;
+
+    // Last sample with the eye open, the reference for the next velocity
+    FVector LastOpenDirection;
+    double LastOpenTime;
+    bool bHasOpenSample;
+
+    // Ring of closed saccades and blinks, oldest at RecentHead once full
+    TArray<FGazeEvent> RecentEvents;
+    int32 RecentHead;
+
+    int32 NumSaccades;
+    int32 NumBlinks;
+};
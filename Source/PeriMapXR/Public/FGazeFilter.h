@@ -0,0 +1,100 @@
+// FGazeFilter.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EGazeFilterType.h"
+
+/**
+ * Fixed-capacity ring of gaze directions with a running sum.
+ * Adding a sample overwrites the oldest slot and adjusts the sum, so the mean of the window costs O(1) however
+ * large the window or fast the tracker. Invalid samples (lost pose, blinks) still take a slot, so they age out
+ * of the window like any other, but add nothing to the sum. The sum is rebuilt from the slots every few
+ * thousand samples to keep rounding from accumulating over long sessions.
+ */
+class PERIMAPXR_API FGazeRingBuffer
+{
+public:
+    // Empties the ring and sets its capacity
+    void Reset(int32 InCapacity);
+
+    // Adds a sample, dropping the oldest once the ring is full
+    void Add(const FVector& Direction, bool bValid);
+
+    // Number of samples in the ring, and how many of them are valid
+    int32 Num() const { return Count; }
+    int32 NumValid() const { return ValidCount; }
+
+    // Mean of the valid directions, or zero if there are none
+    FVector GetMean() const { return ValidCount > 0 ? Sum / ValidCount : FVector::ZeroVector; }
+
+private:
+    // Recomputes the sum and valid count from the slots
+    void Rebuild();
+
+    TArray<FVector> Directions;
+    TArray<bool> ValidFlags;
+    int32 Head = 0;
+    int32 Count = 0;
+    int32 ValidCount = 0;
+    int32 AddsSinceRebuild = 0;
+    FVector Sum = FVector::ZeroVector;
+};
+
+// Parameters for each FGazeFilter type; only the ones for the selected type are used
+struct PERIMAPXR_API FGazeFilterSettings
+{
+    EGazeFilterType Type = EGazeFilterType::MovingAverage;
+
+    // Moving average: number of tracker samples in the window
+    int32 WindowSamples = 45;
+
+    // One Euro: cutoff frequency at rest, how fast the cutoff rises with gaze speed (per rad/s), and the cutoff used to smooth the speed
+    float MinCutoffHz = 1.0f;
+    float Beta = 0.5f;
+    float DerivativeCutoffHz = 1.0f;
+
+    // Exponential: time constant of the first-order low-pass
+    float TimeConstantSeconds = 0.1f;
+};
+
+/**
+ * Online smoothing of the gaze direction, updated once per tracker sample at O(1) cost.
+ * The moving average uses an FGazeRingBuffer. The exponential filter is a first-order low-pass whose weight
+ * comes from the sample interval, so it behaves the same at any tracker rate. The One Euro filter is a
+ * low-pass whose cutoff rises with gaze speed: steady fixation is smoothed heavily while real eye movements
+ * come through with little lag. Invalid samples leave the exponential and One Euro state untouched.
+ * The result is a unit direction, or zero before the first valid sample.
+ */
+class PERIMAPXR_API FGazeFilter
+{
+public:
+    // Selects the filter and its parameters and clears all state
+    void Configure(const FGazeFilterSettings& InSettings);
+
+    // Clears all state, keeping the settings
+    void Reset();
+
+    // Adds one sample taken at TimeSeconds and returns the filtered direction
+    FVector Update(const FVector& Direction, bool bValid, double TimeSeconds);
+
+    // The filtered direction after the latest update
+    FVector GetValue() const { return Value; }
+
+    const FGazeFilterSettings& GetSettings() const { return Settings; }
+
+private:
+    // Low-pass weight for a cutoff frequency over one sample interval
+    static float Alpha(float CutoffHz, float DeltaSeconds);
+
+    FGazeFilterSettings Settings;
+    FGazeRingBuffer Window;
+
+    // Unnormalized state of the exponential and One Euro filters, and their last valid sample time
+    FVector Smoothed = FVector::ZeroVector;
+    FVector SmoothedVelocity = FVector::ZeroVector;
+    double LastTimeSeconds = 0.0;
+    bool bHasState = false;
+
+    FVector Value = FVector::ZeroVector;
+};
@@ -0,0 +1,96 @@
+// FHierarchicalPosteriorStore.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FPsychometricTable.h"
+#include "FPosteriorStore.h"
+
+/**
+ * Two-level posterior: per-location thresholds under a patient-level psychometric slope and lapse rate.
+ * The patient level is a small grid of hypotheses, one likelihood table each. Every hypothesis keeps its
+ * own FPosteriorStore, so a response is one vector update per hypothesis, and the marginal likelihood
+ * that update returns is pooled across all locations into the hypothesis weights. Per-location estimates
+ * are the mixture over hypotheses; its mean and standard deviation come from the cached moments of each
+ * hypothesis, so refreshing every location after a weight change is O(locations x hypotheses) scalar work.
+ * With a single hypothesis this is exactly an FPosteriorStore.
+ */
+class PERIMAPXR_API FHierarchicalPosteriorStore
+{
+public:
+    FHierarchicalPosteriorStore();
+
+    // Sets one likelihood table per hypothesis (all on the same threshold grid) and removes all locations
+    void Initialize(const TArray<TSharedRef<const FPsychometricTable>>& InTables);
+
+    // Removes all locations and the pooled evidence, keeping the tables, the hypothesis prior and the allocation
+    void Reset();
+
+    // Adds a location with a uniform prior and returns its index
+    int32 AddLocation();
+
+    int32 Num() const { return CompleteFlags.Num(); }
+
+    // Updates every hypothesis with a response, then the hypothesis weights and the mixture moments
+    void Update(int32 Index, float StimulusIntensity, bool bSeen);
+
+    // Multiplies a location's posterior under every hypothesis by a Gaussian over the threshold
+    void ApplyGaussianPrior(int32 Index, float MeanInDb, float StandardDeviationInDb);
+
+    // Mean and standard deviation of a location's threshold, averaged over hypotheses, in dB
+    float GetMean(int32 Index) const { return Means[Index]; }
+    float GetStandardDeviation(int32 Index) const { return StandardDeviations[Index]; }
+    const TArray<float>& GetMeans() const { return Means; }
+    const TArray<float>& GetStandardDeviations() const { return StandardDeviations; }
+
+    // Minimum expected entropy intensity under the currently most probable hypothesis
+    float SelectMinimumEntropyIntensity(int32 Index) const;
+
+    bool IsComplete(int32 Index) const { return CompleteFlags[Index] != 0; }
+    void SetComplete(int32 Index, bool bComplete);
+    bool AreAllComplete() const { return NumComplete == Num(); }
+
+    // Writes the normalized, unpadded mixture posterior of a location, used for logging
+    void GetPosterior(int32 Index, TArray<float>& OutPosterior) const;
+
+    const TArray<float>& GetThresholdLevels() const { return Hypotheses[0].GetThresholdLevels(); }
+    int32 GetNumThresholds() const { return Hypotheses.Num() > 0 ? Hypotheses[0].GetNumThresholds() : 0; }
+    int32 GetStride() const { return Hypotheses.Num() > 0 ? Hypotheses[0].GetStride() : 0; }
+
+    // Patient level: parameters and posterior weight of each hypothesis
+    int32 GetNumHypotheses() const { return Hypotheses.Num(); }
+    const FPsychometricParams& GetHypothesisParams(int32 Hypothesis) const { return Tables[Hypothesis]->GetParams(); }
+    const TArray<float>& GetHypothesisWeights() const { return Weights; }
+    int32 GetMostProbableHypothesis() const { return MostProbableHypothesis; }
+
+    // Posterior means of the patient's slope and lapse rate
+    float GetExpectedSlope() const;
+    float GetExpectedLapseRate() const;
+
+    // Log prior over hypotheses (uniform by default), e.g. one eye's log posterior carried into the other
+    void SetHypothesisLogPrior(TArrayView<const float> InLogPrior);
+
+    // Log prior plus pooled log evidence, unnormalized
+    TArray<float> GetHypothesisLogPosterior() const;
+
+private:
+    // Softmax of prior plus evidence
+    void RefreshWeights();
+
+    // Mixture moments of one location from the per-hypothesis moments
+    void RefreshMixture(int32 Index);
+
+    TArray<TSharedRef<const FPsychometricTable>> Tables;
+    TArray<FPosteriorStore> Hypotheses;
+
+    TArray<float> LogPriors;
+    TArray<float> LogEvidence;
+    TArray<float> Weights;
+    int32 MostProbableHypothesis;
+
+    TArray<float> Means;
+    TArray<float> StandardDeviations;
+
+    TArray<uint8> CompleteFlags;
+    int32 NumComplete;
+};
@@ -0,0 +1,37 @@
+// FLocationRegistry.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Assigns each test location a stable, dense integer ID.
+ * Locations are registered once (at SetupTest) and everything per-location is then addressed by ID in plain
+ * arrays. Vector lookups are only needed at the API boundary; they use a key quantized to 0.01 cm, so the
+ * same point computed twice with slightly different rounding still maps to the same ID.
+ */
+class PERIMAPXR_API FLocationRegistry
+{
+public:
+    // Returns the ID of a location, registering it if it is new
+    int32 FindOrAdd(const FVector& Location);
+
+    // Returns the ID of a location, or INDEX_NONE if it was never registered
+    int32 Find(const FVector& Location) const;
+
+    // The location registered under an ID
+    const FVector& GetLocation(int32 LocationId) const { return Locations[LocationId]; }
+
+    bool IsValidId(int32 LocationId) const { return Locations.IsValidIndex(LocationId); }
+    int32 Num() const { return Locations.Num(); }
+    const TArray<FVector>& GetLocations() const { return Locations; }
+
+    // Forgets every location; IDs start from zero again
+    void Reset();
+
+private:
+    static FIntVector MakeKey(const FVector& Location);
+
+    TArray<FVector> Locations;
+    TMap<FIntVector, int32> IdsByKey;
+};
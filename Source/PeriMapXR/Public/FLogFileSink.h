@@ -0,0 +1,138 @@
+// FLogFileSink.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+class IFileHandle;
+
+// Batching, drop and rotation limits for an FLogFileSink
+struct PERIMAPXR_API FLogFileSinkSettings
+{
+    // Bytes accumulated before the writer thread writes a batch early
+    int32 BatchSizeBytes = 16 * 1024;
+
+    // Longest time a record waits before it reaches the file
+    float FlushIntervalSeconds = 0.5f;
+
+    // Backlog above which new records are dropped
+    int64 MaxPendingBytes = 4 * 1024 * 1024;
+
+    // Size at which the sink moves on to a new file (0 disables rotation)
+    int64 MaxFileSizeBytes = 0;
+
+    // Cap on the combined size of all files sharing the sink's prefix and extension (0 disables pruning)
+    int64 MaxTotalBytes = 0;
+
+    // File patterns of other sinks in the same directory ("<Prefix>_*.<Extension>") whose files count toward
+    // MaxTotalBytes too, so sinks sharing a folder share one budget; pruning removes the oldest across all of them
+    TArray<FString> SharedBudgetPatterns;
+
+    // Binary sinks never get drop notices inserted between records
+    bool bBinary = false;
+};
+
+/**
+ * Asynchronous, batched file sink used by the PeriMapXR log service.
+ * Producers push records onto a lock-free multi-producer queue; a dedicated writer thread keeps
+ * one file handle open and writes in batches once either the batch size or the flush interval
+ * is reached. Pending memory is bounded: records that would exceed MaxPendingBytes are dropped
+ * and counted, and text sinks note the number of dropped records in the file. The queue has a single
+ * consumer: the writer thread, or without one whichever producer holds DrainLock.
+ * Files are named <Prefix>_<SessionTime>_<Index>.<Extension>. When a file reaches MaxFileSizeBytes
+ * the sink opens the next index, writes the file header again and deletes the oldest files
+ * sharing the prefix, and any SharedBudgetPatterns, until their combined size fits MaxTotalBytes.
+ */
+class PERIMAPXR_API FLogFileSink : public FRunnable
+{
+public:
+    // Opens the first file, writes the header and starts the writer thread
+    FLogFileSink(const FString& InDirectory, const FString& InPrefix, const FString& InExtension, const FLogFileSinkSettings& InSettings = FLogFileSinkSettings(), TArray<uint8> InFileHeader = TArray<uint8>());
+    virtual ~FLogFileSink();
+
+    // Queues a text record for the writer thread. Returns false if the record was dropped.
+    bool Enqueue(FString&& Record);
+
+    // Queues a binary record that is written to the file verbatim. Returns false if the record was dropped.
+    bool Enqueue(TArray<uint8>&& Record);
+
+    // Number of records dropped because the pending backlog was full
+    int64 GetDroppedCount() const { return DroppedCount.load(std::memory_order_relaxed); }
+
+    // FRunnable interface
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    // A queued record; text records are converted to UTF-8 on the writer thread
+    struct FPendingRecord
+    {
+        FString Text;
+        TArray<uint8> Bytes;
+
+        int64 GetSize() const { return Text.Len() * sizeof(TCHAR) + Bytes.Num(); }
+    };
+
+    // Applies the drop policy and hands the record to the writer thread
+    bool EnqueueRecord(FPendingRecord&& Record);
+
+    // Moves queued records into the batch buffer and writes it out when due
+    void DrainQueue(bool bForceWrite);
+
+    // Writes the batch buffer to the open file handle, rotating once the file is full
+    void WriteBatch();
+
+    // Closes the current file, opens the next index and writes the file header
+    void OpenNextFile();
+
+    // Deletes the oldest files sharing the prefix or a shared budget pattern until their total fits MaxTotalBytes
+    void PruneOldFiles();
+
+    // Appends a record to the batch buffer, converting text to UTF-8
+    void AppendToBatch(const FString& Record);
+    void AppendToBatch(const TArray<uint8>& Record);
+
+    FString Directory;
+    FString Prefix;
+    FString Extension;
+    FString SessionTag;
+    FLogFileSinkSettings Settings;
+
+    // Written at the start of every file so each rotated file decodes on its own
+    TArray<uint8> FileHeader;
+
+    // Records waiting for the writer thread
+    TQueue<FPendingRecord, EQueueMode::Mpsc> PendingRecords;
+
+    // Bytes currently held in PendingRecords, used for the drop policy
+    std::atomic<int64> PendingBytes;
+
+    // Records dropped since the sink was created, and the count last reported in the file
+    std::atomic<int64> DroppedCount;
+    int64 ReportedDroppedCount;
+
+    // UTF-8 bytes accumulated by the writer thread since the last write
+    TArray<uint8> Batch;
+    double LastWriteTime;
+
+    // The open file, its index within this session and the bytes written to it
+    TUniquePtr<IFileHandle> FileHandle;
+    int32 FileIndex;
+    int64 FileBytesWritten;
+
+    FEvent* WakeEvent;
+    FRunnableThread* Thread;
+
+    // Serializes draining when there is no writer thread, so producers never dequeue concurrently
+    FCriticalSection DrainLock;
+
+    // False on platforms without threading, where records are written on the calling thread
+    bool bUseWriterThread;
+    std::atomic<bool> bStopping;
+};
@@ -3,33 +3,55 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Misc/Paths.h"
-#include "Misc/FileHelper.h"
-#include "HAL/PlatformFilemanager.h"
 
 /**
- *
+ * Lightweight handle for logging under a named category.
+ * Holds no files of its own: file output goes to the shared UPeriMapXRLogSubsystem, which also applies the
+ * category's runtime verbosity. Constructing one is free, so actors can own a handle without touching disk.
  */
 class PERIMAPXR_API FLogManager
 {
 public:
-	// Constructor to initialize the log file with the current date and time
-	FLogManager();
+	// Constructor to tag every message from this handle with a category
+	explicit FLogManager(FName InCategory = TEXT("PeriMapXR"));
 	~FLogManager();
 
 	// Function to log messages
 	void LogMessage(const FString& Message, ELogVerbosity::Type Verbosity = ELogVerbosity::Log, float DisplayTime = 5.0f,
 		bool bEnableConsoleMessages = true, bool bEnableOnScreenMessages = true, bool bEnableSaveToLog = true);
 
-	// Static function to get the singleton instance
+	// Function to log a formatted message. The text is only formatted when the message passes the category filter
+	// and goes somewhere, and it is formatted into a per-thread buffer that is reused, so hot paths do not allocate
+	template <typename FmtType, typename... Types>
+	void LogMessagef(ELogVerbosity::Type Verbosity, float DisplayTime, bool bEnableConsoleMessages, bool bEnableOnScreenMessages, bool bEnableSaveToLog,
+		const FmtType& Fmt, Types... Args)
+	{
+		if (!ShouldLog(Verbosity, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog))
+		{
+			return;
+		}
+
+		FString& Buffer = GetFormatBuffer();
+		Buffer.Reset();
+		Buffer.Appendf(Fmt, Args...);
+		LogMessage(Buffer, Verbosity, DisplayTime, bEnableConsoleMessages, bEnableOnScreenMessages, bEnableSaveToLog);
+	}
+
+	// Function to check whether a message would be written anywhere
+	bool ShouldLog(ELogVerbosity::Type Verbosity, bool bEnableConsoleMessages, bool bEnableOnScreenMessages, bool bEnableSaveToLog) const;
+
+	// Static function to get the handle for the default category
 	static FLogManager& Get();
 
+	// The category this handle logs under
+	FName GetCategory() const { return Category; }
+
 private:
-	// The path to the log file
-	FString LogFilePath;
+	// The category passed to the log service and shown in every line
+	FName Category;
 
-	// Function to get the current date and time in a specific format
-	FString GetDateTimeString() const;
+	// Per-thread buffer LogMessagef formats into
+	static FString& GetFormatBuffer();
 
 	// Function to display messages on the screen
 	void DisplayOnScreen(const FString& Message, ELogVerbosity::Type Verbosity, float DisplayTime);
@@ -0,0 +1,31 @@
+// FNeighborGraph.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Sparse neighbour graph over a test pattern, stored in compressed sparse row form.
+ * Built once per pattern from the location directions; afterwards the neighbours of a location are a
+ * contiguous slice of two flat arrays, so walking them from the response callback costs no allocation.
+ * Weights fall linearly from 1 (same direction) to 0 at the neighbour radius.
+ */
+class PERIMAPXR_API FNeighborGraph
+{
+public:
+    // Rebuilds the graph. Locations are indexed by location ID; only the IDs in PatternIds get neighbours,
+    // and each keeps at most MaxNeighbors of the closest pattern locations within RadiusDegrees
+    void Build(const TArray<FVector>& Locations, const TArray<int32>& PatternIds, float RadiusDegrees, int32 MaxNeighbors);
+
+    void Reset();
+
+    // Neighbour IDs and weights of a location; both views are empty for IDs outside the pattern
+    TArrayView<const int32> GetNeighbors(int32 LocationId) const;
+    TArrayView<const float> GetWeights(int32 LocationId) const;
+
+private:
+    // Row offsets into Neighbors / Weights, one more entry than there are location IDs
+    TArray<int32> Offsets;
+    TArray<int32> Neighbors;
+    TArray<float> Weights;
+};
\ No newline at end of file
@@ -0,0 +1,87 @@
+// FNormativePriorDatabase.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ETestType.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Normative threshold distribution at one location for one age band, in dB
+struct FNormativePrior
+{
+    float MeanInDb = 0.0f;
+    float StandardDeviationInDb = 0.0f;
+};
+
+/**
+ * One test pattern and age band picked from the database. Holds pointers straight into the mapped file,
+ * so copying it is free and a lookup is a grid-cell index plus one read.
+ */
+class PERIMAPXR_API FNormativePriorSelection
+{
+public:
+    bool IsValid() const { return Records != nullptr; }
+
+    // Prior at the pattern point nearest to a field position (right-eye orientation, degrees); false if none
+    bool Find(float HorizontalDegrees, float VerticalDegrees, FNormativePrior& OutPrior) const;
+
+private:
+    friend class FNormativePriorDatabase;
+
+    const uint8* Records = nullptr;
+    const int16* Cells = nullptr;
+    float GridOriginHorizontal = 0.0f;
+    float GridOriginVertical = 0.0f;
+    float InverseGridSpacing = 0.0f;
+    int32 GridWidth = 0;
+    int32 GridHeight = 0;
+    int32 RecordStride = 0;
+    int32 BandOffset = 0;
+};
+
+/**
+ * Normative threshold priors by test pattern, location and age band.
+ * The database is a compact binary file (Data/PeriMapXR/NormativePriors.bin, built from CSV by
+ * scripts/priors/build_normative_priors.py) that is memory-mapped rather than parsed: opening it validates
+ * the header and offsets once, and every later query reads the mapping in place. Selecting a pattern and
+ * age band is constant time, as is each location lookup. If the platform cannot map the file it is read
+ * into memory instead.
+ */
+class PERIMAPXR_API FNormativePriorDatabase
+{
+public:
+    FNormativePriorDatabase();
+    ~FNormativePriorDatabase();
+
+    // The shared database, opened from GetDefaultPath on first use; stays mapped for the life of the process
+    static const FNormativePriorDatabase& Get();
+
+    static FString GetDefaultPath();
+
+    // Maps and validates a database file; returns false (and stays empty) if it is missing or malformed
+    bool Open(const FString& Path);
+
+    bool IsValid() const { return Data != nullptr; }
+
+    // Picks a pattern and age band; the result is invalid if the pattern is not in the database
+    FNormativePriorSelection Select(ETestType TestType, int32 AgeYears) const;
+
+    // Field position of a pattern location (relative to the fixation point), in degrees; inverse of
+    // ATestStimuli::PolarToCartesian, with positive horizontal towards +X
+    static void ToFieldDegrees(const FVector& Location, float& OutHorizontalDegrees, float& OutVerticalDegrees);
+
+private:
+    bool Validate(const uint8* InData, int64 InSize) const;
+    void Close();
+
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+
+    // Used instead of the mapping on platforms that cannot map the file
+    TArray<uint8> LoadedBytes;
+
+    const uint8* Data;
+    int64 Size;
+};
\ No newline at end of file
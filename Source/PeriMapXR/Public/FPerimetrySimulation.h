@@ -0,0 +1,93 @@
+// FPerimetrySimulation.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EStimulusSelectionStrategy.h"
+#include "ETestType.h"
+#include "FSimulatedObserver.h"
+#include "FTrialScheduler.h"
+
+// Configuration for a batch of simulated sessions
+struct PERIMAPXR_API FPerimetrySimulationSettings
+{
+    // Test locations relative to the fixation point, as ATestStimuli builds them
+    TArray<FVector> Locations;
+
+    // Pattern the estimator is initialized for, which picks its normative priors
+    ETestType TestType = ETestType::TEST_24_2;
+
+    // True threshold at each location; if empty, each session draws its own map uniformly from the range below
+    TArray<float> TrueThresholdsInDb;
+    float MinTrueThresholdInDb = 15.0f;
+    float MaxTrueThresholdInDb = 35.0f;
+
+    FSimulatedObserverParams Observer;
+    EStimulusSelectionStrategy SelectionStrategy = EStimulusSelectionStrategy::PosteriorMean;
+
+    // Let the estimator infer the observer's slope and lapse rate rather than assume its defaults
+    bool bEstimatePatientPsychometrics = true;
+    FTrialSchedulerSettings Scheduler;
+
+    // Presentation timing, used to estimate how long a session would take on the headset
+    float StimuliDuration = 0.2f;
+    float TimeBetweenStimuli = 1.0f;
+
+    int32 NumSessions = 1000;
+
+    // Session N uses seed RandomSeed + N for its observer and scheduler, so runs are reproducible
+    int32 RandomSeed = 1;
+};
+
+// Aggregate results of a batch of simulated sessions
+struct PERIMAPXR_API FPerimetrySimulationReport
+{
+    int32 NumSessions = 0;
+    int32 NumLocations = 0;
+
+    // Final estimate minus true threshold, over every location of every session
+    double MeanErrorInDb = 0.0;
+    double MeanAbsoluteErrorInDb = 0.0;
+    double RootMeanSquareErrorInDb = 0.0;
+
+    // Fraction of locations that met the stopping rule rather than hitting the presentation cap
+    double CompletionRate = 0.0;
+
+    double MeanPresentationsPerLocation = 0.0;
+    double MeanPresentationsPerSession = 0.0;
+    double MeanCatchTrialsPerSession = 0.0;
+
+    // Trials rejected for a fixation loss and retested, and fixation losses scored once a location ran out of retests
+    double MeanRejectedTrialsPerSession = 0.0;
+    double MeanUnreliableTrialsPerSession = 0.0;
+    double MeasuredFalsePositiveRate = 0.0;
+
+    // Estimator's final patient-level slope (dB) and lapse rate, to compare with the observer's
+    double MeanEstimatedSlope = 0.0;
+    double MeanEstimatedLapseRate = 0.0;
+
+    // Estimated time on the headset, from the presentation timing
+    double MeanSessionDurationSeconds = 0.0;
+
+    // Scheduler, selection and update cost per presented trial
+    double MeanCpuMicrosecondsPerTrial = 0.0;
+
+    // Wall-clock time for the whole batch
+    double WallSeconds = 0.0;
+
+    FString ToString() const;
+};
+
+/**
+ * Monte Carlo runner for the perimetry pipeline.
+ * Each session drives a UThresholdEstimator and an FTrialScheduler through the same sequence as
+ * ATestStimuli::RunTest (catch trial check, PopNext, next intensity, fixation check, response, update, ReportResult),
+ * with an FSimulatedObserver standing in for the patient and the headset. Sessions are spread across
+ * worker threads with ParallelFor; each worker reuses one estimator, created up front on the game thread.
+ */
+class PERIMAPXR_API FPerimetrySimulation
+{
+public:
+    // Runs NumSessions sessions and aggregates the results; must be called on the game thread
+    static FPerimetrySimulationReport Run(const FPerimetrySimulationSettings& Settings);
+};
\ No newline at end of file
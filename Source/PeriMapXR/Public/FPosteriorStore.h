@@ -0,0 +1,100 @@
+// FPosteriorStore.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FPsychometricTable.h"
+
+/**
+ * Structure-of-arrays store for the threshold posteriors of every location tested on one eye.
+ * Posteriors are kept as unnormalized log probabilities in a single 16-byte aligned buffer, one row of
+ * GetStride() floats per location, zero-padded in the likelihood tables and held at a large negative value
+ * in the padding here. An update adds a log-likelihood row and re-centres the row on its maximum, so long
+ * sessions can never underflow; the same pass also produces the normalizer, mean and standard deviation,
+ * which are cached per location. Estimates and completion checks are therefore O(1) per query.
+ */
+class PERIMAPXR_API FPosteriorStore
+{
+public:
+    FPosteriorStore();
+
+    // Sets the likelihood table (and so the threshold grid) and removes all locations
+    void Initialize(const TSharedRef<const FPsychometricTable>& InTable);
+
+    // Removes all locations, keeping the table and the allocation
+    void Reset();
+
+    // Adds a location with a uniform prior and returns its index
+    int32 AddLocation();
+
+    // Number of locations in the store
+    int32 Num() const { return CompleteFlags.Num(); }
+
+    // Adds the log likelihood of a response to a location's posterior and refreshes its cached moments;
+    // returns the log probability the posterior gave that response beforehand (its marginal likelihood)
+    float Update(int32 Index, float StimulusIntensity, bool bSeen);
+
+    // Multiplies a location's posterior by a Gaussian over the threshold (a prior from its neighbours)
+    void ApplyGaussianPrior(int32 Index, float MeanInDb, float StandardDeviationInDb);
+
+    // Cached posterior mean and standard deviation of a location's threshold, in dB
+    float GetMean(int32 Index) const { return Means[Index]; }
+    float GetStandardDeviation(int32 Index) const { return StandardDeviations[Index]; }
+
+    // Cached means and standard deviations for every location, indexed like the rows
+    const TArray<float>& GetMeans() const { return Means; }
+    const TArray<float>& GetStandardDeviations() const { return StandardDeviations; }
+
+    // Candidate intensity (in dB) whose response is expected to leave the least posterior entropy at a location
+    float SelectMinimumEntropyIntensity(int32 Index) const;
+
+    // Completion flags, kept alongside the posteriors so "is everything finished?" needs no lookups
+    bool IsComplete(int32 Index) const { return CompleteFlags[Index] != 0; }
+    void SetComplete(int32 Index, bool bComplete);
+    bool AreAllComplete() const { return NumComplete == Num(); }
+
+    // Writes the normalized, unpadded posterior of a location, used for logging
+    void GetPosterior(int32 Index, TArray<float>& OutPosterior) const;
+
+    const TArray<float>& GetThresholdLevels() const { return Table->GetThresholdLevels(); }
+    int32 GetNumThresholds() const { return NumThresholds; }
+    int32 GetStride() const { return Stride; }
+
+private:
+    // Sets a row to the uniform distribution over the real thresholds
+    void SetUniform(float* Row) const;
+
+    // Re-centres a row on its maximum and caches its normalizer and moments
+    void RefreshRow(int32 Index, float Max);
+
+    // Writes p and p * ln(p) for a row into the scratch rows
+    void ExpandRow(int32 Index) const;
+
+    // Vector kernels over Stride floats; all pointers must be 16-byte aligned
+    static float AddRow(float* Row, const float* LogLikelihoods, int32 Count);
+    static float AddGaussian(float* Row, const float* Levels, float Mean, float InverseStandardDeviation, int32 Count);
+    static void CenterAndSum(float* Row, float Max, const float* Levels, int32 Count, float& OutSum, float& OutWeightedSum, float& OutWeightedSumSquares);
+    static void OutcomeSums(const float* Row, const float* RowLogRow, const float* Likelihoods, const float* LogLikelihoods, int32 Count, float& OutProbability, float& OutWeightedLog);
+
+    TSharedPtr<const FPsychometricTable> Table;
+    int32 NumThresholds;
+    int32 Stride;
+
+    // Threshold levels padded with zeros to Stride
+    TArray<float, TAlignedHeapAllocator<16>> PaddedLevels;
+
+    // Num() rows of Stride unnormalized log probabilities; the largest entry of each row is zero
+    TArray<float, TAlignedHeapAllocator<16>> LogPosteriors;
+
+    // Per-row log normalizer (log of the sum of exp over the row) and moments, refreshed on every update
+    TArray<float> LogNormalizers;
+    TArray<float> Means;
+    TArray<float> StandardDeviations;
+
+    TArray<uint8> CompleteFlags;
+    int32 NumComplete;
+
+    // Scratch rows of p and p * ln(p) for entropy selection; the store is only used from one thread at a time
+    mutable TArray<float, TAlignedHeapAllocator<16>> RowScratch;
+    mutable TArray<float, TAlignedHeapAllocator<16>> RowLogRowScratch;
+};
\ No newline at end of file
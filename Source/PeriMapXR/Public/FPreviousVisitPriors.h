@@ -0,0 +1,41 @@
+// FPreviousVisitPriors.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Thresholds from the patient's previous visual field, used as priors for the next one.
+ * A results file written by ATestStimuli::SaveResultsToFile is parsed once into a hash keyed by eye and
+ * whole-degree field position (no standard pattern has two points in the same degree cell), so the
+ * estimator resolves a whole pattern with one lookup per location when it is registered.
+ */
+class PERIMAPXR_API FPreviousVisitPriors
+{
+public:
+    // Parses a results file; returns false (and stays empty) if it is missing or has no usable rows
+    bool Load(const FString& Path);
+
+    // Forgets the loaded visit
+    void Reset();
+
+    bool IsValid() const { return MeansInDb.Num() > 0; }
+
+    // The file last passed to Load, whether or not it could be read
+    const FString& GetPath() const { return LoadedPath; }
+
+    // Previous threshold and posterior standard deviation at a field position of one eye, in that eye's own
+    // orientation (degrees); false if the previous visit did not test it
+    bool Find(bool bLeftEye, float HorizontalDegrees, float VerticalDegrees, float& OutMeanInDb, float& OutStandardDeviationInDb) const;
+
+    // Value of the Eye column in results files
+    static const TCHAR* GetEyeName(bool bLeftEye) { return bLeftEye ? TEXT("Left") : TEXT("Right"); }
+
+private:
+    static FIntVector MakeKey(bool bLeftEye, float HorizontalDegrees, float VerticalDegrees);
+
+    FString LoadedPath;
+    TMap<FIntVector, int32> IndicesByKey;
+    TArray<float> MeansInDb;
+    TArray<float> StandardDeviationsInDb;
+};
@@ -0,0 +1,82 @@
+// FPsychometricTable.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Psychometric function parameters plus the threshold and intensity grids a likelihood table is built for
+struct PERIMAPXR_API FPsychometricParams
+{
+    float Slope = 3.0f;
+    float GuessRate = 0.5f;
+    float LapseRate = 0.01f;
+
+    // Candidate thresholds, in dB
+    float MinThresholdInDb = 0.0f;
+    float MaxThresholdInDb = 40.0f;
+    float ThresholdStepSizeInDb = 1.0f;
+
+    // Presented intensities are quantized to this step before lookup, in dB
+    float IntensityStepInDb = 0.1f;
+
+    // Spacing of the intensities considered by information-gain selection, in dB
+    float CandidateStepInDb = 1.0f;
+
+    bool operator==(const FPsychometricParams& Other) const;
+    friend uint32 GetTypeHash(const FPsychometricParams& Params);
+};
+
+/**
+ * Precomputed likelihoods of a "seen" and "not seen" response, indexed by presented intensity and
+ * candidate threshold. Tables are immutable once built and shared by every location and eye that uses
+ * the same parameters, so a posterior update becomes one row lookup and a multiply-normalize pass.
+ * Rows are 16-byte aligned and zero-padded to a multiple of four thresholds (GetRowStride) so they can be
+ * consumed directly by the vectorized kernels in FPosteriorStore.
+ */
+class PERIMAPXR_API FPsychometricTable
+{
+public:
+    // Returns the shared table for these parameters, building it on first use
+    static TSharedRef<const FPsychometricTable> GetOrCreate(const FPsychometricParams& Params);
+
+    // Psychometric function (cumulative Gaussian), evaluated directly
+    static float Evaluate(const FPsychometricParams& Params, float StimulusIntensity, float ThresholdLevel);
+
+    // Row of likelihoods over all candidate thresholds for a presented intensity and response
+    const float* GetLikelihoodRow(float StimulusIntensity, bool bSeen) const;
+
+    // Index of the quantized intensity row used for a presented intensity
+    int32 GetIntensityIndex(float StimulusIntensity) const;
+
+    // Row access by intensity index, and the intensity (in dB) a row was built for
+    const float* GetLikelihoodRowByIndex(int32 IntensityIndex, bool bSeen) const;
+    const float* GetLogLikelihoodRowByIndex(int32 IntensityIndex, bool bSeen) const;
+    float GetIntensityAtIndex(int32 IntensityIndex) const { return Params.MinThresholdInDb + IntensityIndex * Params.IntensityStepInDb; }
+
+    // Intensity rows considered by information-gain selection, CandidateStepInDb apart
+    const TArray<int32>& GetCandidateIntensityIndices() const { return CandidateIntensityIndices; }
+
+    // Candidate threshold levels, in dB
+    const TArray<float>& GetThresholdLevels() const { return ThresholdLevelsInDb; }
+    int32 GetNumThresholds() const { return ThresholdLevelsInDb.Num(); }
+    int32 GetRowStride() const { return RowStride; }
+    int32 GetNumIntensities() const { return NumIntensities; }
+
+    const FPsychometricParams& GetParams() const { return Params; }
+
+    explicit FPsychometricTable(const FPsychometricParams& InParams);
+
+private:
+    FPsychometricParams Params;
+    TArray<float> ThresholdLevelsInDb;
+    int32 NumIntensities;
+    int32 RowStride;
+
+    // [Intensity][Response (0 = not seen, 1 = seen)][Threshold], contiguous per row with zero padding
+    TArray<float, TAlignedHeapAllocator<16>> Likelihoods;
+
+    // Natural log of Likelihoods in the same layout (padding stays zero), for expected-entropy sums
+    TArray<float, TAlignedHeapAllocator<16>> LogLikelihoods;
+
+    TArray<int32> CandidateIntensityIndices;
+};
@@ -0,0 +1,51 @@
+// FSimulatedObserver.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "FPsychometricTable.h"
+
+// Behaviour of a simulated patient
+struct PERIMAPXR_API FSimulatedObserverParams
+{
+    // True psychometric function; only Slope, GuessRate and LapseRate are used
+    FPsychometricParams Psychometric;
+
+    // Probability of pressing the button when nothing (or nothing visible) was shown
+    float FalsePositiveRate = 0.03f;
+
+    // Probability of missing a stimulus that would otherwise have been seen
+    float FalseNegativeRate = 0.03f;
+
+    // Probability of a saccade or blink during a trial; ATestStimuli rejects and retests those, up to a cap
+    float FixationLossRate = 0.02f;
+};
+
+/**
+ * A simulated patient with a known threshold at every test location.
+ * Responses are drawn from the same psychometric function the estimator assumes, with false positives,
+ * false negatives and fixation losses layered on top, so a session can be run without the headset.
+ * Each observer owns its random stream; a given seed always produces the same responses.
+ */
+class PERIMAPXR_API FSimulatedObserver
+{
+public:
+    FSimulatedObserver(const TArray<float>& InTrueThresholdsInDb, const FSimulatedObserverParams& InParams, int32 Seed);
+
+    // Whether the observer makes a saccade or blinks while the stimulus is up; drawn before Respond
+    bool LosesFixation();
+
+    // Whether the observer reports seeing a stimulus of this intensity at a location
+    bool Respond(int32 LocationIndex, float StimulusIntensityInDb);
+
+    // Whether the observer presses the button during a catch trial (no stimulus)
+    bool RespondToCatchTrial();
+
+    const TArray<float>& GetTrueThresholdsInDb() const { return TrueThresholdsInDb; }
+
+private:
+    TArray<float> TrueThresholdsInDb;
+    FSimulatedObserverParams Params;
+    FRandomStream RandomStream;
+};
\ No newline at end of file
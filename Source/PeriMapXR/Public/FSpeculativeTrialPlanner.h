@@ -0,0 +1,78 @@
+// FSpeculativeTrialPlanner.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "UObject/StrongObjectPtr.h"
+#include "FTrialScheduler.h"
+
+class UThresholdEstimator;
+
+// The trial chosen after a response: which location to present and at what intensity
+struct PERIMAPXR_API FPlannedTrial
+{
+    int32 StimulusIndex = INDEX_NONE;
+    float IntensityInDb = 0.0f;
+
+    // The catch-trial decision drawn before the trial was chosen, as RunTest draws it; used once, then cleared
+    bool bPrecededByCatchTrial = false;
+
+    bool IsValid() const { return StimulusIndex != INDEX_NONE; }
+};
+
+/**
+ * Works out the next trial while the current stimulus is on screen, for both possible responses.
+ * Begin launches one task per outcome; each copies the estimator into its own branch estimator, applies the
+ * response, reports it to a copy of the scheduler and selects the next location and intensity. When the
+ * response arrives, Commit waits for the tasks (normally long finished), swaps the matching branch into the
+ * live estimator and scheduler, and hands back the next trial, so the game thread does no estimation work.
+ *
+ * The tasks read the live estimator, so nothing may change it between Begin and Commit or Cancel; its state
+ * version is checked at Commit and a stale branch is discarded, leaving the caller to update as usual.
+ */
+class PERIMAPXR_API FSpeculativeTrialPlanner
+{
+public:
+    FSpeculativeTrialPlanner();
+    ~FSpeculativeTrialPlanner();
+
+    // Starts both branches for the trial now showing; cancels any earlier speculation. Game thread only
+    void Begin(const UThresholdEstimator& Estimator, const FTrialScheduler& Scheduler, const TArray<int32>& LocationIds, int32 StimulusIndex, float IntensityInDb);
+
+    // Commits the branch for this response into the estimator and scheduler and returns the next trial
+    // (invalid if the schedule is finished); false if nothing was pending or the branch is stale
+    bool Commit(bool bSeen, UThresholdEstimator& Estimator, FTrialScheduler& Scheduler, FPlannedTrial& OutNextTrial);
+
+    // Waits for and discards any pending branches
+    void Cancel();
+
+    bool IsPending() const { return bPending; }
+
+private:
+    struct FBranch
+    {
+        TStrongObjectPtr<UThresholdEstimator> Estimator;
+        FTrialScheduler Scheduler;
+        UE::Tasks::FTask Task;
+        FPlannedTrial NextTrial;
+        bool bApplied = false;
+        bool bCompleted = false;
+    };
+
+    // Applies one outcome in a branch and selects the trial that would follow it; runs on a worker
+    static void RunBranch(FBranch& Branch, const UThresholdEstimator& Estimator, const TArray<int32>& LocationIds, int32 StimulusIndex, int32 LocationId, float IntensityInDb, bool bSeen);
+
+    void WaitForBranches();
+
+    // Index 0 is the "not seen" branch, 1 the "seen" branch
+    FBranch Branches[2];
+
+    // What the pending branches were started from
+    TArray<int32> LocationIds;
+    int32 StimulusIndex;
+    int32 LocationId;
+    float IntensityInDb;
+    uint32 StartVersion;
+    bool bPending;
+};
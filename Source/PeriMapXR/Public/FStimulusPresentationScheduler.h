@@ -0,0 +1,89 @@
+// FStimulusPresentationScheduler.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One stimulus presentation as it actually appeared on the display
+struct FStimulusPresentation
+{
+    int32 StimulusIndex = INDEX_NONE;
+    float IntensityInDb = 0.0f;
+
+    // Requested on-screen time, rounded to whole display frames
+    int32 RequestedFrames = 0;
+    double RequestedDurationSeconds = 0.0;
+
+    // Frame counters and timestamps of the first and last frames the stimulus was drawn in
+    uint64 FirstFrame = 0;
+    uint64 LastFrame = 0;
+    double FirstFrameSeconds = 0.0;
+    double LastFrameSeconds = 0.0;
+
+    // Time from the first frame with the stimulus to the first frame without it
+    double MeasuredDurationSeconds = 0.0;
+
+    // False if the measured duration missed the requested one by more than the tolerance
+    bool bWithinTolerance = false;
+
+    bool IsValid() const { return StimulusIndex != INDEX_NONE; }
+};
+
+/**
+ * Frame-quantized stimulus presentation.
+ * A presentation is queued with a duration in seconds, rounded to whole frames at the display refresh rate.
+ * AdvanceFrame is then called once per frame: the stimulus goes up on the next frame, and comes down on the
+ * first frame at or past its last requested frame, judged by frame timestamps rather than frame counts, so a
+ * hitch shortens the number of frames drawn but not the time on screen. The first and last frames and the
+ * measured duration are recorded for the trial, with a flag when the duration missed tolerance.
+ */
+class PERIMAPXR_API FStimulusPresentationScheduler
+{
+public:
+    // What the caller should do with the queued stimulus this frame
+    enum class EAction : uint8
+    {
+        None,
+        Show,
+        Hide
+    };
+
+    // Sets the display refresh rate and how far, in frames, a measured duration may be from the requested one
+    void Configure(float InRefreshRateHz, float InToleranceFrames);
+
+    // Queues a presentation, replacing any that has not finished
+    void Schedule(int32 StimulusIndex, float IntensityInDb, float DurationSeconds);
+
+    // Drops the queued presentation, if any
+    void Cancel();
+
+    // Advances by one display frame (frame counter and frame timestamp) and returns what to do this frame
+    EAction AdvanceFrame(uint64 FrameNumber, double FrameSeconds);
+
+    // True from Schedule until the frame that hides the stimulus
+    bool IsPresenting() const { return State != EState::Idle; }
+
+    // The presentation in progress, or the last one to finish
+    const FStimulusPresentation& GetPresentation() const { return Presentation; }
+
+    float GetRefreshRateHz() const { return RefreshRateHz; }
+    double GetFramePeriodSeconds() const { return 1.0 / RefreshRateHz; }
+
+private:
+    enum class EState : uint8
+    {
+        Idle,
+        Queued,
+        Showing
+    };
+
+    FStimulusPresentation Presentation;
+    EState State = EState::Idle;
+
+    // Timestamp of the previous frame, which becomes the last frame once the stimulus is hidden
+    uint64 PreviousFrame = 0;
+    double PreviousFrameSeconds = 0.0;
+
+    float RefreshRateHz = 90.0f;
+    float ToleranceFrames = 0.5f;
+};
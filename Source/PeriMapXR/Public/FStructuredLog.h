@@ -0,0 +1,141 @@
+// FStructuredLog.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+#include "FLogFileSink.h"
+
+/**
+ * Static format identifiers for structured log records.
+ * Values are written to disk, so new formats must be appended before Count and existing values never reordered.
+ */
+enum class EStructuredLogFormat : uint16
+{
+    EstimatorUpdate = 0,
+    EstimatorPosterior,
+    EstimatorComplete,
+    EstimatorResultRecorded,
+    EstimatorSensitivity,
+    TrialStart,
+    TrialIntensity,
+    TrialResponse,
+    StimulusShown,
+    StimulusHidden,
+    TrialPrepared,
+    StimulusTiming,
+    TrialInvalidated,
+    Count
+};
+
+// Type tag written in front of every argument so the decoder can walk a record without the source
+enum class EStructuredLogArg : uint8
+{
+    Int32 = 0,
+    Float,
+    Double,
+    Bool,
+    Vector,
+    FloatArray
+};
+
+/**
+ * A single structured record: the format ID, a timestamp and the raw binary arguments.
+ * No text is produced while logging; the offline decoder applies the format string later.
+ */
+class PERIMAPXR_API FStructuredLogRecord
+{
+public:
+    FStructuredLogRecord(EStructuredLogFormat Format, double TimestampSeconds);
+
+    FStructuredLogRecord& operator<<(int32 Value);
+    FStructuredLogRecord& operator<<(float Value);
+    FStructuredLogRecord& operator<<(double Value);
+    FStructuredLogRecord& operator<<(bool Value);
+    FStructuredLogRecord& operator<<(const FVector& Value);
+    FStructuredLogRecord& operator<<(TArrayView<const float> Values);
+
+    // Size-prefixed record bytes ready for the file sink; empty if the payload does not fit the 64 KiB size field
+    TArray<uint8> Finish();
+
+private:
+    void WriteTag(EStructuredLogArg Tag);
+    void WriteBytes(const void* Data, int32 Size);
+
+    TArray<uint8> Bytes;
+    uint8 ArgCount;
+};
+
+/**
+ * Deferred-format structured log.
+ * Call sites pass a static format ID plus their raw arguments; records are appended to a binary .plog file
+ * through an FLogFileSink. Every file begins with a table of the format strings, so the decoder in
+ * scripts/logs/decode_structured_log.py can turn a session back into text without access to this build.
+ * The sink is opened and closed by UPeriMapXRLogSubsystem; records logged while it is closed are discarded.
+ * Log may be called from any thread: it holds SinkLock for reading, and Open and Close replace the sink under
+ * the write lock, so a record is never handed to a sink that is being destroyed.
+ */
+class PERIMAPXR_API FStructuredLog
+{
+public:
+    FStructuredLog();
+    ~FStructuredLog();
+
+    // Static function to get the singleton instance
+    static FStructuredLog& Get();
+
+    // Writes a record; arguments must be int32, float, double, bool, FVector or a float array view
+    template <typename... ArgTypes>
+    void Log(EStructuredLogFormat Format, const ArgTypes&... Args)
+    {
+        if (!bEnabled.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        FRWScopeLock Lock(SinkLock, SLT_ReadOnly);
+        if (!Sink)
+        {
+            return;
+        }
+
+        FStructuredLogRecord Record(Format, FPlatformTime::Seconds() - SessionStartTime);
+        (Record << ... << Args);
+        TArray<uint8> Bytes = Record.Finish();
+        if (Bytes.Num() > 0)
+        {
+            Sink->Enqueue(MoveTemp(Bytes));
+        }
+    }
+
+    // Opens the sink for this session; rotated files each start with their own header
+    void Open(const FString& Directory, const FLogFileSinkSettings& Settings);
+
+    // Drains and closes the sink
+    void Close();
+
+    // Enables or disables recording at runtime
+    void SetEnabled(bool bInEnabled) { bEnabled.store(bInEnabled, std::memory_order_relaxed); }
+
+    // Whether records are currently being written; lets callers skip building expensive arguments
+    bool IsEnabled() const;
+
+    // Returns the printf-style format string for a format ID
+    static const TCHAR* GetFormatString(EStructuredLogFormat Format);
+
+    // File identification written at the start of every structured log
+    static constexpr uint32 FileMagic = 0x4C584D50; // "PMXL"
+    static constexpr uint16 FileVersion = 1;
+
+private:
+    // Builds the magic, version, session start time and format table written at the start of each file
+    static TArray<uint8> BuildHeader();
+
+    // The open sink and the time its session started, both replaced under the write lock
+    TUniquePtr<FLogFileSink> Sink;
+    double SessionStartTime;
+    mutable FRWLock SinkLock;
+
+    std::atomic<bool> bEnabled;
+};
@@ -0,0 +1,37 @@
+// FTestPatternLibrary.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ETestType.h"
+
+// One point of a standard test grid, in degrees of visual field in right-eye orientation (positive horizontal is temporal)
+struct FTestPatternPoint
+{
+    float HorizontalDegrees;
+    float VerticalDegrees;
+
+    // Falls on the physiological blind spot of a normal eye
+    bool bBlindSpot;
+};
+
+/**
+ * Coordinate tables for the standard visual field grids (10-2, 24-2, 30-2 and 60-4).
+ * The tables are compile-time constants in right-eye orientation, one per ETestType; the left eye mirrors them
+ * horizontally. Stimulus positions are computed once per pattern, eye and display distance and then cached, so
+ * setting up a test or switching eyes copies an array instead of placing every point again.
+ */
+class PERIMAPXR_API FTestPatternLibrary
+{
+public:
+    // The table of a pattern, in presentation order; empty if the test type has none
+    static TArrayView<const FTestPatternPoint> GetPoints(ETestType TestType);
+
+    // Clinical name of a pattern ("24-2"), and the test type with a given name; false if there is none
+    static const TCHAR* GetName(ETestType TestType);
+    static bool FindByName(const FString& Name, ETestType& OutTestType);
+
+    // Stimulus positions relative to the fixation point, in table order, placed as ATestStimuli::PolarToCartesian
+    // does. Built on first use; the returned array lives for the rest of the process
+    static const TArray<FVector>& GetLocations(ETestType TestType, bool bLeftEye, float Radius);
+};
@@ -21,7 +21,41 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
     float ThresholdLevel;
 
+    // Frame counters and timestamps (seconds) of the first and last display frames the stimulus was drawn in
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    int64 FirstFrame;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    int64 LastFrame;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    double FirstFrameTime;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    double LastFrameTime;
+
+    // Requested on-screen time (rounded to whole frames) and the time the stimulus was actually up, in seconds
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    float RequestedDuration;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    float MeasuredDuration;
+
+    // False if the measured duration missed the requested one by more than the presentation tolerance
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    bool bDurationWithinTolerance;
+
+    // True if a saccade or blink overlapped the presentation; the response was not scored and the location was retested
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    bool bFixationLost;
+
+    // True if a saccade or blink overlapped the presentation but the trial was scored, because its location had
+    // already been retested as often as the scheduler allows
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stimulus Result")
+    bool bFixationUnreliable;
+
     // Constructor for ease of use
     FTestResults(FVector Location = FVector::ZeroVector, bool Seen = false, float Level = 0.0f)
-        : Location(Location), bSeen(Seen), ThresholdLevel(Level) {}
+        : Location(Location), bSeen(Seen), ThresholdLevel(Level), FirstFrame(0), LastFrame(0), FirstFrameTime(0.0), LastFrameTime(0.0),
+          RequestedDuration(0.0f), MeasuredDuration(0.0f), bDurationWithinTolerance(true), bFixationLost(false), bFixationUnreliable(false) {}
 };
@@ -0,0 +1,104 @@
+// FTrialScheduler.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+// Tuning for FTrialScheduler
+struct PERIMAPXR_API FTrialSchedulerSettings
+{
+    // Minimum visual angle between two consecutive presentations, in degrees
+    float MinSeparationDegrees = 12.0f;
+
+    // Probability that a trial is replaced by a catch trial (no stimulus shown)
+    float CatchTrialProbability = 0.1f;
+
+    // A location is retired after this many presentations even if its stopping rule was never met
+    int32 MaxPresentationsPerLocation = 12;
+
+    // A location is re-queued after a trial rejected for a saccade or blink at most this many times; later
+    // rejections are scored as usual, so a patient who cannot hold fixation still finishes the test
+    int32 MaxRejectionsPerLocation = 3;
+
+    // Seed for catch trials and tie-breaking; 0 seeds from the clock
+    int32 RandomSeed = 0;
+};
+
+/**
+ * Chooses which location to present next. Locations sit in a max-heap keyed by posterior uncertainty, so each
+ * trial goes to the location we currently know least about, and presentations interleave across the field
+ * until every location meets its stopping rule. Updating a location pushes a new heap entry and bumps its
+ * version; older entries are skipped when they surface, which keeps selection and updates at O(log n).
+ * Consecutive presentations are kept at least MinSeparationDegrees apart where possible.
+ */
+class PERIMAPXR_API FTrialScheduler
+{
+public:
+    FTrialScheduler();
+
+    // Starts a new schedule over these locations (relative to the fixation point); untested locations go first
+    void Reset(const TArray<FVector>& InLocations, const FTrialSchedulerSettings& InSettings);
+
+    // Returns the index of the next location to present, or INDEX_NONE once every location is finished
+    int32 PopNext();
+
+    // Reports the outcome of a presentation returned by PopNext, re-queueing the location unless it is finished
+    void ReportResult(int32 LocationIndex, float UncertaintyInDb, bool bComplete);
+
+    // Reports that a presentation returned by PopNext was rejected for a fixation loss and re-queues the location;
+    // false (and nothing changes) once the location has used up its rejections, and the trial should be scored
+    bool RejectTrial(int32 LocationIndex);
+
+    // Decides whether the next trial should be a catch trial; never two in a row or before the first presentation
+    bool ShouldRunCatchTrial();
+
+    bool IsFinished() const { return NumActive == 0; }
+    int32 GetNumPresentations() const { return NumPresentations; }
+    int32 GetPresentationCount(int32 LocationIndex) const { return PresentationCounts[LocationIndex]; }
+    int32 GetRejectionCount(int32 LocationIndex) const { return RejectionCounts[LocationIndex]; }
+
+private:
+    struct FEntry
+    {
+        float UncertaintyInDb;
+        float TieBreak;
+        int32 LocationIndex;
+        uint32 Version;
+    };
+
+    // Most uncertain first; random tie-break so equal priorities do not follow the pattern order
+    struct FEntryPredicate
+    {
+        bool operator()(const FEntry& A, const FEntry& B) const
+        {
+            return A.UncertaintyInDb != B.UncertaintyInDb ? A.UncertaintyInDb > B.UncertaintyInDb : A.TieBreak < B.TieBreak;
+        }
+    };
+
+    void Push(int32 LocationIndex, float UncertaintyInDb);
+    bool IsStale(const FEntry& Entry) const { return Entry.Version != Versions[Entry.LocationIndex]; }
+    bool IsTooCloseToLast(int32 LocationIndex) const;
+
+    FTrialSchedulerSettings Settings;
+    float MinSeparationCosine;
+    FRandomStream RandomStream;
+
+    // Per-location state, indexed like the locations passed to Reset
+    TArray<FVector> Directions;
+    TArray<uint32> Versions;
+    TArray<float> LastUncertaintiesInDb;
+    TArray<int32> PresentationCounts;
+    TArray<int32> RejectionCounts;
+    TBitArray<> ActiveFlags;
+
+    TArray<FEntry> Heap;
+    TArray<FEntry> Deferred;
+
+    // Location handed out by PopNext and not yet reported; re-queued if the trial was abandoned
+    int32 InFlightIndex;
+    int32 LastPresentedIndex;
+    int32 NumActive;
+    int32 NumPresentations;
+    bool bLastWasCatchTrial;
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+// IVisualFieldHistoryProvider.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "IVisualFieldHistoryProvider.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UVisualFieldHistoryProvider : public UInterface
+{
+    GENERATED_BODY()
+};
+
+/**
+ * Implemented by whatever owns patient records (the project's game instance) so ATestStimuli can seed the
+ * estimator from the previous visit and hand back the new results, without this module depending on it.
+ */
+class PERIMAPXR_API IVisualFieldHistoryProvider
+{
+    GENERATED_BODY()
+
+public:
+    // Results file of the current patient's most recent valid visual field, or an empty string if there is none
+    virtual FString GetPreviousVisualFieldFile() const = 0;
+
+    // Called once both eyes are finished and their results are saved
+    virtual void OnVisualFieldSaved(const FString& ResultsFile) = 0;
+};
@@ -0,0 +1,29 @@
+// UDiagnosticsOverlayTestCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UDiagnosticsOverlayTestCommandlet.generated.h"
+
+/**
+ * Checks that on-screen logging stays within a fixed allocation budget per frame, with no world or headset.
+ *
+ *   UnrealEditor-Cmd VisionScopePro.uproject -run=DiagnosticsOverlayTest -Frames=900 -MessagesPerFrame=20 -nullrhi
+ *
+ * Each simulated 90 Hz frame logs -MessagesPerFrame formatted messages through FLogManager::LogMessagef with
+ * only on-screen output enabled, then ticks the core ticker so the overlay flushes at its own rate. Game-thread
+ * allocations are counted through a forwarding allocator. After the first -WarmupFrames, the logging in any
+ * frame may allocate at most -MaxAllocationsPerFrame times (default 0); the throttled flushes are reported
+ * separately. Returns non-zero if the budget is exceeded. Results are written to the log.
+ */
+UCLASS()
+class PERIMAPXR_API UDiagnosticsOverlayTestCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UDiagnosticsOverlayTestCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
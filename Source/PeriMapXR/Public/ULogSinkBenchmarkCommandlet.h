@@ -0,0 +1,28 @@
+// ULogSinkBenchmarkCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ULogSinkBenchmarkCommandlet.generated.h"
+
+/**
+ * Compares FLogFileSink with the per-message append FLogManager used before it, with no world or headset.
+ *
+ *   UnrealEditor-Cmd VisionScopePro.uproject -run=LogSinkBenchmark -Messages=100000 -Producers=4
+ *
+ * The append path opens, writes and closes the file for every message on one thread. The sink is fed from
+ * -Producers threads at once; it reports both the rate the producers enqueue at and the rate including the
+ * final drain to disk, along with any records dropped by the backlog cap. Files go to Saved/LogSinkBenchmark
+ * and are deleted afterwards. Results are written to the log.
+ */
+UCLASS()
+class PERIMAPXR_API ULogSinkBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    ULogSinkBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,82 @@
+// UPeriMapXRLogSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Logging/LogVerbosity.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+#include "FLogFileSink.h"
+#include "FDiagnosticsOverlay.h"
+#include "UPeriMapXRLogSubsystem.generated.h"
+
+/**
+ * Process-wide log service for PeriMapXR.
+ * Owns the single text log sink and the structured log sink for the lifetime of the engine, so actors
+ * never touch the filesystem when they are constructed or spawned. Messages are tagged with a named
+ * category (see FLogManager) and filtered against a per-category verbosity that can be changed at
+ * runtime with "PeriMapXR.LogVerbosity <Category> <Verbosity>". Log files rotate once they reach
+ * MaxLogFileSizeMB, and the oldest text or structured log is deleted when the two together exceed MaxLogFolderSizeMB.
+ * On-screen output goes through a rate-limited FDiagnosticsOverlay instead of one debug line per message.
+ */
+UCLASS(Config = Game)
+class PERIMAPXR_API UPeriMapXRLogSubsystem : public UEngineSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // USubsystem interface
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // Returns the running log service, or nullptr before the engine has initialized subsystems and after shutdown
+    static UPeriMapXRLogSubsystem* Get() { return Instance; }
+
+    // Returns true if a message of this verbosity passes the category's filter
+    bool IsEnabled(FName Category, ELogVerbosity::Type Verbosity) const;
+
+    // Queues a timestamped line for the text log file
+    void WriteToFile(FName Category, ELogVerbosity::Type Verbosity, const FString& Message);
+
+    // Sets or reads the verbosity for a category; categories that were never set use DefaultVerbosity
+    void SetCategoryVerbosity(FName Category, ELogVerbosity::Type Verbosity);
+    ELogVerbosity::Type GetCategoryVerbosity(FName Category) const;
+
+    // The on-screen diagnostics overlay shared by every category
+    FDiagnosticsOverlay* GetOverlay() const { return Overlay.Get(); }
+
+    // Prints the default verbosity and every category with an explicit setting
+    void DumpCategories() const;
+
+private:
+    // Rotation limits for each log file and for everything in the log folder
+    UPROPERTY(Config)
+    int32 MaxLogFileSizeMB = 8;
+
+    UPROPERTY(Config)
+    int32 MaxLogFolderSizeMB = 64;
+
+    // Verbosity applied to categories without an explicit setting ("Log", "Warning", ...)
+    UPROPERTY(Config)
+    FString DefaultVerbosityName = TEXT("Log");
+
+    // Set from the console on the game thread and read by every thread that logs
+    std::atomic<ELogVerbosity::Type> DefaultVerbosity = ELogVerbosity::Log;
+
+    // How often the overlay refreshes the screen, and how many distinct messages it shows at once
+    UPROPERTY(Config)
+    float OverlayUpdateRateHz = 4.0f;
+
+    UPROPERTY(Config)
+    int32 OverlayMaxSlots = 32;
+
+    // Per-category verbosity, read from any thread that logs
+    mutable FRWLock CategoryLock;
+    TMap<FName, ELogVerbosity::Type> CategoryVerbosity;
+
+    TUniquePtr<FLogFileSink> TextSink;
+    TUniquePtr<FDiagnosticsOverlay> Overlay;
+
+    static UPeriMapXRLogSubsystem* Instance;
+};
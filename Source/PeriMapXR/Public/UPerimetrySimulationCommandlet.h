@@ -0,0 +1,30 @@
+// UPerimetrySimulationCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UPerimetrySimulationCommandlet.generated.h"
+
+/**
+ * Runs the perimetry pipeline against simulated patients, with no headset or rendered world.
+ *
+ *   UnrealEditor-Cmd VisionScopePro.uproject -run=PerimetrySimulation -Sessions=5000 -Strategy=Both
+ *
+ * Options: -Sessions, -Seed, -Strategy=Mean|Entropy|Both, -Pattern=10-2|24-2|30-2|60-4 (a standard grid,
+ * right eye) or else -Extent and -Spacing (a square grid, in degrees),
+ * -MinThreshold and -MaxThreshold (true threshold range, dB), -FalsePositive, -FalseNegative,
+ * -FixationLoss, -Slope and -Lapse (the observer's psychometric function), -CatchTrials, -MaxPresentations,
+ * -MaxRejections (retests of a location after a fixation loss) and -FixedPsychometrics to turn off the
+ * estimator's patient model. Results are written to the log.
+ */
+UCLASS()
+class PERIMAPXR_API UPerimetrySimulationCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPerimetrySimulationCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
\ No newline at end of file
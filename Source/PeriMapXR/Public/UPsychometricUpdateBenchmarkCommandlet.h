@@ -0,0 +1,29 @@
+// UPsychometricUpdateBenchmarkCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UPsychometricUpdateBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures posterior updates per second with and without the shared likelihood tables, with no world or headset.
+ *
+ *   UnrealEditor-Cmd VisionScopePro.uproject -run=PsychometricUpdateBenchmark -Updates=1000000 -Locations=54
+ *
+ * The same pre-drawn responses are applied three ways: evaluating the psychometric function for every threshold
+ * bin (the estimator before the tables), multiplying by a FPsychometricTable row, and FPosteriorStore::Update as
+ * the estimator runs today. Locations are visited in turn, and every location starts again from a uniform
+ * posterior after -UpdatesPerLocation responses each, as it would in a new session. Options: -Updates, -Locations, -UpdatesPerLocation and -Seed.
+ * Results are written to the log.
+ */
+UCLASS()
+class PERIMAPXR_API UPsychometricUpdateBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPsychometricUpdateBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,27 @@
+// UStimulusFieldBenchmarkCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UStimulusFieldBenchmarkCommandlet.generated.h"
+
+/**
+ * Compares the instanced stimulus field with one AStimuli actor per point, in a transient world with no headset.
+ *
+ *   UnrealEditor-Cmd VisionScopePro.uproject -run=StimulusFieldBenchmark -Pattern=24-2 -Flashes=10000 -nullrhi
+ *
+ * For each approach it reports the actors added to the world, the time to set up the pattern and the game-thread
+ * time per flash (show at an intensity, then hide). Options: -Pattern=10-2|24-2|30-2|60-4 and -Flashes.
+ * Results are written to the log.
+ */
+UCLASS()
+class PERIMAPXR_API UStimulusFieldBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UStimulusFieldBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,76 @@
+// UStimulusFieldComponent.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "FLogManager.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UStimulusFieldComponent.generated.h"
+
+/**
+ * Draws every stimulus of a test pattern as one instance of a single instanced static mesh.
+ * Hidden stimuli are instances scaled to zero, and showing one restores its scale and sets the "Brightness"
+ * parameter of the field's dynamic material (0-1, from the intensity in dB as in AStimuli); only one stimulus
+ * is up at a time, so one parameter serves the whole field. Showing or hiding a stimulus is therefore one
+ * instance update on one component, instead of a visibility change and a material parameter on a separate
+ * actor. Each instance also carries its brightness and visibility as custom data floats (slots 0 and 1) for a
+ * stimulus material that reads them with PerInstanceCustomData; M_Stimuli does not yet, so the scale and the
+ * parameter are what the headset shows.
+ */
+UCLASS(ClassGroup = (PeriMapXR), meta = (BlueprintSpawnableComponent))
+class PERIMAPXR_API UStimulusFieldComponent : public UInstancedStaticMeshComponent
+{
+    GENERATED_BODY()
+
+public:
+    UStimulusFieldComponent();
+
+    // Custom data slots read by the stimulus material
+    static constexpr int32 BrightnessDataIndex = 0;
+    static constexpr int32 VisibilityDataIndex = 1;
+
+    // Function to replace all stimuli with one hidden instance per location (relative to the component), scaled to a diameter
+    void SetStimuli(const TArray<FVector>& RelativeLocations, float DesiredDiameter);
+
+    // Function to remove all stimuli
+    void ClearStimuli();
+
+    // Function to show a stimulus at an intensity in decibels
+    void ShowStimulus(int32 StimulusIndex, float StimulusIntensityInDb);
+
+    // Function to hide a stimulus
+    void HideStimulus(int32 StimulusIndex);
+
+    // Function to hide every stimulus
+    void HideAllStimuli();
+
+    // Number of stimuli in the field
+    int32 GetNumStimuli() const { return GetInstanceCount(); }
+
+    // Function to convert an intensity in decibels to material brightness: L_max * 10^(-dB/10), normalized to L_max
+    float GetBrightnessFromDb(float dBValue) const;
+
+    // Max output of the stimulus in nits
+    UPROPERTY(EditAnywhere, Category = "Stimulus Settings")
+    float MaxLuminanceNits;  // 60 nits for Pico 4
+
+    // Max brightness for Unreal Engine material (0-1)
+    UPROPERTY(EditAnywhere, Category = "Stimulus Settings")
+    float MaxBrightness;
+
+private:
+    // Function to move an instance between its shown and hidden (zero) scale
+    void SetStimulusScale(int32 StimulusIndex, const FVector& Scale, bool bMarkRenderStateDirty);
+
+    // Pattern locations (relative to the component) and the scale of a shown stimulus
+    TArray<FVector> StimulusLocations;
+    FVector ShownScale = FVector::OneVector;
+
+    // Instance of the stimulus material whose Brightness the shown stimulus uses; created on first show
+    UPROPERTY(Transient)
+    UMaterialInstanceDynamic* DynamicMaterial = nullptr;
+
+    // Log handle for the stimulus category; constructing it does not touch the filesystem
+    FLogManager LogManager{ TEXT("Stimuli") };
+};
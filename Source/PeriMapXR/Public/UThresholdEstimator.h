@@ -7,6 +7,13 @@
 #include "FTestResults.h"
 #include "FTestSettings.h"
 #include "ETestType.h"
+#include "EStimulusSelectionStrategy.h"
+#include "FPsychometricTable.h"
+#include "FHierarchicalPosteriorStore.h"
+#include "FLocationRegistry.h"
+#include "FNeighborGraph.h"
+#include "FNormativePriorDatabase.h"
+#include "FPreviousVisitPriors.h"
 #include "UThresholdEstimator.generated.h"
 
 /**
@@ -28,26 +35,89 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
     void Initialize(const FTestSettings& TestSettings, ETestType TestType, bool bIsLeftEye);
 
+    // Registers test locations and returns their dense IDs, in the same order; call once the pattern is known
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    TArray<int32> RegisterLocations(const TArray<FVector>& Locations);
+
+    // Returns the ID of a registered location, or -1 if it was never registered
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    int32 FindLocationId(const FVector& Location) const;
+
+    // Returns the location registered under an ID
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    FVector GetLocationById(int32 LocationId) const;
+
     // Updates the estimator with a user's response at a location
     UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
     void UpdateWithResponse(const FVector& Location, float StimulusIntensity, bool bSeen);
 
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    void UpdateWithResponseById(int32 LocationId, float StimulusIntensity, bool bSeen);
+
+    // UpdateWithResponseById in two halves: ApplyResponseById changes only the current eye's state and may run
+    // off the game thread on an estimator nothing else is using; RecordAppliedResponse logs and records it.
+    // Apply returns false (and changes nothing) if the location was already finished
+    bool ApplyResponseById(int32 LocationId, float StimulusIntensity, bool bSeen, bool& bOutCompleted);
+    void RecordAppliedResponse(int32 LocationId, float StimulusIntensity, bool bSeen, bool bCompleted);
+
+    // Speculation support (see FSpeculativeTrialPlanner). StateVersion changes whenever anything a response or
+    // a selection depends on changes, so a branch computed from one version can be checked before it is used
+    uint32 GetStateVersion() const { return StateVersion; }
+
+    // Makes this estimator a copy of another for the current eye; the registry and neighbour graph are only
+    // copied when the other estimator registered locations since the last copy
+    void CopyStateFrom(const UThresholdEstimator& Other);
+
+    // Swaps in the current eye's state from a branch (a CopyStateFrom of this estimator plus one applied
+    // response) and records that response; constant time
+    void CommitBranch(UThresholdEstimator& Branch, int32 LocationId, float StimulusIntensity, bool bSeen, bool bApplied, bool bCompleted);
+
     // Gets the next stimulus intensity for a location (in decibels)
     UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
     float GetNextStimulusIntensityInDb(const FVector& Location);
 
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    float GetNextStimulusIntensityInDbById(int32 LocationId);
+
     // Gets the next luminance for a location (in nits)
     UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
     float GetNextLuminanceForLocation(const FVector& Location);
 
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    float GetNextLuminanceById(int32 LocationId);
+
     // Checks if threshold estimation is complete for a location
     UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
     bool IsThresholdEstimationComplete(const FVector& Location);
 
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    bool IsThresholdEstimationCompleteById(int32 LocationId) const;
+
     // Gets the estimated threshold for a location (in decibels)
     UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
     float GetThresholdEstimateInDb(const FVector& Location);
 
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    float GetThresholdEstimateInDbById(int32 LocationId);
+
+    // Gets the posterior standard deviation of a location's threshold on the current eye (in decibels)
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    float GetThresholdUncertaintyInDbById(int32 LocationId) const;
+
+    // Posterior means of the patient-level psychometric slope (dB) and lapse rate on the current eye
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    float GetPatientSlope() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    float GetPatientLapseRate() const;
+
+    // Number of registered locations; IDs run from zero to this minus one
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    int32 GetNumLocations() const { return LocationRegistry.Num(); }
+
+    // Gets the threshold and posterior standard deviation of a location on either eye; false if that eye has no threshold for it
+    bool GetEyeResultById(bool bLeftEye, int32 LocationId, float& OutThresholdInDb, float& OutStandardDeviationInDb) const;
+
     // Calculates final thresholds and sensitivities after the test is complete
     UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
     void CalculateFinalThresholds();
@@ -71,83 +141,137 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
     bool ShouldSkipRetest(const FVector& Location);
 
-private:
-    // Inner class for per-location threshold estimation
-    class LocationEstimator
-    {
-    public:
-        LocationEstimator(UThresholdEstimator* InParentEstimator);
-        ~LocationEstimator();
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    bool ShouldSkipRetestById(int32 LocationId);
 
-        void Initialize();
+    // Checks if threshold estimation is complete for every location tested on the current eye
+    UFUNCTION(BlueprintCallable, Category = "Threshold Estimation")
+    bool AreAllLocationsComplete() const;
 
-        void UpdateProbabilityDistribution(float StimulusIntensity, bool bSeen);
+    // How the next intensity is chosen: the posterior mean, or the intensity with the lowest expected posterior entropy
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation")
+    EStimulusSelectionStrategy SelectionStrategy;
 
-        float SelectNextStimulusIntensityInDb();
-        float SelectNextLuminance();  // Converts dB to luminance in nits
+    // When a location finishes, seed or tighten the priors of its neighbours around its threshold
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Spatial Priors")
+    bool bUseSpatialPriors;
 
-        bool IsThresholdEstimationComplete(float StoppingCriterion);
+    // Locations closer than this (in degrees of visual angle) are neighbours; takes effect at RegisterLocations
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Spatial Priors")
+    float NeighborRadiusDegrees;
 
-        float GetThresholdEstimateInDb();
+    // Maximum number of neighbours kept per location; takes effect at RegisterLocations
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Spatial Priors")
+    int32 MaxNeighborsPerLocation;
 
-        // Keeps track of consistent responses
-        int32 ConsistentResponsesCount;
+    // Standard deviation (in dB) of the prior a finished location passes to a neighbour at full weight
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Spatial Priors")
+    float SpatialPriorStandardDeviationInDb;
 
-        // Stores whether estimation is complete
-        bool bEstimationComplete;
+    // Start each location from the age-matched normative prior, when the database covers the test pattern
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Normative Priors")
+    bool bUseNormativePriors;
 
-    private:
-        // Pointer to the outer UThresholdEstimator class
-        UThresholdEstimator* ParentEstimator;
+    // Patient age used to pick the normative age band at Initialize; 0 if unknown (uniform priors)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Normative Priors")
+    int32 PatientAgeYears;
 
-        TArray<float> PossibleThresholdLevelsInDb;  // Threshold levels in decibels
-        TArray<float> ProbabilityDistribution;
+    // Start each location from the patient's previous result there, where the previous visit tested it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Previous Visit Priors")
+    bool bUsePreviousVisitPriors;
 
-        void NormalizeProbabilityDistribution();
+    // Results file of the patient's most recent valid visual field; empty for a first visit. Read at Initialize
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Previous Visit Priors")
+    FString PreviousVisitResultsFile;
 
-        float PsychometricFunction(float StimulusIntensity, float ThresholdLevel);  
+    // Expected change between visits (standard deviation in dB), added in quadrature to the previous posterior's
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Previous Visit Priors")
+    float PreviousVisitDriftInDb;
+
+    // Infer the patient's psychometric slope and lapse rate from responses pooled over all locations,
+    // instead of assuming the fixed defaults; takes effect at the next Initialize
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Patient Model")
+    bool bEstimatePatientPsychometrics;
+
+    // Candidate slopes (dB) considered for the patient; every slope is paired with every lapse rate
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Patient Model")
+    TArray<float> PatientSlopeHypotheses;
+
+    // Candidate lapse rates considered for the patient
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threshold Estimation|Patient Model")
+    TArray<float> PatientLapseRateHypotheses;
+
+private:
+    // Everything estimated for one eye. Per-location arrays are indexed by location ID; posterior rows are
+    // only created for locations actually presented to this eye, so RowByLocationId maps one to the other.
+    struct FEyeState
+    {
+        FHierarchicalPosteriorStore Posteriors;
+        TArray<int32> RowByLocationId;
 
-        // Parameters for the psychometric function
-        float Slope;
-        float GuessRate;
-        float LapseRate;
+        // Threshold for each location ID, valid where HasThreshold is set
+        TArray<float> ThresholdsInDb;
+        TBitArray<> HasThreshold;
 
-        // Stopping criterion for standard deviation
-        float StoppingCriterion;
+        // Consecutive "seen" responses per location ID, for retest skipping
+        TArray<int32> ConsistentSeenCounts;
 
-        // Helper to convert dB to luminance (nits)
-        float ConvertDbToLuminance(float dBValue);
+        // Gaussian priors from finished neighbours, waiting for the location's posterior row to be created;
+        // kept as summed precision and precision-weighted mean so several neighbours combine exactly
+        TArray<float> PriorPrecisions;
+        TArray<float> PriorWeightedMeans;
+
+        // Widened prior from the previous visit for each location ID, resolved once; a deviation of zero means none
+        TArray<float> VisitPriorMeans;
+        TArray<float> VisitPriorStandardDeviations;
+
+        // Results keyed by location for the Blueprint getters; written when a threshold is set
+        TMap<FVector, float> ThresholdMap;
+        TMap<FVector, float> SensitivityMap;
+
+        // Clears the per-location state and sizes it for NumLocations IDs
+        void Reset(int32 NumLocations);
+
+        // Grows the per-location arrays to cover NumLocations IDs
+        void Grow(int32 NumLocations);
     };
 
-    // Maps to store results for both eyes separately
-    TMap<FVector, float> LeftEyeThresholds;
-    TMap<FVector, float> RightEyeThresholds;
+    // Dense IDs for every location registered this session, shared by both eyes
+    FLocationRegistry LocationRegistry;
+
+    // Neighbours within the most recently registered pattern
+    FNeighborGraph NeighborGraph;
+
+    // Normative priors for the current pattern and age band, selected at Initialize
+    FNormativePriorSelection NormativePriors;
 
-    // Sensitivities for each location
-    TMap<FVector, float> LeftEyeSensitivities;
-    TMap<FVector, float> RightEyeSensitivities;
+    // The patient's previous visit, reloaded only when PreviousVisitResultsFile changes
+    FPreviousVisitPriors PreviousVisit;
+
+    // State for both eyes separately
+    FEyeState LeftEye;
+    FEyeState RightEye;
 
     // Store the current test settings and type
     FTestSettings CurrentTestSettings;
     ETestType CurrentTestType;
 
     // Helper functions for eye-specific data management
-    TMap<FVector, float>& GetCurrentThresholdMap();
-    TMap<FVector, float>& GetCurrentSensitivityMap();
+    FEyeState& GetCurrentEye();
+    const FEyeState& GetCurrentEye() const;
+
+    // Sets the threshold of a location for the current eye
+    void SetThreshold(int32 LocationId, float ThresholdInDb);
 
-    // Smart pointer for memory management
-    TMap<FVector, TUniquePtr<LocationEstimator>> LocationEstimators;
+    // Passes a finished location's threshold to its neighbours as a Gaussian prior
+    void PropagateToNeighbors(int32 LocationId, float ThresholdInDb);
 
-    // Final thresholds and sensitivities for each location
-    TMap<FVector, float> FinalThresholdsInDb;
-    TMap<FVector, float> FinalSensitivities;
+    // Looks up the previous-visit prior of every location from FirstLocationId on, for one eye
+    void ResolvePreviousVisitPriors(FEyeState& Eye, bool bLeftEye, int32 FirstLocationId);
 
     // Test results
     TArray<FTestResults> TestResultsArray;
 
-    // Consistency map for retest skipping
-    TMap<FVector, int32> ConsistencyMap;
-
     // Threshold estimation parameters
     float MinThresholdInDb;
     float MaxThresholdInDb;
@@ -155,10 +279,25 @@ private:
     float ThresholdStepSizeInDb;
     float StoppingCriterionInDb;
 
+    // Parameters for the psychometric function, and one likelihood table per patient-level hypothesis
+    // (just PsychometricParams when the patient model is off), shared by all locations
+    FPsychometricParams PsychometricParams;
+    TArray<TSharedRef<const FPsychometricTable>> LikelihoodTables;
+
     // Is left eye being tested
     bool bIsLeftEye;
 
+    // Bumped by every change to estimation state, and by every RegisterLocations
+    uint32 StateVersion;
+    uint32 LayoutVersion;
+
     // Helper functions
-    LocationEstimator* GetOrCreateLocationEstimator(const FVector& Location);
+    int32 GetOrCreatePosteriorRow(int32 LocationId);
+    int32 FindPosteriorRow(int32 LocationId) const;
+    float GetPriorStandardDeviation(int32 LocationId) const;
+    const TArray<TSharedRef<const FPsychometricTable>>& GetLikelihoodTables();
     void CleanupEstimators();
+
+    // Helper to convert dB to luminance (nits)
+    static float ConvertDbToLuminance(float dBValue);
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 
 #include "LightController.h"
+#include "UEyeTrackingSubsystem.h"
 
 // Sets default values
 ALightController::ALightController()
@@ -35,6 +36,7 @@ void ALightController::IncreaseLuminance(TArray<AStaticMeshActor*> lights)
 		intensity = -intensity;
 		current_intensity = { 0, intensity };
 	}
+	mark_intensity_change();
 
 	current_mat = mat;
 
@@ -94,7 +96,7 @@ void ALightController::Pause(TArray<AStaticMeshActor*> lights) {
 		}
 		*/
 		CSV_file.Empty();
-		CSV_file = { "TimeStamp,Intensity_Left,Pupil_Diameter_Left,Intensity_Right,Pupil_Diameter_Right,GazeOrigin.x,GazeOrigin.y,GazeOrigin.z,GazeDirection.x,GazeDirection.y,GazeDirection.z" };
+		CSV_file = { "TimeStamp,Intensity_Left,Pupil_Diameter_Left,Intensity_Right,Pupil_Diameter_Right,GazeOrigin.x,GazeOrigin.y,GazeOrigin.z,GazeDirection.x,GazeDirection.y,GazeDirection.z,Left_Eye_Openness,Right_Eye_Openness,Left_Eye_Blink,Right_Eye_Blink,Timestamp_Error" };
 	}
 	//GEngine->AddOnScreenDebugMessage(-1, 20.f, FColor::White, TEXT("Pause"));
 	FTimerDelegate LightTimerDelegate, DarkTimerDelegate;
@@ -189,6 +191,7 @@ void ALightController::Darkness(TArray<AStaticMeshActor*> lights)
 		return;
 	}
 	current_intensity = { 0, 0 };
+	mark_intensity_change();
 }
 
 void ALightController::Start_calibration() {
@@ -198,21 +201,13 @@ void ALightController::Start_calibration() {
 	{
 	case VRDeviceType::Pico:
 	{
-		bool eyesSupported;
-		TArray<EPXREyeTrackingMode> temparr;
-		picoxr.GetEyeTrackingSupported(eyesSupported, temparr);
-		if (!eyesSupported) {
-			//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, FString::Printf(TEXT("Eye Tracking Not Supported")));
-			return;
-		}
-
-		FPXREyeTrackingStartInfo startInfo;
-		startInfo.NeedCalibration = do_calibration;
-		startInfo.StartMode = EPXREyeTrackingMode::PXR_ETM_BOTH;
-		if (!picoxr.StartEyeTracking(startInfo)) {
+		// The shared acquisition service checks for both-eye support and starts the tracker once per session
+		UEyeTrackingSubsystem* eye_tracking = UEyeTrackingSubsystem::Get();
+		if (!eye_tracking || !eye_tracking->StartAcquisition(do_calibration)) {
 			//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, FString::Printf(TEXT("Failed to Start Eye Tracking")));
 			return;
 		}
+		EyeReader = eye_tracking->CreateReader();
 		eye_tracking_ready = true;
 		/*TArray<FString> foveation_file = {"Foveation On, Level"};
 		FString fov_lvl = "";
@@ -282,8 +277,8 @@ void ALightController::Start_calibration() {
 	if (!after_accommodation) {
 		FTimerDelegate EyeDelegate;
 		EyeDelegate.BindUFunction(this, FName("eyeTick"));
-		current_intensity = { 0 , 0 };
-		GetWorldTimerManager().SetTimer(EyeTimerHandle, EyeDelegate, .008, true, 0.0f);
+		start_eye_timeline();
+		GetWorldTimerManager().SetTimer(EyeTimerHandle, EyeDelegate, eye_tick_period, true, 0.0f);
 	}
 }
 
@@ -342,8 +337,8 @@ void ALightController::TestProtocol(TArray<AStaticMeshActor*> lights)
 	if (after_accommodation) {
 		FTimerDelegate EyeDelegate;
 		EyeDelegate.BindUFunction(this, FName("eyeTick"));
-		current_intensity = { 0 , 0 };
-		GetWorldTimerManager().SetTimer(EyeTimerHandle, EyeDelegate, .008, true, 0.0f);
+		start_eye_timeline();
+		GetWorldTimerManager().SetTimer(EyeTimerHandle, EyeDelegate, eye_tick_period, true, 0.0f);
 	}
 	if (light_duration > 0.0f) GetWorldTimerManager().SetTimer(LightTimerHandle, LightTimerDelegate, light_duration + intermediate_dark_duration, true, start_time);
 	if (intermediate_dark_duration > 0.0f) GetWorldTimerManager().SetTimer(DarkTimerHandle, DarkTimerDelegate, light_duration + intermediate_dark_duration, true, start_time + light_duration);
@@ -430,11 +425,31 @@ void ALightController::BeginPlay()
 	Super::BeginPlay();
 }
 
+void ALightController::start_eye_timeline() {
+	current_intensity = { 0, 0 };
+	eye_start_time = FPlatformTime::Seconds();
+	intensity_changes.Reset();
+	intensity_cursor = 0;
+	intensity_changes.Add({ eye_start_time, 0.0f, 0.0f });
+}
+
+void ALightController::mark_intensity_change() {
+	// Stamped on the FPlatformTime::Seconds clock that FClockSync maps the tracker onto, so markers line up with the
+	// eye samples; timer callbacks run during the frame that shows the change, and the display adds a constant latency
+	if (eye_start_time >= 0.0) {
+		intensity_changes.Add({ FPlatformTime::Seconds(), current_intensity[0], current_intensity[1] });
+	}
+}
+
 void ALightController::eyeTick() {
-	Elapsed_time += .008;
+	// Called directly rather than from the eye timer, the timeline starts now
+	if (eye_start_time < 0.0) {
+		start_eye_timeline();
+	}
 	float l = -1.0f, r = -1.0f;
 
-	FString TimeStamp = FString::SanitizeFloat(Elapsed_time), Intensity_Left = FString::SanitizeFloat(current_intensity[0]), \
+	// Devices without their own timestamps are read on this timer, so the row is stamped now, on the eye timeline
+	FString TimeStamp = FString::SanitizeFloat(FPlatformTime::Seconds() - eye_start_time), Intensity_Left = FString::SanitizeFloat(current_intensity[0]), \
 		Intensity_Right = FString::SanitizeFloat(current_intensity[1]);
 
 	FString Pupil_Diameter_Left = "", Pupil_Diameter_Right = "";
@@ -498,37 +513,39 @@ void ALightController::eyeTick() {
 			GEngine->AddOnScreenDebugMessage(-1, 0.01f, FColor::Blue, FString::Printf(TEXT("left Pupil : %f Right Pupil: %f"), left_pupil_radius, right_pupil_radius));
 			*/
 
-			bool isTracking;
-			FPXREyeTrackingState trackingState;
-			picoxr.GetEyeTrackingState(isTracking, trackingState);
-			if (!isTracking) {
-				//GEngine->AddOnScreenDebugMessage(-1, 0.01f, FColor::Red, FString::Printf(TEXT("Eye Tracking Not Working")));
-				return;
-			}
-
-			FPXREyeTrackingDataGetInfo getInfo;
-			FPXREyeTrackingData eyeData;
-			if (!picoxr.GetEyeTrackingData(1.0, getInfo, eyeData)) {
-				//GEngine->AddOnScreenDebugMessage(-1, 0.01f, FColor::Red, FString::Printf(TEXT("Failed to Get Eye Tracking Data")));
-				return;
-			}
-
-			FPXREyePupilInfo pupilInfo;
-			if (!picoxr.GetEyePupilInfo(pupilInfo)) {
-				//GEngine->AddOnScreenDebugMessage(-1, 0.01f, FColor::Red, FString::Printf(TEXT("Failed to Get Pupil Info")));
-				return;
+			// The acquisition service samples the tracker at its own rate and aligns each sample's device timestamp
+			// onto the host timeline; write one row per sample, with the time it was taken and the intensity shown then
+			eye_samples.Reset();
+			EyeReader.ReadNew(eye_samples);
+			for (const FEyeTrackingSample& sample : eye_samples) {
+				if (sample.HostTimeSeconds < eye_start_time) {
+					continue;
+				}
+				while (intensity_cursor + 1 < intensity_changes.Num() && intensity_changes[intensity_cursor + 1].time <= sample.HostTimeSeconds) {
+					intensity_cursor++;
+				}
+				const FIntensityChange& shown = intensity_changes[intensity_cursor];
+				const FEyeSampleEye& left = sample.GetEye(EEyeSampleEye::Left);
+				const FEyeSampleEye& right = sample.GetEye(EEyeSampleEye::Right);
+				const FEyeSampleEye& combined = sample.GetEye(EEyeSampleEye::Combined);
+
+				float left_pupil_radius = left.PupilDiameter + 1.0f;
+				float right_pupil_radius = right.PupilDiameter + 1.0f;
+				gaze_origin = combined.Position;
+				gaze_direction = combined.Orientation.Vector();
+
+				TimeStamp = FString::SanitizeFloat(sample.HostTimeSeconds - eye_start_time);
+				Intensity_Left = FString::SanitizeFloat(shown.left);
+				Intensity_Right = FString::SanitizeFloat(shown.right);
+				Pupil_Diameter_Left = FString::SanitizeFloat(left_pupil_radius);
+				Pupil_Diameter_Right = FString::SanitizeFloat(right_pupil_radius);
+				Gaze_Origin = FString::SanitizeFloat(gaze_origin.X) + "," + FString::SanitizeFloat(gaze_origin.Y) + "," + FString::SanitizeFloat(gaze_origin.Z);
+				Gaze_Direction = FString::SanitizeFloat(gaze_direction.X) + "," + FString::SanitizeFloat(gaze_direction.Y) + "," + FString::SanitizeFloat(gaze_direction.Z);
+				Gaze_Status = FString::SanitizeFloat(left.Openness) + "," + FString::SanitizeFloat(right.Openness) + "," + (left.bBlink ? "Yes" : "No") + "," + (right.bBlink ? "Yes" : "No");
+				CSV_file.Add(TimeStamp + "," + Intensity_Left + "," + Pupil_Diameter_Left + "," + Intensity_Right + "," + Pupil_Diameter_Right + "," + Gaze_Origin + "," + Gaze_Direction + "," + Gaze_Status + "," + FString::SanitizeFloat(sample.TimeErrorSeconds));
 			}
-			float left_pupil_radius = pupilInfo.LeftEyePupilDiameter + 1.0f;
-			float right_pupil_radius = pupilInfo.RightEyePupilDiameter + 1.0f;
-			gaze_origin = eyeData.PerEyeDatas[PxrPerEyeUsage::combined].Position;
-			gaze_direction = eyeData.PerEyeDatas[PxrPerEyeUsage::combined].Orientation.RotateVector(FVector::UpVector);
-			Pupil_Diameter_Left = FString::SanitizeFloat(left_pupil_radius);
-			Pupil_Diameter_Right = FString::SanitizeFloat(right_pupil_radius);
-			picoxr.GetEyeOpenness(left_openness, right_openness);
-			int64 temp;
-			picoxr.GetEyeBlink(temp, left_blink, right_blink);
 		}
-			break;
+			return;
 		case VRDeviceType::Vive:
 		{
 			/*ViveSR::anipal::Eye::EyeData_v2 data;
@@ -566,7 +583,7 @@ void ALightController::eyeTick() {
 		//GEngine->AddOnScreenDebugMessage(-1, 12.f, FColor::White, FString::Printf(TEXT("Output: %f"), data.verbose_data.left.pupil_diameter_mm));
 	}
 
-	CSV_file.Add(TimeStamp + "," + Intensity_Left + "," + Pupil_Diameter_Left + "," + Intensity_Right + "," + Pupil_Diameter_Right + "," + Gaze_Origin + "," + Gaze_Direction+","+Gaze_Status);
+	CSV_file.Add(TimeStamp + "," + Intensity_Left + "," + Pupil_Diameter_Left + "," + Intensity_Right + "," + Pupil_Diameter_Right + "," + Gaze_Origin + "," + Gaze_Direction+","+Gaze_Status + "," + FString::SanitizeFloat(eye_tick_period));
 	//SaveArrayText(SavingLocation, ID + "_" + tempstring + ".csv", CSV_file, true);
 }
 
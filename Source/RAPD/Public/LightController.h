@@ -10,7 +10,6 @@
 #include "Misc/FileHelper.h"
 #include "HAL/PlatformFilemanager.h"
 //#include "AndroidNativeUtils.h"
-#include "PXR_MotionTracking.h"
 #include "PXR_HMDFunctionLibrary.h"
 #include "EyeTrackerFunctionLibrary.h"
 //#include "IOpenXREyeTrackerModule.h"
@@ -19,6 +18,7 @@
 //#include "SRanipalEye_Core.h"											//HTC VIVE
 //#include "SRanipalEye_Framework.h"
 #include "TimerManager.h"
+#include "FEyeSampleRing.h"
 #include "Engine/StaticMeshActor.h"
 #include "LightController.generated.h"
 
@@ -31,6 +31,14 @@ enum class VRDeviceType :uint8
 	Other UMETA(DisplayName = "Other"),
 };
 
+// Light intensities shown from time on, in host seconds (FPlatformTime::Seconds, the timeline eye samples are aligned to)
+struct FIntensityChange
+{
+	double time;
+	float left;
+	float right;
+};
+
 UCLASS()
 class RAPD_API ALightController : public AActor
 {
@@ -121,7 +129,7 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Protocol Properties")
 	int32 current_interval_position = 0;
 
-	TArray<FString> CSV_file = {"TimeStamp,Intensity_Left,Pupil_Diameter_Left,Intensity_Right,Pupil_Diameter_Right,GazeOrigin.x,GazeOrigin.y,GazeOrigin.z,GazeDirection.x,GazeDirection.y,GazeDirection.z,Left_Eye_Openness,Right_Eye_Openness,Left_Eye_Blink,Right_Eye_Blink"};
+	TArray<FString> CSV_file = {"TimeStamp,Intensity_Left,Pupil_Diameter_Left,Intensity_Right,Pupil_Diameter_Right,GazeOrigin.x,GazeOrigin.y,GazeOrigin.z,GazeDirection.x,GazeDirection.y,GazeDirection.z,Left_Eye_Openness,Right_Eye_Openness,Left_Eye_Blink,Right_Eye_Blink,Timestamp_Error"};
 	
 
 #if PLATFORM_WINDOWS
@@ -151,7 +159,26 @@ public:
 	//SRanipalEye_Core* eye_core_vive;
 	//FFoveHMD* eye_core_fove;
 	FEyeTrackerGazeData pico;
-	PICOXRMotionTracking picoxr;
+
+	// Cursor into the shared eye-tracking service; eyeTick writes a row for every sample it published since the last tick
+	FEyeTrackingReader EyeReader;
+	TArray<FEyeTrackingSample> eye_samples;
+
+	// Host time the recording's timestamps count from, set when the eye timer starts
+	double eye_start_time = -1.0;
+
+	// Every light change since eye_start_time, so each sample is written with the intensity shown when it was taken
+	TArray<FIntensityChange> intensity_changes;
+	int32 intensity_cursor = 0;
+
+	// Interval of the eye timer; rows from devices without their own timestamps are this late at most
+	static constexpr float eye_tick_period = .008f;
+
+	// Starts a new recording timeline with both lights off
+	void start_eye_timeline();
+
+	// Stamps current_intensity with the start of the frame it is drawn in
+	void mark_intensity_change();
 	
 	UPROPERTY(EditAnywhere, Category = "Subject_ID")
 	FString ID;
@@ -160,7 +187,6 @@ public:
 	FString Session_ID;
 
 	FTimerHandle LightTimerHandle, DarkTimerHandle, EyeTimerHandle, PauseTimeHandle, DarkAdaptTimerHandle;
-	float Elapsed_time = 0.0;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DEBUGGING")
 		FString hexColor;
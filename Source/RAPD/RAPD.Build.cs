@@ -18,7 +18,8 @@ public class RAPD : ModuleRules
                 "PICOXRHMD",
                 "PICOXRInput",
                 "PICOXRMR",
-                "PICOXRMotionTracking"
+                "PICOXRMotionTracking",
+                "EyeTrackingCore"
             }
         );
         PrivateDependencyModuleNames.AddRange(
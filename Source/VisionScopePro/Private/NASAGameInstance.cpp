@@ -7,6 +7,7 @@
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonWriter.h"
 #include "Kismet/GameplayStatics.h"
+#include "FPreviousVisitPriors.h"
 
 // Loads a saved astronaut profile from a JSON file or initializes a new profile if unavailable
 // Returns true if the profile was successfully loaded, false if a new profile was created
@@ -104,6 +105,50 @@ void UNASAGameInstance::LogTestResult(FString AstronautID, const FAstronautTestR
     SaveAstronautProfile(Profile);
 }
 
+// Finds the most recent visual field in the current profile that can seed the next test
+// Records are ordered by their ISO 8601 timestamps; files that were moved or cannot be parsed are skipped
+FString UNASAGameInstance::GetMostRecentVisualFieldFile() const
+{
+    // Walk the history backwards so records with equal timestamps stay latest-logged first after the stable sort
+    TArray<const FAstronautTestRecord*> Candidates;
+    for (int32 Index = CurrentAstronautProfile.TestHistory.Num() - 1; Index >= 0; --Index)
+    {
+        const FAstronautTestRecord& Record = CurrentAstronautProfile.TestHistory[Index];
+        if (!Record.VisualFieldTestFile.IsEmpty())
+        {
+            Candidates.Add(&Record);
+        }
+    }
+    Candidates.StableSort([](const FAstronautTestRecord& A, const FAstronautTestRecord& B) { return A.Timestamp > B.Timestamp; });
+
+    for (const FAstronautTestRecord* Record : Candidates)
+    {
+        FPreviousVisitPriors Probe;
+        if (Probe.Load(Record->VisualFieldTestFile))
+        {
+            return Record->VisualFieldTestFile;
+        }
+        UE_LOG(LogTemp, Warning, TEXT("Skipping unusable visual field file: %s"), *Record->VisualFieldTestFile);
+    }
+    return FString();
+}
+
+// Appends a finished visual field to the current astronaut's history, on disk and in memory
+void UNASAGameInstance::OnVisualFieldSaved(const FString& ResultsFile)
+{
+    if (CurrentAstronautProfile.AstronautID.IsEmpty())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No astronaut profile loaded; visual field results not logged: %s"), *ResultsFile);
+        return;
+    }
+
+    FAstronautTestRecord Record;
+    Record.Timestamp = FDateTime::UtcNow().ToIso8601();
+    Record.VisualFieldTestFile = ResultsFile;
+    LogTestResult(CurrentAstronautProfile.AstronautID, Record);
+    CurrentAstronautProfile.TestHistory.Add(Record);
+}
+
 // Initializes the test sequence and resets relevant variables for gameplay
 void UNASAGameInstance::InitializeGameInstance()
 {
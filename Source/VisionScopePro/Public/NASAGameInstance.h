@@ -8,11 +8,13 @@
 #include "AstronautProfile.h"
 #include "NASAUserWidget.h"
 #include "NASATestDescriptionWidget.h"
+#include "IVisualFieldHistoryProvider.h"
 #include "NASAGameInstance.generated.h"
 
 // UNASAGameInstance: Extends UGameInstance to centralize test flow, profile management, and UI handling
+// Also provides the visual field test with the astronaut's previous results, and records the new ones
 UCLASS()
-class VISIONSCOPEPRO_API UNASAGameInstance : public UGameInstance
+class VISIONSCOPEPRO_API UNASAGameInstance : public UGameInstance, public IVisualFieldHistoryProvider
 {
     GENERATED_BODY()
 
@@ -61,6 +63,14 @@ public:
     UFUNCTION(BlueprintCallable, Category = "AstronautProfiles")
     void LogTestResult(FString AstronautID, const FAstronautTestRecord& NewTestRecord);
 
+    // Returns the newest visual field file in the current profile that still exists and can be read, or an empty string
+    UFUNCTION(BlueprintCallable, Category = "AstronautProfiles")
+    FString GetMostRecentVisualFieldFile() const;
+
+    // IVisualFieldHistoryProvider: seeds the visual field test from the current profile and logs its results to it
+    virtual FString GetPreviousVisualFieldFile() const override { return GetMostRecentVisualFieldFile(); }
+    virtual void OnVisualFieldSaved(const FString& ResultsFile) override;
+
     // Advances the test sequence to the next step and updates the desired test type
     UFUNCTION(BlueprintCallable, Category = "Gameplay")
     void LaunchNextTest();
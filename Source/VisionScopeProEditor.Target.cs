@@ -10,7 +10,7 @@ public class VisionScopeProEditorTarget : TargetRules
         Type = TargetType.Editor;
         DefaultBuildSettings = BuildSettingsVersion.V4;
 
-        ExtraModuleNames.AddRange(new string[] { "VisionScopePro", "RAPD", "PeriMapXR" });
+        ExtraModuleNames.AddRange(new string[] { "VisionScopePro", "RAPD", "PeriMapXR", "EyeTrackingCore" });
 
         // Set the include order version
         IncludeOrderVersion = EngineIncludeOrderVersion.Latest;
@@ -0,0 +1,113 @@
+import argparse
+import struct
+from pathlib import Path
+
+FILE_MAGIC = 0x4C584D50  # "PMXL"
+SUPPORTED_VERSION = 1
+
+# Argument tags, mirrors EStructuredLogArg in FStructuredLog.h
+ARG_INT32, ARG_FLOAT, ARG_DOUBLE, ARG_BOOL, ARG_VECTOR, ARG_FLOAT_ARRAY = range(6)
+
+
+def read_string(data, offset):
+    (length,) = struct.unpack_from("<H", data, offset)
+    offset += 2
+    return data[offset : offset + length].decode("utf-8"), offset + length
+
+
+def read_header(data):
+    magic, version = struct.unpack_from("<IH", data, 0)
+    if magic != FILE_MAGIC:
+        raise ValueError("Not a PeriMapXR structured log (bad magic).")
+    if version != SUPPORTED_VERSION:
+        raise ValueError(f"Unsupported structured log version {version}.")
+
+    session_start, offset = read_string(data, 6)
+    (format_count,) = struct.unpack_from("<H", data, offset)
+    offset += 2
+
+    formats = {}
+    for _ in range(format_count):
+        (format_id,) = struct.unpack_from("<H", data, offset)
+        formats[format_id], offset = read_string(data, offset + 2)
+    return session_start, formats, offset
+
+
+def read_argument(data, offset):
+    tag = data[offset]
+    offset += 1
+    if tag == ARG_INT32:
+        return struct.unpack_from("<i", data, offset)[0], offset + 4
+    if tag == ARG_FLOAT:
+        return struct.unpack_from("<f", data, offset)[0], offset + 4
+    if tag == ARG_DOUBLE:
+        return struct.unpack_from("<d", data, offset)[0], offset + 8
+    if tag == ARG_BOOL:
+        return ("True" if data[offset] else "False"), offset + 1
+    if tag == ARG_VECTOR:
+        x, y, z = struct.unpack_from("<3f", data, offset)
+        # Matches FVector::ToString()
+        return f"X={x:.3f} Y={y:.3f} Z={z:.3f}", offset + 12
+    if tag == ARG_FLOAT_ARRAY:
+        (count,) = struct.unpack_from("<H", data, offset)
+        values = struct.unpack_from(f"<{count}f", data, offset + 2)
+        return " ".join(f"{value:f}" for value in values), offset + 2 + 4 * count
+    raise ValueError(f"Unknown argument tag {tag} at byte {offset - 1}.")
+
+
+def decode(data):
+    """Yields (timestamp, text) for every record in a structured log."""
+    session_start, formats, offset = read_header(data)
+    yield 0.0, f"Structured log session started {session_start}"
+
+    while offset + 2 <= len(data):
+        (payload_size,) = struct.unpack_from("<H", data, offset)
+        record_end = offset + 2 + payload_size
+        if record_end > len(data):
+            # Truncated final record, e.g. when the session was killed mid-write
+            break
+
+        format_id, timestamp, arg_count = struct.unpack_from("<HdB", data, offset + 2)
+        cursor = offset + 13
+        args = []
+        for _ in range(arg_count):
+            value, cursor = read_argument(data, cursor)
+            args.append(value)
+
+        format_string = formats.get(format_id)
+        if format_string is None:
+            text = f"<unknown format {format_id}> {args}"
+        else:
+            text = format_string % tuple(args)
+        yield timestamp, text
+        offset = record_end
+
+
+def main():
+    """
+    How to run the script:
+        python decode_structured_log.py --log-path Saved/Logs/StructuredLog_20241001_101500_000.plog
+    """
+    parser = argparse.ArgumentParser("Decode a PeriMapXR structured (.plog) log into text.")
+    parser.add_argument("--log-path", type=Path, required=True, help="Path to the .plog file.")
+    parser.add_argument(
+        "--output-path",
+        type=Path,
+        default=None,
+        help="Path of the decoded text file. If not provided a .txt file is written next to the log.",
+    )
+    args = parser.parse_args()
+
+    if not args.log_path.exists():
+        raise ValueError(f"{args.log_path} does not exist!")
+
+    if args.output_path is None:
+        args.output_path = args.log_path.with_suffix(".txt")
+
+    with open(args.output_path, "w", encoding="utf-8") as output:
+        for timestamp, text in decode(args.log_path.read_bytes()):
+            output.write(f"[{timestamp:10.4f}] {text}\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,138 @@
+import argparse
+import csv
+import struct
+from collections import defaultdict
+from pathlib import Path
+
+FILE_MAGIC = 0x50584D50  # "PMXP"
+FILE_VERSION = 1
+
+# Pattern slots, mirrors the order of ETestType in ETestType.h
+PATTERN_SLOTS = {"10-2": 0, "24-2": 1, "30-2": 2, "60-4": 3}
+
+HEADER_FORMAT = "<IHHffIIII"  # magic, version, pattern slots, first age, band width, band count, pattern table, reserved x2
+PATTERN_FORMAT = "<IfffHHIII"  # locations, grid origin h/v, spacing, grid width/height, cell table, records, reserved
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+PATTERN_SIZE = struct.calcsize(PATTERN_FORMAT)
+
+
+def align(value, alignment=4):
+    return (value + alignment - 1) // alignment * alignment
+
+
+def grid_spacing(values):
+    """Smallest step between distinct coordinates of a pattern."""
+    unique = sorted(set(values))
+    steps = [b - a for a, b in zip(unique, unique[1:]) if b - a > 1e-4]
+    return min(steps) if steps else 1.0
+
+
+def read_csv(csv_path):
+    """Returns {pattern: {(h, v): {age_band_start: (mean, sd)}}}."""
+    patterns = defaultdict(lambda: defaultdict(dict))
+    with open(csv_path, newline="", encoding="utf-8") as csv_file:
+        for row in csv.DictReader(csv_file):
+            pattern = row["pattern"].strip()
+            if pattern not in PATTERN_SLOTS:
+                raise ValueError(f"Unknown pattern '{pattern}', expected one of {sorted(PATTERN_SLOTS)}.")
+            location = (float(row["horizontal_deg"]), float(row["vertical_deg"]))
+            patterns[pattern][location][int(row["age_band_start"])] = (float(row["mean_db"]), float(row["sd_db"]))
+    return patterns
+
+
+def age_bands(patterns):
+    starts = sorted({age for locations in patterns.values() for bands in locations.values() for age in bands})
+    if not starts:
+        raise ValueError("The CSV contains no rows.")
+    widths = {b - a for a, b in zip(starts, starts[1:])}
+    if len(widths) > 1:
+        raise ValueError(f"Age bands must be evenly spaced, got starts {starts}.")
+    return starts, (widths.pop() if widths else 1)
+
+
+def build(patterns):
+    band_starts, band_width = age_bands(patterns)
+    record_size = 8 + 8 * len(band_starts)
+
+    body = bytearray()
+    entries = [bytes(PATTERN_SIZE)] * len(PATTERN_SLOTS)
+    body_offset = HEADER_SIZE + PATTERN_SIZE * len(PATTERN_SLOTS)
+
+    for pattern, locations in sorted(patterns.items(), key=lambda item: PATTERN_SLOTS[item[0]]):
+        ordered = sorted(locations, key=lambda hv: (-hv[1], hv[0]))
+        spacing = min(grid_spacing([h for h, _ in ordered]), grid_spacing([v for _, v in ordered]))
+        origin_h = min(h for h, _ in ordered)
+        origin_v = min(v for _, v in ordered)
+        width = round((max(h for h, _ in ordered) - origin_h) / spacing) + 1
+        height = round((max(v for _, v in ordered) - origin_v) / spacing) + 1
+
+        # Cell table: record index for every grid cell, -1 where the pattern has no point
+        cells = [-1] * (width * height)
+        for index, (h, v) in enumerate(ordered):
+            cell = round((v - origin_v) / spacing) * width + round((h - origin_h) / spacing)
+            if cells[cell] != -1:
+                raise ValueError(f"{pattern}: two locations fall in the same grid cell near ({h}, {v}).")
+            cells[cell] = index
+
+        cell_offset = body_offset + len(body)
+        body += struct.pack(f"<{len(cells)}h", *cells)
+        body += bytes(align(len(body)) - len(body))
+
+        records_offset = body_offset + len(body)
+        for h, v in ordered:
+            bands = locations[(h, v)]
+            missing = [age for age in band_starts if age not in bands]
+            if missing:
+                raise ValueError(f"{pattern}: location ({h}, {v}) has no row for age bands {missing}.")
+            body += struct.pack("<ff", h, v)
+            for age in band_starts:
+                body += struct.pack("<ff", *bands[age])
+        assert (len(body) + body_offset - records_offset) == record_size * len(ordered)
+
+        entries[PATTERN_SLOTS[pattern]] = struct.pack(
+            PATTERN_FORMAT, len(ordered), origin_h, origin_v, spacing, width, height, cell_offset, records_offset, 0
+        )
+
+    header = struct.pack(
+        HEADER_FORMAT,
+        FILE_MAGIC,
+        FILE_VERSION,
+        len(PATTERN_SLOTS),
+        float(band_starts[0]),
+        float(band_width),
+        len(band_starts),
+        HEADER_SIZE,
+        0,
+        0,
+    )
+    return header + b"".join(entries) + bytes(body)
+
+
+def main():
+    """
+    How to run the script:
+        python build_normative_priors.py --csv-path ../../Data/PeriMapXR/NormativePriors.csv
+    """
+    parser = argparse.ArgumentParser("Convert a normative prior CSV into the binary database PeriMapXR memory-maps.")
+    parser.add_argument("--csv-path", type=Path, required=True, help="Path to the normative prior CSV.")
+    parser.add_argument(
+        "--output-path",
+        type=Path,
+        default=None,
+        help="Path of the binary database. If not provided a .bin file is written next to the CSV.",
+    )
+    args = parser.parse_args()
+
+    if not args.csv_path.exists():
+        raise ValueError(f"{args.csv_path} does not exist!")
+
+    if args.output_path is None:
+        args.output_path = args.csv_path.with_suffix(".bin")
+
+    patterns = read_csv(args.csv_path)
+    args.output_path.write_bytes(build(patterns))
+    print(f"Wrote {sum(len(locations) for locations in patterns.values())} locations to {args.output_path}")
+
+
+if __name__ == "__main__":
+    main()